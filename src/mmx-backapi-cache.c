@@ -0,0 +1,508 @@
+/* mmx-backapi-cache.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Entry point cache of GET responses.
+ */
+
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-cache.h"
+
+#define CACHE_MAX_OBJS      256     /* power of 2 */
+#define CACHE_KEY_SEP       '\x1f'
+#define CACHE_KEY_MAX_LEN   ((2 * MMXBA_MAX_NUMBER_OF_KEY_PARAMS + 2) * MMXBA_MAX_STR_LEN)
+
+typedef struct cache_entry_s {
+    uint32_t  hash;
+    int       next;         /* hash chain or free list */
+    int       lru_prev;
+    int       lru_next;
+    int       obj;
+    uint32_t  gen;
+    uint64_t  expire_ms;
+    uint16_t  key_len;
+    uint16_t  val_len;
+    char      data[0];      /* key, '\0', value, '\0' */
+} cache_entry_t;
+
+#define ENTRY(cache, idx) \
+    ((cache_entry_t *)((cache)->slab + (size_t)(idx) * (cache)->entry_size))
+
+static mmxba_cache_t *attached_cache = NULL;
+
+
+/* ------------------------------------------------------------------- */
+/*  -----------  MMX cache internal functions         -----------------*/
+/* ------------------------------------------------------------------- */
+
+/* Returns index of the object, adds it if create is TRUE; -1 if the
+   object is not found or the objects table is full */
+static int obj_find(mmxba_cache_t *cache, const char *beObjName, int create)
+{
+    unsigned int i, idx = mmx_backapi_strhash(beObjName, 0) & cache->objs_mask;
+    mmxba_cache_obj_t *o;
+
+    for (i = 0; i <= cache->objs_mask; i++, idx = (idx + 1) & cache->objs_mask)
+    {
+        o = &cache->objs[idx];
+        if (o->beObjName[0] == '\0')
+        {
+            if (!create)
+                return -1;
+            strcpy_safe(o->beObjName, beObjName, sizeof(o->beObjName));
+            o->ttl_ms = cache->default_ttl_ms;
+            o->gen = 0;
+            return idx;
+        }
+        if (!strcmp(o->beObjName, beObjName))
+            return idx;
+    }
+
+    return -1;
+}
+
+/* Writes key prefix of the object instance: beObjName and beKeyParams */
+static int key_prefix(const mmxba_request_t *req, char *key)
+{
+    int len, i;
+
+    len = snprintf(key, CACHE_KEY_MAX_LEN, "%s%c", req->beObjName, CACHE_KEY_SEP);
+    for (i = 0; i < req->beKeyParamsNum && len < CACHE_KEY_MAX_LEN; i++)
+        len += snprintf(key + len, CACHE_KEY_MAX_LEN - len, "%s=%s%c",
+                        req->beKeyParams[i].name,
+                        req->beKeyParams[i].pValue ? req->beKeyParams[i].pValue : "",
+                        CACHE_KEY_SEP);
+
+    return (len < CACHE_KEY_MAX_LEN) ? len : -1;
+}
+
+static void lru_unlink(mmxba_cache_t *cache, int idx)
+{
+    cache_entry_t *e = ENTRY(cache, idx);
+
+    if (e->lru_prev >= 0)
+        ENTRY(cache, e->lru_prev)->lru_next = e->lru_next;
+    else
+        cache->lru_first = e->lru_next;
+
+    if (e->lru_next >= 0)
+        ENTRY(cache, e->lru_next)->lru_prev = e->lru_prev;
+    else
+        cache->lru_last = e->lru_prev;
+}
+
+static void lru_push_first(mmxba_cache_t *cache, int idx)
+{
+    cache_entry_t *e = ENTRY(cache, idx);
+
+    e->lru_prev = -1;
+    e->lru_next = cache->lru_first;
+    if (cache->lru_first >= 0)
+        ENTRY(cache, cache->lru_first)->lru_prev = idx;
+    else
+        cache->lru_last = idx;
+    cache->lru_first = idx;
+}
+
+static int entry_find(mmxba_cache_t *cache, const char *key, size_t key_len, uint32_t hash)
+{
+    int idx;
+    cache_entry_t *e;
+
+    for (idx = cache->buckets[hash & cache->buckets_mask]; idx >= 0; idx = e->next)
+    {
+        e = ENTRY(cache, idx);
+        if (e->hash == hash && e->key_len == key_len && !memcmp(e->data, key, key_len))
+            return idx;
+    }
+
+    return -1;
+}
+
+static void entry_remove(mmxba_cache_t *cache, int idx)
+{
+    cache_entry_t *e = ENTRY(cache, idx);
+    int *link = &cache->buckets[e->hash & cache->buckets_mask];
+
+    while (*link != idx)
+        link = &ENTRY(cache, *link)->next;
+    *link = e->next;
+
+    lru_unlink(cache, idx);
+
+    e->next = cache->free_list;
+    cache->free_list = idx;
+}
+
+static int entry_alloc(mmxba_cache_t *cache)
+{
+    int idx;
+
+    if (cache->free_list < 0)
+    {
+        if (cache->lru_last < 0)
+            return -1;
+        entry_remove(cache, cache->lru_last);
+        cache->evictions++;
+    }
+
+    idx = cache->free_list;
+    cache->free_list = ENTRY(cache, idx)->next;
+
+    return idx;
+}
+
+static int entry_valid(mmxba_cache_t *cache, cache_entry_t *e, uint64_t now_ms)
+{
+    return e->gen == cache->objs[e->obj].gen && e->expire_ms > now_ms;
+}
+
+
+/* ------------------------------------------------------------------- */
+/*  ----------------  MMX cache API functions         -----------------*/
+/* ------------------------------------------------------------------- */
+int mmx_backapi_cache_init(mmxba_cache_t *cache, unsigned int entries_num,
+                           size_t value_size, uint32_t default_ttl_ms)
+{
+    int status = MMXBA_OK;
+    unsigned int i, nb = 1;
+
+    if (cache == NULL || entries_num == 0 || entries_num > (1U << 20) ||
+        value_size == 0 || value_size > UINT16_MAX)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    memset(cache, 0, sizeof(*cache));
+    while (nb < entries_num)
+        nb <<= 1;
+
+    cache->entry_size = (sizeof(cache_entry_t) + value_size + 2 + 7) & ~(size_t)7;
+    cache->entries_num = entries_num;
+    cache->buckets_mask = nb - 1;
+    cache->objs_mask = CACHE_MAX_OBJS - 1;
+    cache->default_ttl_ms = default_ttl_ms;
+
+    cache->slab = malloc(cache->entry_size * entries_num);
+    cache->buckets = malloc(nb * sizeof(int));
+    cache->objs = calloc(CACHE_MAX_OBJS, sizeof(mmxba_cache_obj_t));
+    if (!cache->slab || !cache->buckets || !cache->objs)
+    {
+        free(cache->slab);
+        free(cache->buckets);
+        free(cache->objs);
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "%s: Could not allocate cache", __func__);
+    }
+
+    for (i = 0; i < nb; i++)
+        cache->buckets[i] = -1;
+
+    for (i = 0; i < entries_num; i++)
+        ENTRY(cache, i)->next = (i + 1 < entries_num) ? (int)(i + 1) : -1;
+    cache->free_list = 0;
+    cache->lru_first = cache->lru_last = -1;
+
+    pthread_mutex_init(&cache->lock, NULL);
+
+ret:
+    return status;
+}
+
+int mmx_backapi_cache_destroy(mmxba_cache_t *cache)
+{
+    if (cache == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    if (__atomic_load_n(&attached_cache, __ATOMIC_ACQUIRE) == cache)
+        mmx_backapi_cache_attach(NULL);
+
+    pthread_mutex_destroy(&cache->lock);
+    free(cache->slab);
+    free(cache->buckets);
+    free(cache->objs);
+    memset(cache, 0, sizeof(*cache));
+
+    return MMXBA_OK;
+}
+
+int mmx_backapi_cache_set_ttl(mmxba_cache_t *cache, const char *beObjName,
+                              uint32_t ttl_ms)
+{
+    int status = MMXBA_OK;
+    int obj;
+
+    if (cache == NULL || beObjName == NULL || beObjName[0] == '\0')
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    pthread_mutex_lock(&cache->lock);
+    if ((obj = obj_find(cache, beObjName, TRUE)) >= 0)
+    {
+        cache->objs[obj].ttl_ms = ttl_ms;
+        cache->objs[obj].gen++;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    if (obj < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Too many objects in the cache");
+
+ret:
+    return status;
+}
+
+void mmx_backapi_cache_attach(mmxba_cache_t *cache)
+{
+    __atomic_store_n(&attached_cache, cache, __ATOMIC_RELEASE);
+}
+
+int mmx_backapi_cache_lookup(mmxba_cache_t *cache, const mmxba_request_t *req,
+                             mmxba_request_t *resp)
+{
+    int status = MMXBA_OK;
+    char key[CACHE_KEY_MAX_LEN];
+    int hits[MMXBA_MAX_NUMBER_OF_GET_PARAMS];
+    int obj, prefix_len, len, i, idx;
+    uint64_t now_ms = mmx_backapi_time_ms();
+    cache_entry_t *e;
+
+    if (cache == NULL || req == NULL || resp == NULL || req->op_type != MMXBA_OP_TYPE_GET ||
+        req->paramNames.arraySize == 0 ||
+        req->paramNames.arraySize > MMXBA_MAX_NUMBER_OF_GET_PARAMS)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    if ((prefix_len = key_prefix(req, key)) < 0)
+        return MMXBA_GENERAL_ERROR;
+
+    pthread_mutex_lock(&cache->lock);
+
+    if ((obj = obj_find(cache, req->beObjName, FALSE)) < 0 || cache->objs[obj].ttl_ms == 0)
+    {
+        status = MMXBA_GENERAL_ERROR;
+        goto miss;
+    }
+
+    for (i = 0; i < req->paramNames.arraySize; i++)
+    {
+        strcpy_safe(key + prefix_len, req->paramNames.paramNames[i], sizeof(key) - prefix_len);
+        len = prefix_len + strlen(key + prefix_len);
+        idx = entry_find(cache, key, len, mmx_backapi_strhash(key, 0));
+        if (idx < 0 || !entry_valid(cache, ENTRY(cache, idx), now_ms))
+        {
+            status = MMXBA_GENERAL_ERROR;
+            goto miss;
+        }
+        hits[i] = idx;
+    }
+
+    /* All values are cached: build the response */
+    resp->op_type = MMXBA_OP_TYPE_GET;
+    resp->opSeqNum = req->opSeqNum;
+    resp->opResCode = resp->opExtErrCode = resp->postOpStatus = 0;
+    resp->errMsg[0] = '\0';
+    strcpy_safe(resp->beObjName, req->beObjName, sizeof(resp->beObjName));
+    strcpy_safe(resp->mmxInstances, req->mmxInstances, sizeof(resp->mmxInstances));
+
+    resp->beKeyParamsNum = req->beKeyParamsNum;
+    for (i = 0; i < req->beKeyParamsNum && status == MMXBA_OK; i++)
+        status = mmx_backapi_msgstruct_insert_nvpair(resp, &resp->beKeyParams[i],
+                                     (char *)req->beKeyParams[i].name,
+                                     req->beKeyParams[i].pValue);
+
+    resp->paramValues.arraySize = req->paramNames.arraySize;
+    for (i = 0; i < req->paramNames.arraySize && status == MMXBA_OK; i++)
+    {
+        e = ENTRY(cache, hits[i]);
+        status = mmx_backapi_msgstruct_insert_nvpair(resp, &resp->paramValues.paramValues[i],
+                                     (char *)req->paramNames.paramNames[i],
+                                     e->data + e->key_len + 1);
+        lru_unlink(cache, hits[i]);
+        lru_push_first(cache, hits[i]);
+    }
+    memcpy(resp->beKeyIds, req->beKeyIds, sizeof(resp->beKeyIds));
+    memcpy(resp->nameIds, req->nameIds, sizeof(resp->nameIds));
+
+miss:
+    if (status == MMXBA_OK)
+        cache->hits++;
+    else
+        cache->misses++;
+    pthread_mutex_unlock(&cache->lock);
+
+    return status;
+}
+
+int mmx_backapi_cache_store(mmxba_cache_t *cache, const mmxba_request_t *resp)
+{
+    char key[CACHE_KEY_MAX_LEN];
+    int obj, prefix_len, key_len, val_len, i, idx;
+    uint32_t hash;
+    uint64_t now_ms = mmx_backapi_time_ms();
+    size_t data_size;
+    const nvpair_t *nv;
+    cache_entry_t *e;
+
+    if (cache == NULL || resp == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    data_size = cache->entry_size - sizeof(cache_entry_t);
+
+    if ((resp->op_type != MMXBA_OP_TYPE_GET && resp->op_type != MMXBA_OP_TYPE_NOTIFY) ||
+        resp->opResCode != 0 ||
+        resp->paramValues.arraySize > MMXBA_MAX_NUMBER_OF_SET_PARAMS)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    if ((prefix_len = key_prefix(resp, key)) < 0)
+        return MMXBA_GENERAL_ERROR;
+
+    pthread_mutex_lock(&cache->lock);
+
+    if ((obj = obj_find(cache, resp->beObjName, TRUE)) < 0 || cache->objs[obj].ttl_ms == 0)
+        goto ret;
+
+    for (i = 0; i < resp->paramValues.arraySize; i++)
+    {
+        nv = &resp->paramValues.paramValues[i];
+        strcpy_safe(key + prefix_len, nv->name, sizeof(key) - prefix_len);
+        key_len = prefix_len + strlen(key + prefix_len);
+        val_len = nv->pValue ? strlen(nv->pValue) : 0;
+        if (key_len + val_len + 2 > data_size)
+            continue;
+
+        hash = mmx_backapi_strhash(key, 0);
+        if ((idx = entry_find(cache, key, key_len, hash)) >= 0)
+            entry_remove(cache, idx);
+
+        /* Transfer handles are valid for one response only and binary
+           blobs are large; both would lose their type in the cache */
+        if (resp->valTypes[i] == MMXBA_VAL_TYPE_XFER ||
+            resp->valTypes[i] == MMXBA_VAL_TYPE_BASE64)
+            continue;
+
+        if ((idx = entry_alloc(cache)) < 0)
+            break;
+
+        e = ENTRY(cache, idx);
+        e->hash = hash;
+        e->obj = obj;
+        e->gen = cache->objs[obj].gen;
+        e->expire_ms = now_ms + cache->objs[obj].ttl_ms;
+        e->key_len = key_len;
+        e->val_len = val_len;
+        memcpy(e->data, key, key_len + 1);
+        memcpy(e->data + key_len + 1, nv->pValue ? nv->pValue : "", val_len + 1);
+
+        e->next = cache->buckets[hash & cache->buckets_mask];
+        cache->buckets[hash & cache->buckets_mask] = idx;
+        lru_push_first(cache, idx);
+    }
+
+ret:
+    pthread_mutex_unlock(&cache->lock);
+    return MMXBA_OK;
+}
+
+int mmx_backapi_cache_invalidate(mmxba_cache_t *cache, const char *beObjName)
+{
+    int obj;
+
+    if (cache == NULL || beObjName == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    pthread_mutex_lock(&cache->lock);
+    if ((obj = obj_find(cache, beObjName, FALSE)) >= 0)
+        cache->objs[obj].gen++;
+    pthread_mutex_unlock(&cache->lock);
+
+    return MMXBA_OK;
+}
+
+void mmx_backapi_cache_observe(const mmxba_request_t *req, int isRequest)
+{
+    mmxba_cache_t *cache = __atomic_load_n(&attached_cache, __ATOMIC_ACQUIRE);
+
+    if (cache == NULL)
+        return;
+
+    switch (req->op_type)
+    {
+    case MMXBA_OP_TYPE_SET:
+    case MMXBA_OP_TYPE_ADDOBJ:
+    case MMXBA_OP_TYPE_DELOBJ:
+        mmx_backapi_cache_invalidate(cache, req->beObjName);
+        break;
+
+    case MMXBA_OP_TYPE_GET:
+        if (!isRequest)
+            mmx_backapi_cache_store(cache, req);
+        break;
+
+    case MMXBA_OP_TYPE_NOTIFY:
+        mmx_backapi_cache_store(cache, req);
+        break;
+
+    default:
+        break;
+    }
+}
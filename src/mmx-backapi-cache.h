@@ -0,0 +1,173 @@
+/* mmx-backapi-cache.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+/*
+ * Entry point cache of GET responses.
+ *
+ * Values of parameters received in GET responses are cached by the key
+ * (beObjName, beKeyParams, parameter name) for the TTL of the object.
+ * The cache attached by mmx_backapi_cache_attach() is filled and
+ * invalidated automatically by the message builders and parsers:
+ *   - parsed successful GET responses and NOTIFY messages are stored
+ *     to the cache,
+ *   - SET, ADDOBJ and DELOBJ requests and responses of an object
+ *     invalidate all cached values of the object.
+ * Invalidation only increments the object generation, the stale values
+ * are dropped lazily.
+ *
+ * The values are kept in a slab of fixed size slots allocated once, so
+ * the cache memory is bounded; the least recently used values are
+ * evicted when there are no free slots. Values that do not fit the slot
+ * are not cached, nor are base64 values and out-of-band transfer handles.
+ */
+
+#ifndef MMX_BACKAPI_CACHE_H_
+#define MMX_BACKAPI_CACHE_H_
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "mmx-backapi.h"
+
+/* Object of the cache: TTL and generation of its values */
+typedef struct mmxba_cache_obj_s {
+    char      beObjName[MMXBA_MAX_STR_LEN];
+    uint32_t  ttl_ms;
+    uint32_t  gen;
+} mmxba_cache_obj_t;
+
+typedef struct mmxba_cache_s {
+    pthread_mutex_t    lock;
+
+    /* slab of entries; every entry keeps its key and value */
+    char               *slab;
+    size_t             entry_size;
+    unsigned int       entries_num;
+    int                free_list;
+
+    int                *buckets;       /* hash chains of entries */
+    unsigned int       buckets_mask;
+
+    int                lru_first;      /* most recently used */
+    int                lru_last;       /* eviction candidate  */
+
+    mmxba_cache_obj_t  *objs;          /* open addressing table */
+    unsigned int       objs_mask;
+    uint32_t           default_ttl_ms;
+
+    /* statistics */
+    unsigned long      hits;
+    unsigned long      misses;
+    unsigned long      evictions;
+} mmxba_cache_t;
+
+
+/*
+ * Initializes cache of entries_num values of up to value_size bytes
+ * (key included). default_ttl_ms is used for objects without their TTL.
+ */
+int mmx_backapi_cache_init(mmxba_cache_t *cache, unsigned int entries_num,
+                           size_t value_size, uint32_t default_ttl_ms);
+
+int mmx_backapi_cache_destroy(mmxba_cache_t *cache);
+
+/*
+ * Sets TTL of the object values (0 - values of the object are not cached)
+ */
+int mmx_backapi_cache_set_ttl(mmxba_cache_t *cache, const char *beObjName,
+                              uint32_t ttl_ms);
+
+/*
+ * Attaches the cache to the message builders and parsers (NULL detaches)
+ */
+void mmx_backapi_cache_attach(mmxba_cache_t *cache);
+
+/*
+ * Answers GET request from the cache: if values of all requested
+ * parameters are cached, resp is filled as parsed GET response (its memory
+ * pool must be initialized) and MMXBA_OK is returned.
+ */
+int mmx_backapi_cache_lookup(mmxba_cache_t *cache, const mmxba_request_t *req,
+                             mmxba_request_t *resp);
+
+/*
+ * Stores parameter values of successful GET response or NOTIFY message
+ */
+int mmx_backapi_cache_store(mmxba_cache_t *cache, const mmxba_request_t *resp);
+
+/*
+ * Drops all cached values of the object
+ */
+int mmx_backapi_cache_invalidate(mmxba_cache_t *cache, const char *beObjName);
+
+/*
+ * Updates the attached cache by the message passed through the builders
+ * or parsers (called by the library)
+ */
+void mmx_backapi_cache_observe(const mmxba_request_t *req, int isRequest);
+
+#endif /* MMX_BACKAPI_CACHE_H_ */
@@ -0,0 +1,365 @@
+/* mmx-backapi-coalesce.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Single-flight coalescing of identical EP requests.
+ */
+
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-coalesce.h"
+
+#define KEY_SEP     '\x1f'
+
+
+/* ------------------------------------------------------------------- */
+/*  -----------  MMX coalescing internal functions    -----------------*/
+/* ------------------------------------------------------------------- */
+
+/* Returns allocated key of GET and GETALL requests: the requests are
+   identical if their keys are equal */
+static char *request_key(const mmxba_request_t *req)
+{
+    size_t size = MMXBA_MAX_STR_LEN + sizeof(req->mmxInstances) + 24, len;
+    uint32_t i, names_num;
+    const char *s;
+    char *key;
+
+    names_num = (req->op_type == MMXBA_OP_TYPE_GET) ?
+                 req->paramNames.arraySize : req->getAll.beKeyNamesNum;
+    if (req->beKeyParamsNum > MMXBA_MAX_NUMBER_OF_KEY_PARAMS ||
+        (req->op_type == MMXBA_OP_TYPE_GET && names_num > MMXBA_MAX_NUMBER_OF_GET_PARAMS) ||
+        (req->op_type == MMXBA_OP_TYPE_GETALL && names_num > MMXBA_MAX_NUMBER_OF_KEY_PARAMS))
+        return NULL;
+
+    for (i = 0; i < req->beKeyParamsNum; i++)
+        size += strlen(req->beKeyParams[i].name) + 2 +
+                (req->beKeyParams[i].pValue ? strlen(req->beKeyParams[i].pValue) : 0);
+    size += names_num * MMXBA_MAX_STR_LEN;
+
+    if ((key = malloc(size)) == NULL)
+        return NULL;
+
+    /* The responses echo mmxInstances, so it is the part of the key */
+    len = snprintf(key, size, "%d%c%s%c%s", req->op_type, KEY_SEP, req->beObjName,
+                   KEY_SEP, req->mmxInstances);
+    for (i = 0; i < req->beKeyParamsNum; i++)
+        len += snprintf(key + len, size - len, "%c%s=%s", KEY_SEP, req->beKeyParams[i].name,
+                        req->beKeyParams[i].pValue ? req->beKeyParams[i].pValue : "");
+    for (i = 0; i < names_num; i++)
+    {
+        s = (req->op_type == MMXBA_OP_TYPE_GET) ?
+             req->paramNames.paramNames[i] : req->getAll.beKeyNames[i];
+        len += snprintf(key + len, size - len, "%c%s", KEY_SEP, s);
+    }
+
+    /* GETALL responses depend on the generation seen by the caller */
+    if (req->op_type == MMXBA_OP_TYPE_GETALL)
+        snprintf(key + len, size - len, "%c%u", KEY_SEP, req->getAll.generation);
+
+    return key;
+}
+
+/* Checks that the key is of the request to the backend object */
+static int key_has_object(const char *key, const char *beObjName)
+{
+    size_t len = strlen(beObjName);
+
+    if ((key = strchr(key, KEY_SEP)) == NULL)
+        return FALSE;
+    key++;
+
+    return !strncmp(key, beObjName, len) && key[len] == KEY_SEP;
+}
+
+/* Removes the flight from the hash chains: new identical requests start
+   a new flight, the waiters of this one still get its response */
+static void flight_unlink(mmxba_coalesce_t *co, int idx)
+{
+    mmxba_flight_t *f = &co->flights[idx];
+    int *link = &co->buckets[f->hash & co->mask];
+
+    if (!f->linked)
+        return;
+
+    while (*link != idx)
+        link = &co->flights[*link].next;
+    *link = f->next;
+    f->linked = FALSE;
+}
+
+/* Detaches the open flights of reads of the object written by a request:
+   the reads submitted after the write must not get the older response */
+static void flights_detach_object(mmxba_coalesce_t *co, const char *beObjName)
+{
+    unsigned int i;
+
+    for (i = 0; i <= co->mask; i++)
+    {
+        if (co->flights[i].linked && key_has_object(co->flights[i].key, beObjName))
+        {
+            flight_unlink(co, i);
+            co->detached++;
+        }
+    }
+}
+
+static void flight_free(mmxba_flight_t *f)
+{
+    mmxba_waiter_t *w, *next;
+
+    for (w = f->waiters; w; w = next)
+    {
+        next = w->next;
+        free(w);
+    }
+
+    free(f->key);
+    f->key = NULL;
+    f->waiters = f->last = NULL;
+    f->waiters_num = 0;
+    f->in_use = FALSE;
+    f->linked = FALSE;
+}
+
+static int flight_add_waiter(mmxba_flight_t *f, mmxba_pending_cb_t cb, void *ctx)
+{
+    mmxba_waiter_t *w = malloc(sizeof(mmxba_waiter_t));
+
+    if (w == NULL)
+        return MMXBA_NOT_ENOUGH_MEMORY;
+
+    w->cb = cb;
+    w->ctx = ctx;
+    w->next = NULL;
+    if (f->last)
+        f->last->next = w;
+    else
+        f->waiters = w;
+    f->last = w;
+    f->waiters_num++;
+
+    return MMXBA_OK;
+}
+
+/* Pending table callback of the flight leader */
+static void flight_complete(void *ctx, int opSeqNum, mmxba_request_t *resp, int status)
+{
+    mmxba_flight_t *f = (mmxba_flight_t *)ctx;
+    mmxba_coalesce_t *co = f->co;
+    mmxba_waiter_t *w, *waiters = f->waiters;
+
+    /* New identical requests submitted by the callbacks start a new flight */
+    flight_unlink(co, f - co->flights);
+    f->waiters = f->last = NULL;
+
+    for (w = waiters; w; w = w->next)
+        w->cb(w->ctx, opSeqNum, resp, status);
+
+    f->waiters = waiters;
+    flight_free(f);
+}
+
+
+/* ------------------------------------------------------------------- */
+/*  ----------------  MMX coalescing API functions    -----------------*/
+/* ------------------------------------------------------------------- */
+int mmx_backapi_coalesce_init(mmxba_coalesce_t *co, mmxba_pending_t *pending)
+{
+    int status = MMXBA_OK;
+    unsigned int i;
+
+    if (co == NULL || pending == NULL || pending->size == 0)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    memset(co, 0, sizeof(*co));
+    co->pending = pending;
+    co->mask = pending->size - 1;
+    co->flights = calloc(pending->size, sizeof(mmxba_flight_t));
+    co->buckets = malloc(pending->size * sizeof(int));
+    if (!co->flights || !co->buckets)
+    {
+        free(co->flights);
+        free(co->buckets);
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "%s: Could not allocate flights", __func__);
+    }
+
+    for (i = 0; i < pending->size; i++)
+    {
+        co->buckets[i] = -1;
+        co->flights[i].co = co;
+    }
+
+ret:
+    return status;
+}
+
+int mmx_backapi_coalesce_destroy(mmxba_coalesce_t *co)
+{
+    unsigned int i;
+
+    if (co == NULL || co->flights == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    for (i = 0; i <= co->mask; i++)
+        if (co->flights[i].in_use)
+        {
+            mmx_backapi_pending_cancel(co->pending, co->flights[i].opSeqNum);
+            flight_free(&co->flights[i]);
+        }
+
+    free(co->flights);
+    free(co->buckets);
+    memset(co, 0, sizeof(*co));
+
+    return MMXBA_OK;
+}
+
+int mmx_backapi_coalesce_submit(mmxba_coalesce_t *co, mmxba_request_t *req,
+                                unsigned int timeout_ms, mmxba_pending_cb_t cb,
+                                void *ctx, int *send)
+{
+    int status = MMXBA_OK;
+    char *key = NULL;
+    uint32_t hash;
+    int idx, seq;
+    mmxba_flight_t *f;
+
+    if (co == NULL || req == NULL || cb == NULL || send == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    *send = FALSE;
+
+    /* Only read operations are coalesced */
+    if (req->op_type != MMXBA_OP_TYPE_GET && req->op_type != MMXBA_OP_TYPE_GETALL)
+    {
+        if (req->op_type == MMXBA_OP_TYPE_SET || req->op_type == MMXBA_OP_TYPE_ADDOBJ ||
+            req->op_type == MMXBA_OP_TYPE_DELOBJ)
+            flights_detach_object(co, req->beObjName);
+
+        if ((seq = mmx_backapi_pending_next_seq(co->pending)) < 0)
+            GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Too many requests in flight");
+        if ((status = mmx_backapi_pending_add(co->pending, seq, timeout_ms, cb, ctx)) == MMXBA_OK)
+        {
+            req->opSeqNum = seq;
+            *send = TRUE;
+        }
+        goto ret;
+    }
+
+    if ((key = request_key(req)) == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Could not build request key");
+    hash = mmx_backapi_strhash(key, 0);
+
+    for (idx = co->buckets[hash & co->mask]; idx >= 0; idx = co->flights[idx].next)
+    {
+        f = &co->flights[idx];
+        if (f->hash == hash && !strcmp(f->key, key))
+        {
+            status = flight_add_waiter(f, cb, ctx);
+            if (status == MMXBA_OK)
+                co->coalesced++;
+            goto ret;
+        }
+    }
+
+    if ((seq = mmx_backapi_pending_next_seq(co->pending)) < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Too many requests in flight");
+
+    /* New flight in the entry of its pending table index */
+    idx = seq & co->mask;
+    f = &co->flights[idx];
+    if (f->in_use)
+        GOTO_RET_WITH_ERROR(MMXBA_GENERAL_ERROR, "Flight entry of seq %d is busy", seq);
+
+    if ((status = flight_add_waiter(f, cb, ctx)) != MMXBA_OK)
+        goto ret;
+
+    if ((status = mmx_backapi_pending_add(co->pending, seq, timeout_ms,
+                                          flight_complete, f)) != MMXBA_OK)
+    {
+        flight_free(f);
+        goto ret;
+    }
+
+    f->in_use = TRUE;
+    f->linked = TRUE;
+    f->opSeqNum = seq;
+    f->hash = hash;
+    f->key = key;
+    key = NULL;
+    f->next = co->buckets[hash & co->mask];
+    co->buckets[hash & co->mask] = idx;
+
+    req->opSeqNum = seq;
+    *send = TRUE;
+    co->leaders++;
+
+ret:
+    free(key);
+    return status;
+}
@@ -0,0 +1,147 @@
+/* mmx-backapi-coalesce.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+/*
+ * Single-flight coalescing of identical GET and GETALL requests of the
+ * Entry point.
+ *
+ * A request is submitted with its completion callback. If an identical
+ * request (the same operation, beObjName, mmxInstances, beKeyParams,
+ * requested names and GETALL generation) is already in flight, the new request is attached to
+ * it and is not sent; otherwise the request becomes the leader of a new
+ * flight: it gets the sequence number, is registered in the pending table
+ * and must be sent by the caller. When the leader response is matched by the pending table
+ * (mmx_backapi_pending_complete()) or the leader expires, the callbacks of
+ * all attached requests are called with the same parsed response.
+ *
+ * Other operations are registered in the pending table and sent as is.
+ * SET, ADDOBJ and DELOBJ requests detach the flights of the same beObjName:
+ * their waiters get the response as usual, but the reads submitted after
+ * the write start a new flight (read-your-writes).
+ */
+
+#ifndef MMX_BACKAPI_COALESCE_H_
+#define MMX_BACKAPI_COALESCE_H_
+
+#include "mmx-backapi.h"
+#include "mmx-backapi-pending.h"
+
+typedef struct mmxba_waiter_s {
+    mmxba_pending_cb_t     cb;
+    void                   *ctx;
+    struct mmxba_waiter_s  *next;
+} mmxba_waiter_t;
+
+/* Requests in flight; the flight of a leader request is kept in the
+   entry with the same index as its pending table entry */
+typedef struct mmxba_flight_s {
+    struct mmxba_coalesce_s  *co;
+    int                      in_use;
+    int                      linked;    /* in the hash chain */
+    int                      opSeqNum;
+    uint32_t                 hash;
+    char                     *key;
+    int                      next;      /* hash chain */
+    mmxba_waiter_t           *waiters;
+    mmxba_waiter_t           *last;
+    unsigned int             waiters_num;
+} mmxba_flight_t;
+
+typedef struct mmxba_coalesce_s {
+    mmxba_pending_t  *pending;
+    mmxba_flight_t   *flights;
+    int              *buckets;
+    unsigned int     mask;
+
+    /* statistics */
+    unsigned long    leaders;
+    unsigned long    coalesced;
+    unsigned long    detached;  /* flights detached by writes */
+} mmxba_coalesce_t;
+
+
+/*
+ * Initializes coalescing layer over the pending table
+ */
+int mmx_backapi_coalesce_init(mmxba_coalesce_t *co, mmxba_pending_t *pending);
+
+/*
+ * Frees the coalescing layer; callbacks of the flights are not called
+ */
+int mmx_backapi_coalesce_destroy(mmxba_coalesce_t *co);
+
+/*
+ * Submits request. If *send is set to TRUE, req->opSeqNum is set to the
+ * allocated sequence number and the caller must send the request;
+ * otherwise the request is attached to the identical one in flight.
+ * The callback is called with the response of the sent request.
+ */
+int mmx_backapi_coalesce_submit(mmxba_coalesce_t *co, mmxba_request_t *req,
+                                unsigned int timeout_ms, mmxba_pending_cb_t cb,
+                                void *ctx, int *send);
+
+#endif /* MMX_BACKAPI_COALESCE_H_ */
@@ -0,0 +1,286 @@
+/* mmx-backapi-dict.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Dictionary of parameter names.
+ */
+
+#include <stdio.h>
+
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-dict.h"
+
+#define DICT_HASH_SEED      0x64696374U
+#define DICT_DATA_INIT_SIZE 4096
+
+static const mmxba_dict_t *attached_dict = NULL;
+static int attached_compact = FALSE;
+
+
+/* ------------------------------------------------------------------- */
+/*  -----------  MMX dictionary internal functions    -----------------*/
+/* ------------------------------------------------------------------- */
+
+/* Returns slot of the name in the ids table: slot of its id or empty one */
+static unsigned int slot_find(const mmxba_dict_t *dict, const char *name)
+{
+    unsigned int i = mmx_backapi_strhash(name, DICT_HASH_SEED) & dict->tableMask;
+
+    while (dict->table[i] != MMXBA_DICT_NO_ID &&
+           strcmp(dict->data + dict->offs[dict->table[i]], name))
+        i = (i + 1) & dict->tableMask;
+
+    return i;
+}
+
+/* Checksum depends on all names and their order, i.e. on the ids */
+static void checksum_update(mmxba_dict_t *dict, const char *name)
+{
+    uint32_t hash = dict->checksum;
+
+    while (*name)
+    {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619U;
+    }
+    hash ^= '\n';
+    hash *= 16777619U;
+
+    dict->checksum = hash;
+}
+
+
+/* ------------------------------------------------------------------- */
+/*  ----------------  MMX dictionary API functions    -----------------*/
+/* ------------------------------------------------------------------- */
+int mmx_backapi_dict_init(mmxba_dict_t *dict, unsigned int max_names)
+{
+    int status = MMXBA_OK;
+    unsigned int nt = 1;
+
+    if (dict == NULL || max_names == 0 || max_names > MMXBA_DICT_MAX_NAMES)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    memset(dict, 0, sizeof(*dict));
+
+    /* The table is kept at most half full */
+    while (nt < 2 * max_names)
+        nt <<= 1;
+
+    dict->maxNames = max_names;
+    dict->tableMask = nt - 1;
+    dict->checksum = 2166136261U;
+    dict->dataSize = DICT_DATA_INIT_SIZE;
+
+    dict->data = malloc(dict->dataSize);
+    dict->offs = malloc((max_names + 1) * sizeof(uint32_t));
+    dict->table = calloc(nt, sizeof(uint16_t));
+    if (!dict->data || !dict->offs || !dict->table)
+    {
+        free(dict->data);
+        free(dict->offs);
+        free(dict->table);
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "%s: Could not allocate dictionary",
+                            __func__);
+    }
+
+ret:
+    return status;
+}
+
+int mmx_backapi_dict_destroy(mmxba_dict_t *dict)
+{
+    if (dict == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    if (__atomic_load_n(&attached_dict, __ATOMIC_ACQUIRE) == dict)
+        mmx_backapi_dict_attach(NULL, FALSE);
+
+    free(dict->data);
+    free(dict->offs);
+    free(dict->table);
+    memset(dict, 0, sizeof(*dict));
+
+    return MMXBA_OK;
+}
+
+int mmx_backapi_dict_add(mmxba_dict_t *dict, const char *name, uint16_t *id)
+{
+    int status = MMXBA_OK;
+    unsigned int slot;
+    size_t len;
+    char *data;
+
+    if (dict == NULL || dict->table == NULL || name == NULL || *name == '\0')
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    if ((len = strlen(name)) >= MMXBA_MAX_STR_LEN)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "Too long dictionary name %s", name);
+
+    slot = slot_find(dict, name);
+    if (dict->table[slot] == MMXBA_DICT_NO_ID)
+    {
+        if (dict->namesNum >= dict->maxNames)
+            GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Dictionary is full (%u names)",
+                                dict->namesNum);
+
+        if (dict->dataLen + len + 1 > dict->dataSize)
+        {
+            if ((data = realloc(dict->data, 2 * dict->dataSize + len + 1)) == NULL)
+                GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Could not grow dictionary");
+            dict->data = data;
+            dict->dataSize = 2 * dict->dataSize + len + 1;
+        }
+
+        memcpy(dict->data + dict->dataLen, name, len + 1);
+        dict->offs[++dict->namesNum] = dict->dataLen;
+        dict->dataLen += len + 1;
+        dict->table[slot] = dict->namesNum;
+        checksum_update(dict, name);
+    }
+
+    if (id)
+        *id = dict->table[slot];
+
+ret:
+    return status;
+}
+
+int mmx_backapi_dict_load(mmxba_dict_t *dict, const char *path)
+{
+    int status = MMXBA_OK;
+    char line[MMXBA_MAX_STR_LEN + 2];
+    unsigned int lineNum = 0;
+    size_t len;
+    FILE *f = NULL;
+
+    if (dict == NULL || path == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    if ((f = fopen(path, "r")) == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not open dictionary %s", path);
+
+    while (fgets(line, sizeof(line), f))
+    {
+        lineNum++;
+        len = strlen(line);
+        if (len > 0 && line[len - 1] != '\n' && !feof(f))
+            GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "%s:%u: too long name", path, lineNum);
+
+        while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r' ||
+                           line[len - 1] == ' ' || line[len - 1] == '\t'))
+            line[--len] = '\0';
+
+        if (len == 0 || line[0] == '#')
+            continue;
+
+        if ((status = mmx_backapi_dict_add(dict, line, NULL)) != MMXBA_OK)
+            GOTO_RET_WITH_ERROR(status, "%s:%u: could not add name", path, lineNum);
+    }
+
+    ing_log(LOG_DEBUG, "Dictionary %s: %u names, checksum %08x\n",
+            path, dict->namesNum, dict->checksum);
+
+ret:
+    if (f)
+        fclose(f);
+
+    return status;
+}
+
+uint16_t mmx_backapi_dict_id(const mmxba_dict_t *dict, const char *name)
+{
+    if (dict == NULL || dict->table == NULL || name == NULL)
+        return MMXBA_DICT_NO_ID;
+
+    return dict->table[slot_find(dict, name)];
+}
+
+const char *mmx_backapi_dict_name(const mmxba_dict_t *dict, uint16_t id)
+{
+    if (dict == NULL || id == MMXBA_DICT_NO_ID || id > dict->namesNum)
+        return NULL;
+
+    return dict->data + dict->offs[id];
+}
+
+void mmx_backapi_dict_attach(const mmxba_dict_t *dict, int compact)
+{
+    __atomic_store_n(&attached_compact, compact ? TRUE : FALSE, __ATOMIC_RELAXED);
+    __atomic_store_n(&attached_dict, dict, __ATOMIC_RELEASE);
+}
+
+const mmxba_dict_t *mmx_backapi_dict_attached(int *compact)
+{
+    const mmxba_dict_t *dict = __atomic_load_n(&attached_dict, __ATOMIC_ACQUIRE);
+
+    if (compact)
+        *compact = __atomic_load_n(&attached_compact, __ATOMIC_RELAXED);
+
+    return dict;
+}
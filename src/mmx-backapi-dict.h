@@ -0,0 +1,159 @@
+/* mmx-backapi-dict.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Dictionary of parameter names shared by the entry-point and backends.
+ *
+ * The dictionary maps parameter names to small integer ids (1 - the first
+ * name, 0 - no id). Both peers build the same dictionary, usually by
+ * loading the same file (one name per line, empty lines and lines
+ * starting with '#' are ignored); the checksum of the names identifies
+ * the dictionary.
+ *
+ * When a dictionary is attached to the library:
+ *   - the builders mark messages by the dictionary checksum and add id
+ *     attributes to names of parameters found in the dictionary; in the
+ *     compact mode the name text is omitted,
+ *   - the parsers resolve ids of messages built with the same dictionary
+ *     and expose them in nameIds and beKeyIds of the parsed message, so
+ *     backends can switch on ids instead of comparing names.
+ * Names are always filled by the parsers, so the dictionary is transparent
+ * for code that uses names only. Messages of peers using other dictionary
+ * are parsed by names; compact names of such messages cannot be resolved
+ * and the message is rejected, so the compact mode must be enabled only
+ * when all peers share the dictionary.
+ *
+ * The attached dictionary must not be changed.
+ */
+
+#ifndef MMX_BACKAPI_DICT_H_
+#define MMX_BACKAPI_DICT_H_
+
+#include <stdint.h>
+
+#include "mmx-backapi.h"
+
+#define MMXBA_DICT_NO_ID        0
+#define MMXBA_DICT_MAX_NAMES    UINT16_MAX
+
+typedef struct mmxba_dict_s {
+    uint32_t      checksum;
+    unsigned int  namesNum;     /* ids are 1 .. namesNum */
+    unsigned int  maxNames;
+
+    char          *data;        /* null terminated names */
+    size_t        dataSize;
+    size_t        dataLen;
+    uint32_t      *offs;        /* offsets of the names in data by id */
+
+    uint16_t      *table;       /* open addressing table of ids */
+    unsigned int  tableMask;
+} mmxba_dict_t;
+
+
+/*
+ * Initializes empty dictionary of up to max_names names
+ */
+int mmx_backapi_dict_init(mmxba_dict_t *dict, unsigned int max_names);
+
+int mmx_backapi_dict_destroy(mmxba_dict_t *dict);
+
+/*
+ * Adds the name to the dictionary; *id (may be NULL) is set to id of the
+ * name, the existing id is returned for the known names
+ */
+int mmx_backapi_dict_add(mmxba_dict_t *dict, const char *name, uint16_t *id);
+
+/*
+ * Adds names of the dictionary file in the file order
+ */
+int mmx_backapi_dict_load(mmxba_dict_t *dict, const char *path);
+
+/*
+ * Returns id of the name, or MMXBA_DICT_NO_ID
+ */
+uint16_t mmx_backapi_dict_id(const mmxba_dict_t *dict, const char *name);
+
+/*
+ * Returns name of the id, or NULL
+ */
+const char *mmx_backapi_dict_name(const mmxba_dict_t *dict, uint16_t id);
+
+/*
+ * Attaches the dictionary to the message builders and parsers
+ * (NULL detaches); compact - names with ids are sent without text
+ */
+void mmx_backapi_dict_attach(const mmxba_dict_t *dict, int compact);
+
+/*
+ * Returns the attached dictionary, and its mode if compact is not NULL
+ * (used by the library)
+ */
+const mmxba_dict_t *mmx_backapi_dict_attached(int *compact);
+
+#endif /* MMX_BACKAPI_DICT_H_ */
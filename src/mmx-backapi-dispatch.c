@@ -0,0 +1,749 @@
+/* mmx-backapi-dispatch.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Backend request dispatcher: handlers registry and epoll loop.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-dispatch.h"
+#include "mmx-backapi-workers.h"
+#include "mmx-backapi-xfer.h"
+
+#define DISPATCH_LISTENER_ID        0xffffffffU
+#define DISPATCH_MAX_SEEDS          4096
+#define DISPATCH_MAX_TABLE_SIZE     (1U << 16)
+
+/* Batches received from a transport per loop iteration, so that one busy
+   transport does not starve the others */
+#define DISPATCH_BATCHES_PER_EVENT  4
+
+
+/* ------------------------------------------------------------------- */
+/*  -----------  MMX dispatcher internal functions    -----------------*/
+/* ------------------------------------------------------------------- */
+
+static uint32_t hash_mix(uint32_t h, uint32_t seed)
+{
+    h ^= seed * 0x9e3779b9U;
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+
+    return h;
+}
+
+/* Builds perfect hash table of the registered object names ("hash and
+   displace"): the names are split to buckets by their hash, and a seed
+   is selected for every bucket (the largest buckets first) so that all
+   its names get free slots of the table. Lookup takes one pass over
+   the name, one bucket seed read and one slot read. */
+static int table_build(mmxba_dispatcher_t *d)
+{
+    int status = MMXBA_OK;
+    unsigned int n = d->entries_num, nb = n / 2 + 1;
+    unsigned int size = 2, i, j, k, b, slot, cnt;
+    unsigned int *order = NULL, *bucket_cnt = NULL;
+    uint32_t *hashes = NULL, seed;
+    unsigned int slots[n];
+    int *table;
+
+    while (size < 2 * n)
+        size <<= 1;
+
+    hashes = malloc(n * sizeof(uint32_t));
+    order = malloc(nb * sizeof(unsigned int));
+    bucket_cnt = calloc(nb, sizeof(unsigned int));
+    free(d->seeds);
+    d->seeds = calloc(nb, sizeof(uint32_t));
+    if (!hashes || !order || !bucket_cnt || !d->seeds)
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Could not allocate handlers table");
+
+    for (i = 0; i < n; i++)
+    {
+        hashes[i] = mmx_backapi_strhash(d->entries[i].beObjName, 0);
+        bucket_cnt[hashes[i] % nb]++;
+    }
+
+    /* Buckets in descending order of their sizes */
+    for (b = 0; b < nb; b++)
+    {
+        for (j = b; j > 0 && bucket_cnt[order[j - 1]] < bucket_cnt[b]; j--)
+            order[j] = order[j - 1];
+        order[j] = b;
+    }
+
+    for (; size <= DISPATCH_MAX_TABLE_SIZE; size <<= 1)
+    {
+        if ((table = realloc(d->table, size * sizeof(int))) == NULL)
+            GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Could not allocate handlers table");
+        d->table = table;
+
+        for (slot = 0; slot < size; slot++)
+            d->table[slot] = -1;
+
+        for (j = 0; j < nb && bucket_cnt[order[j]]; j++)
+        {
+            b = order[j];
+            for (seed = 1; seed < DISPATCH_MAX_SEEDS; seed++)
+            {
+                for (i = 0, cnt = 0; i < n; i++)
+                {
+                    if (hashes[i] % nb != b)
+                        continue;
+                    slots[cnt] = hash_mix(hashes[i], seed) & (size - 1);
+                    if (d->table[slots[cnt]] >= 0)
+                        break;
+                    for (k = 0; k < cnt && slots[k] != slots[cnt]; k++)
+                        ;
+                    if (k < cnt)
+                        break;
+                    cnt++;
+                }
+                if (i == n)
+                    break;
+            }
+
+            if (seed == DISPATCH_MAX_SEEDS)
+                break;
+
+            d->seeds[b] = seed;
+            for (i = 0, cnt = 0; i < n; i++)
+                if (hashes[i] % nb == b)
+                    d->table[slots[cnt++]] = i;
+        }
+
+        if (j == nb || bucket_cnt[order[j]] == 0)
+        {
+            d->table_mask = size - 1;
+            d->seeds_num = nb;
+            d->table_valid = TRUE;
+            goto ret;
+        }
+    }
+
+    GOTO_RET_WITH_ERROR(MMXBA_GENERAL_ERROR, "Could not build handlers table of %u objects", n);
+
+ret:
+    free(hashes);
+    free(order);
+    free(bucket_cnt);
+    return status;
+}
+
+static int entry_find(mmxba_dispatcher_t *d, const char *beObjName)
+{
+    uint32_t h;
+    int idx;
+
+    /* The table is built by mmx_backapi_dispatch_seal() only */
+    if (!d->table_valid)
+        return -1;
+
+    h = mmx_backapi_strhash(beObjName, 0);
+    idx = d->table[hash_mix(h, d->seeds[h % d->seeds_num]) & d->table_mask];
+    if (idx >= 0 && strcmp(d->entries[idx].beObjName, beObjName))
+        idx = -1;
+
+    return idx;
+}
+
+static int transport_add(mmxba_dispatcher_t *d, mmxba_transport_t *tr, int owned)
+{
+    int status = MMXBA_OK;
+    unsigned int i;
+    struct epoll_event ev;
+
+    for (i = 0; i < MMXBA_DISPATCH_MAX_TRANSPORTS; i++)
+        if (d->transports[i] == NULL)
+            break;
+
+    if (i == MMXBA_DISPATCH_MAX_TRANSPORTS)
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Too many dispatcher transports");
+
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    ev.data.u32 = i;
+    if (epoll_ctl(d->epfd, EPOLL_CTL_ADD, tr->fd, &ev) < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not add transport to epoll: %s",
+                            strerror(errno));
+
+    tr->refs = 1;   /* reference of the dispatcher */
+    d->transports[i] = tr;
+    d->owned[i] = owned;
+
+ret:
+    return status;
+}
+
+static void transport_remove(mmxba_dispatcher_t *d, unsigned int i)
+{
+    mmxba_transport_t *tr = d->transports[i];
+
+    epoll_ctl(d->epfd, EPOLL_CTL_DEL, tr->fd, NULL);
+    if (d->owned[i])
+        mmx_backapi_dispatch_transport_release(tr);
+
+    d->transports[i] = NULL;
+    d->owned[i] = FALSE;
+}
+
+static void listener_accept(mmxba_dispatcher_t *d)
+{
+    mmxba_transport_t *tr = malloc(sizeof(mmxba_transport_t));
+
+    if (tr == NULL)
+    {
+        ing_log(LOG_ERR, "Could not allocate transport of new connection\n");
+        return;
+    }
+
+    if (mmx_backapi_transport_unix_accept(tr, d->listen_fd) != MMXBA_OK)
+    {
+        free(tr);
+        return;
+    }
+
+    if (transport_add(d, tr, TRUE) != MMXBA_OK)
+    {
+        mmx_backapi_transport_close(tr);
+        free(tr);
+    }
+}
+
+/* Processes received batches of the transport; returns FALSE if the peer
+   has closed the connection */
+static int transport_serve(mmxba_dispatcher_t *d, mmxba_transport_t *tr)
+{
+    static const mmxba_prio_t order[MMXBA_PRIO_NUM] = {
+        MMXBA_PRIO_INTERACTIVE, MMXBA_PRIO_NORMAL, MMXBA_PRIO_BULK
+    };
+    unsigned int count, num, i, p, batch;
+    int prios[MMXBA_TRANSPORT_BATCH_SIZE];
+    mmxba_sockaddr_t *peer;
+    char *msg, *resp;
+    size_t len;
+
+    for (batch = 0; batch < DISPATCH_BATCHES_PER_EVENT; batch++)
+    {
+        if (mmx_backapi_transport_recv(tr, FALSE, &count) != MMXBA_OK)
+            return (tr->type == MMXBA_TRANSPORT_UDP);
+        if (count == 0)
+            break;
+
+        /* Zero length message on connected socket means end of file:
+           only the messages received before it are processed */
+        for (num = 0; num < count; num++)
+            if (tr->type == MMXBA_TRANSPORT_UNIX && tr->rx_msgs[num].msg_len == 0)
+                break;
+
+        for (i = 0; i < num; i++)
+        {
+            prios[i] = -1;
+            if ((msg = mmx_backapi_transport_rx_msg(tr, i, &len, &peer)) == NULL)
+                continue;
+
+            /* The workers queue requests by their priority themselves */
+            if (d->workers)
+                mmx_backapi_workers_submit(d->workers, tr, peer, msg, len);
+            else
+                prios[i] = mmx_backapi_message_peek_prio(msg);
+        }
+
+        /* Requests of the batch are processed in order of their priority */
+        for (p = 0; p < MMXBA_PRIO_NUM && !d->workers; p++)
+        {
+            for (i = 0; i < num; i++)
+            {
+                if (prios[i] != order[p])
+                    continue;
+
+                msg = mmx_backapi_transport_rx_msg(tr, i, &len, &peer);
+                resp = d->tx_buffs + (size_t)i * MMXBA_MAX_MSG_SIZE;
+                if (mmx_backapi_dispatch_message(d, msg, resp, MMXBA_MAX_MSG_SIZE -
+                                                 sizeof(mmxba_flags)) != MMXBA_OK)
+                    continue;
+
+                mmx_backapi_transport_send(tr, peer, resp, strlen(resp));
+
+                /* Chunks of large values follow the response */
+                if (d->req->xferOut)
+                {
+                    mmx_backapi_transport_flush(tr);
+                    mmx_backapi_xfer_send(d->req, tr, peer);
+                }
+            }
+        }
+
+        mmx_backapi_transport_flush(tr);
+
+        if (num < count)
+            return FALSE;
+
+        if (count < MMXBA_TRANSPORT_BATCH_SIZE)
+            break;
+    }
+
+    return TRUE;
+}
+
+
+/* Prepares response of the request whose deadline is expired: only the
+   header is parsed, the response carries no parameters */
+static int request_shed(mmxba_dispatcher_t *d, mmxba_request_t *req, const char *xml_string)
+{
+    int status;
+
+    if ((status = mmx_backapi_message_hdr_parse(xml_string, req)) != MMXBA_OK)
+        return status;
+
+    req->mmxInstances[0] = '\0';
+    req->beKeyParamsNum = 0;
+    req->paramValues.arraySize = 0;   /* and beKeyNamesNum */
+    if (req->op_type == MMXBA_OP_TYPE_GETALL)
+    {
+        req->getAll.objNum = 0;
+        req->getAll.isDelta = FALSE;
+        req->getAll.generation = 0;
+    }
+    else if (req->op_type == MMXBA_OP_TYPE_ADDOBJ)
+        req->addObj_resp.objNum = 0;
+
+    req->opResCode = MMXBA_SHED;
+    strcpy_safe(req->errMsg, "Request deadline expired", sizeof(req->errMsg));
+    __atomic_add_fetch(&d->shed, 1, __ATOMIC_RELAXED);
+
+    return MMXBA_OK;
+}
+
+/* Parses request message and calls its handler: the request is ready for
+   building the response unless its header could not be parsed */
+static int dispatch_process(mmxba_dispatcher_t *d, mmxba_request_t *req,
+                            const char *xml_string)
+{
+    int status = MMXBA_OK;
+    int res;
+    void *ctx;
+    mmxba_handler_t handler;
+
+    /* Reuse the request structure and its memory pool */
+    mmx_backapi_xfer_release(req);
+    req->mem_pool.curr_offset = 0;
+    req->op_type = MMXBA_OP_TYPE_ERROR;
+    req->opResCode = req->opExtErrCode = req->postOpStatus = 0;
+    req->subscrId = 0;
+    req->errMsg[0] = '\0';
+
+    /* The caller has given up: do not waste time on the request */
+    if (mmx_backapi_deadline_expired(mmx_backapi_message_peek_deadline(xml_string)))
+    {
+        if ((status = request_shed(d, req, xml_string)) != MMXBA_OK)
+            return status;
+    }
+    else if ((res = mmx_backapi_message_parse(xml_string, req)) != MMXBA_OK)
+    {
+        /* The request can be answered only if its header was parsed */
+        req->opResCode = res;
+        strcpy_safe(req->errMsg, "Bad format of request", sizeof(req->errMsg));
+    }
+    else if ((handler = mmx_backapi_dispatch_lookup(d, req->beObjName, req->op_type,
+                                                    &ctx)) == NULL)
+    {
+        req->opResCode = MMXBA_GENERAL_ERROR;
+        strcpy_safe(req->errMsg, "Object or operation is not supported",
+                    sizeof(req->errMsg));
+    }
+    else if ((res = handler(req, ctx)) != MMXBA_OK && req->opResCode == 0)
+    {
+        req->opResCode = res;
+    }
+
+    return status;
+}
+
+
+/* ------------------------------------------------------------------- */
+/*  ----------------  MMX dispatcher API functions    -----------------*/
+/* ------------------------------------------------------------------- */
+int mmx_backapi_dispatch_init(mmxba_dispatcher_t *d)
+{
+    int status = MMXBA_OK;
+
+    if (d == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    memset(d, 0, sizeof(*d));
+    d->listen_fd = -1;
+
+    if ((d->epfd = epoll_create1(EPOLL_CLOEXEC)) < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not create epoll: %s", strerror(errno));
+
+    d->req = malloc(sizeof(mmxba_request_t));
+    d->mem_pool = malloc(MMXBA_DISPATCH_POOL_SIZE);
+    d->tx_buffs = malloc((size_t)MMXBA_TRANSPORT_BATCH_SIZE * MMXBA_MAX_MSG_SIZE);
+    if (!d->req || !d->mem_pool || !d->tx_buffs)
+    {
+        mmx_backapi_dispatch_destroy(d);
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "%s: Could not allocate buffers", __func__);
+    }
+
+    memset(d->req, 0, sizeof(mmxba_request_t));
+    status = mmx_backapi_msgstruct_init(d->req, d->mem_pool, MMXBA_DISPATCH_POOL_SIZE);
+
+ret:
+    return status;
+}
+
+int mmx_backapi_dispatch_destroy(mmxba_dispatcher_t *d)
+{
+    unsigned int i;
+
+    if (d == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    for (i = 0; i < MMXBA_DISPATCH_MAX_TRANSPORTS; i++)
+        if (d->transports[i])
+            transport_remove(d, i);
+
+    if (d->epfd >= 0)
+        close(d->epfd);
+
+    free(d->entries);
+    free(d->table);
+    free(d->seeds);
+    free(d->req);
+    free(d->mem_pool);
+    free(d->tx_buffs);
+    memset(d, 0, sizeof(*d));
+    d->epfd = d->listen_fd = -1;
+
+    return MMXBA_OK;
+}
+
+int mmx_backapi_dispatch_register(mmxba_dispatcher_t *d, const char *beObjName,
+                                  mmxba_op_type_t op_type, mmxba_handler_t handler,
+                                  void *ctx)
+{
+    int status = MMXBA_OK;
+    unsigned int i;
+    mmxba_handler_entry_t *e = NULL;
+
+    if (d == NULL || beObjName == NULL || handler == NULL ||
+        op_type < 0 || op_type >= MMXBA_OP_TYPE_NUM ||
+        strlen(beObjName) >= MMXBA_MAX_STR_LEN)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    /* Registration is not on the hot path: linear search is used */
+    for (i = 0; i < d->entries_num; i++)
+        if (!strcmp(d->entries[i].beObjName, beObjName))
+        {
+            e = &d->entries[i];
+            break;
+        }
+
+    if (e == NULL)
+    {
+        if (d->entries_num == d->entries_max)
+        {
+            unsigned int max = d->entries_max ? 2 * d->entries_max : 16;
+
+            if ((e = realloc(d->entries, max * sizeof(*e))) == NULL)
+                GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Could not allocate handler entry");
+            d->entries = e;
+            d->entries_max = max;
+        }
+
+        e = &d->entries[d->entries_num++];
+        memset(e, 0, sizeof(*e));
+        strcpy_safe(e->beObjName, beObjName, sizeof(e->beObjName));
+        d->table_valid = FALSE;
+        d->table_status = MMXBA_OK;
+    }
+
+    e->handlers[op_type].handler = handler;
+    e->handlers[op_type].ctx = ctx;
+
+ret:
+    return status;
+}
+
+int mmx_backapi_dispatch_set_serial(mmxba_dispatcher_t *d, const char *beObjName,
+                                    int serial)
+{
+    unsigned int i;
+
+    if (d == NULL || beObjName == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    for (i = 0; i < d->entries_num; i++)
+        if (!strcmp(d->entries[i].beObjName, beObjName))
+        {
+            if (d->entries[i].serial != (serial != FALSE))
+                d->serial_num += serial ? 1 : -1;
+            d->entries[i].serial = (serial != FALSE);
+            return MMXBA_OK;
+        }
+
+    ing_log(LOG_ERR, "%s: object %s is not registered\n", __func__, beObjName);
+    return MMXBA_BAD_INPUT_PARAMS;
+}
+
+int mmx_backapi_dispatch_is_serial(mmxba_dispatcher_t *d, const char *beObjName)
+{
+    int idx;
+
+    if (d->serial_num == 0 || (idx = entry_find(d, beObjName)) < 0)
+        return FALSE;
+
+    return d->entries[idx].serial;
+}
+
+int mmx_backapi_dispatch_seal(mmxba_dispatcher_t *d)
+{
+    if (d == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    if (d->table_valid || d->entries_num == 0)
+        return MMXBA_OK;
+
+    /* The failure is kept until the registrations change: the table is
+       not rebuilt (and the failure is not logged) by every call */
+    if (d->table_status == MMXBA_OK && (d->table_status = table_build(d)) != MMXBA_OK)
+        ing_log(LOG_ERR, "Dispatcher is not sealed: requests can not be served\n");
+
+    return d->table_status;
+}
+
+int mmx_backapi_dispatch_set_default(mmxba_dispatcher_t *d, mmxba_handler_t handler,
+                                     void *ctx)
+{
+    if (d == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    d->default_handler = handler;
+    d->default_ctx = ctx;
+
+    return MMXBA_OK;
+}
+
+mmxba_handler_t mmx_backapi_dispatch_lookup(mmxba_dispatcher_t *d, const char *beObjName,
+                                            mmxba_op_type_t op_type, void **ctx)
+{
+    int idx;
+
+    if (op_type >= 0 && op_type < MMXBA_OP_TYPE_NUM &&
+        (idx = entry_find(d, beObjName)) >= 0 && d->entries[idx].handlers[op_type].handler)
+    {
+        *ctx = d->entries[idx].handlers[op_type].ctx;
+        return d->entries[idx].handlers[op_type].handler;
+    }
+
+    *ctx = d->default_ctx;
+    return d->default_handler;
+}
+
+int mmx_backapi_dispatch_add_transport(mmxba_dispatcher_t *d, mmxba_transport_t *tr)
+{
+    if (d == NULL || tr == NULL || tr->fd < 0)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    return transport_add(d, tr, FALSE);
+}
+
+int mmx_backapi_dispatch_add_listener(mmxba_dispatcher_t *d, int listen_fd)
+{
+    int status = MMXBA_OK;
+    struct epoll_event ev;
+
+    if (d == NULL || listen_fd < 0 || d->listen_fd >= 0)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    ev.events = EPOLLIN;
+    ev.data.u32 = DISPATCH_LISTENER_ID;
+    if (epoll_ctl(d->epfd, EPOLL_CTL_ADD, listen_fd, &ev) < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not add listener to epoll: %s",
+                            strerror(errno));
+
+    d->listen_fd = listen_fd;
+
+ret:
+    return status;
+}
+
+/* Requests are served only by the sealed dispatcher */
+static int dispatch_sealed(mmxba_dispatcher_t *d)
+{
+    if (d->table_valid || d->entries_num == 0)
+        return MMXBA_OK;
+
+    return (d->table_status != MMXBA_OK) ? d->table_status : MMXBA_NOT_INITIALIZED;
+}
+
+int mmx_backapi_dispatch_message(mmxba_dispatcher_t *d, const char *xml_string,
+                                 char *resp_buff, size_t resp_buff_size)
+{
+    return mmx_backapi_dispatch_handle(d, d->req, xml_string, resp_buff, resp_buff_size);
+}
+
+int mmx_backapi_dispatch_handle(mmxba_dispatcher_t *d, mmxba_request_t *req,
+                                const char *xml_string, char *resp_buff,
+                                size_t resp_buff_size)
+{
+    int status;
+
+    if ((status = dispatch_sealed(d)) != MMXBA_OK ||
+        (status = dispatch_process(d, req, xml_string)) != MMXBA_OK)
+        return status;
+
+    return mmx_backapi_response_build(req, resp_buff, resp_buff_size);
+}
+
+int mmx_backapi_dispatch_handlev(mmxba_dispatcher_t *d, mmxba_request_t *req,
+                                 const char *xml_string, mmxba_emitter_t *e)
+{
+    int status;
+
+    if ((status = dispatch_sealed(d)) != MMXBA_OK ||
+        (status = dispatch_process(d, req, xml_string)) != MMXBA_OK)
+        return status;
+
+    return mmx_backapi_response_buildv(req, e);
+}
+
+void mmx_backapi_dispatch_transport_release(mmxba_transport_t *tr)
+{
+    if (__atomic_sub_fetch(&tr->refs, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        mmx_backapi_transport_close(tr);
+        free(tr);
+    }
+}
+
+int mmx_backapi_dispatch_run_once(mmxba_dispatcher_t *d, int timeout_ms)
+{
+    int status = MMXBA_OK;
+    struct epoll_event events[MMXBA_DISPATCH_MAX_TRANSPORTS + 1];
+    int n, i;
+    unsigned int id;
+
+    if ((status = dispatch_sealed(d)) != MMXBA_OK)
+        GOTO_RET_WITH_ERROR(status, "Dispatcher must be sealed before serving requests");
+
+    n = epoll_wait(d->epfd, events, MMXBA_DISPATCH_MAX_TRANSPORTS + 1, timeout_ms);
+    if (n < 0)
+    {
+        if (errno == EINTR)
+            goto ret;
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not wait for requests: %s",
+                            strerror(errno));
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        id = events[i].data.u32;
+
+        if (id == DISPATCH_LISTENER_ID)
+        {
+            listener_accept(d);
+            continue;
+        }
+
+        if (id >= MMXBA_DISPATCH_MAX_TRANSPORTS || d->transports[id] == NULL)
+            continue;
+
+        if (((events[i].events & EPOLLIN) && !transport_serve(d, d->transports[id])) ||
+            (events[i].events & (EPOLLHUP | EPOLLRDHUP | EPOLLERR)))
+            transport_remove(d, id);
+    }
+
+ret:
+    return status;
+}
+
+int mmx_backapi_dispatch_run(mmxba_dispatcher_t *d)
+{
+    int status = MMXBA_OK;
+
+    d->stop = FALSE;
+    while (!d->stop && status == MMXBA_OK)
+        status = mmx_backapi_dispatch_run_once(d, -1);
+
+    return status;
+}
+
+void mmx_backapi_dispatch_stop(mmxba_dispatcher_t *d)
+{
+    d->stop = TRUE;
+}
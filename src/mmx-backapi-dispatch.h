@@ -0,0 +1,269 @@
+/* mmx-backapi-dispatch.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+/*
+ * Backend request dispatcher.
+ *
+ * A backend registers a handler per beObjName and operation type and runs
+ * the dispatcher loop. The loop waits (epoll) on the backend transports,
+ * receives request batches, parses every request, finds its handler and
+ * builds and sends the response. The request structure, the message memory
+ * pool and the response buffers are allocated once and reused.
+ *
+ * The handlers are found by a perfect hash table built over the registered
+ * beObjNames, so the dispatch cost is one hash calculation and one string
+ * comparison regardless of the number of served objects.
+ *
+ * Requests of a received batch are processed in order of their priority
+ * classes (interactive, normal, bulk).
+ *
+ * Requests whose deadline has expired while they were queued are not
+ * parsed and processed: only their header is parsed and they are answered
+ * with MMXBA_SHED result code.
+ */
+
+#ifndef MMX_BACKAPI_DISPATCH_H_
+#define MMX_BACKAPI_DISPATCH_H_
+
+#include "mmx-backapi.h"
+#include "mmx-backapi-transport.h"
+#include "mmx-backapi-emit.h"
+
+#define MMXBA_DISPATCH_MAX_TRANSPORTS   32
+
+/* Size of message memory pool of a request */
+#define MMXBA_DISPATCH_POOL_SIZE \
+    ((MMXBA_MAX_MSG_SIZE < 65535) ? MMXBA_MAX_MSG_SIZE : 65535)
+
+struct mmxba_workers_s;
+
+/*
+ * Request handler: processes the parsed request and fills the response
+ * fields of the same structure. Non-zero return value is sent as opResCode
+ * if the handler did not set it.
+ */
+typedef int (*mmxba_handler_t)(mmxba_request_t *req, void *ctx);
+
+/* Handler of an operation and its context */
+typedef struct mmxba_op_handler_s {
+    mmxba_handler_t  handler;
+    void             *ctx;
+} mmxba_op_handler_t;
+
+typedef struct mmxba_handler_entry_s {
+    char                beObjName[MMXBA_MAX_STR_LEN];
+    mmxba_op_handler_t  handlers[MMXBA_OP_TYPE_NUM];
+    int                 serial;   /* requests are processed one by one */
+} mmxba_handler_entry_t;
+
+typedef struct mmxba_dispatcher_s {
+    int                    epfd;
+    int                    listen_fd;     /* AF_UNIX listener or -1 */
+    int                    stop;
+
+    /* Handlers registry and its perfect hash table */
+    mmxba_handler_entry_t  *entries;
+    unsigned int           entries_num;
+    unsigned int           entries_max;
+    int                    *table;        /* entry index per slot or -1 */
+    unsigned int           table_mask;
+    uint32_t               *seeds;        /* hash seed per bucket */
+    unsigned int           seeds_num;
+    int                    table_valid;
+    int                    table_status;  /* latched failure of the build */
+    unsigned int           serial_num;    /* number of serial objects */
+
+    mmxba_handler_t        default_handler;
+    void                   *default_ctx;
+
+    mmxba_transport_t      *transports[MMXBA_DISPATCH_MAX_TRANSPORTS];
+    int                    owned[MMXBA_DISPATCH_MAX_TRANSPORTS];
+
+    /* Buffers reused by every request */
+    mmxba_request_t        *req;
+    char                   *mem_pool;
+    char                   *tx_buffs;     /* one per message of a batch */
+
+    /* Worker threads runtime: if set, the received requests are passed
+       to the workers instead of being processed by the loop thread */
+    struct mmxba_workers_s *workers;
+
+    unsigned long          shed;          /* requests with expired deadline */
+} mmxba_dispatcher_t;
+
+
+/*
+ * Initializes dispatcher and allocates its buffers
+ */
+int mmx_backapi_dispatch_init(mmxba_dispatcher_t *d);
+
+/*
+ * Frees dispatcher buffers and closes the transports accepted by it
+ */
+int mmx_backapi_dispatch_destroy(mmxba_dispatcher_t *d);
+
+/*
+ * Registers handler of the specified operation on the backend object.
+ * ctx is passed to this handler only: handlers of other operations of the
+ * object (e.g. mmx_backapi_notify_handler()) may have their own contexts.
+ */
+int mmx_backapi_dispatch_register(mmxba_dispatcher_t *d, const char *beObjName,
+                                  mmxba_op_type_t op_type, mmxba_handler_t handler,
+                                  void *ctx);
+
+/*
+ * Sets serialization of the object requests: if serial is TRUE, requests
+ * of the object are never processed concurrently by the worker threads
+ * and are processed in the order of their receiving
+ */
+int mmx_backapi_dispatch_set_serial(mmxba_dispatcher_t *d, const char *beObjName,
+                                    int serial);
+
+/*
+ * Returns TRUE if the object requests are serialized
+ */
+int mmx_backapi_dispatch_is_serial(mmxba_dispatcher_t *d, const char *beObjName);
+
+/*
+ * Builds the handlers lookup table. It must be called after all handlers
+ * are registered and before requests are served: the serving functions
+ * fail with MMXBA_NOT_INITIALIZED (or the build failure) otherwise. The
+ * build failure is kept until handlers of new objects are registered.
+ */
+int mmx_backapi_dispatch_seal(mmxba_dispatcher_t *d);
+
+/*
+ * Sets handler of requests whose object or operation is not registered
+ */
+int mmx_backapi_dispatch_set_default(mmxba_dispatcher_t *d, mmxba_handler_t handler,
+                                     void *ctx);
+
+/*
+ * Returns handler of the object operation or the default handler
+ */
+mmxba_handler_t mmx_backapi_dispatch_lookup(mmxba_dispatcher_t *d, const char *beObjName,
+                                            mmxba_op_type_t op_type, void **ctx);
+
+/*
+ * Adds transport to the dispatcher loop. The transport is not owned by
+ * the dispatcher.
+ */
+int mmx_backapi_dispatch_add_transport(mmxba_dispatcher_t *d, mmxba_transport_t *tr);
+
+/*
+ * Adds AF_UNIX listening socket: the connections are accepted by the loop
+ * and served until the peer closes them
+ */
+int mmx_backapi_dispatch_add_listener(mmxba_dispatcher_t *d, int listen_fd);
+
+/*
+ * Parses request message, calls its handler and builds the response to
+ * resp_buff. Used by the dispatcher loop and by custom loops. Custom loops
+ * send chunks of the values transferred out of band (req->xferOut) by
+ * mmx_backapi_xfer_send() after the response (see mmx-backapi-xfer.h).
+ */
+int mmx_backapi_dispatch_message(mmxba_dispatcher_t *d, const char *xml_string,
+                                 char *resp_buff, size_t resp_buff_size);
+
+/*
+ * The same as mmx_backapi_dispatch_message() but uses the caller request
+ * structure (its memory pool must be initialized), so it can be called
+ * by several threads
+ */
+int mmx_backapi_dispatch_handle(mmxba_dispatcher_t *d, mmxba_request_t *req,
+                                const char *xml_string, char *resp_buff,
+                                size_t resp_buff_size);
+
+/*
+ * The same as mmx_backapi_dispatch_handle() but the response is added to
+ * the emitter (see mmx-backapi-emit.h) and refers to the request values,
+ * so it must be sent before the request structure is reused
+ */
+int mmx_backapi_dispatch_handlev(mmxba_dispatcher_t *d, mmxba_request_t *req,
+                                 const char *xml_string, mmxba_emitter_t *e);
+
+/*
+ * Releases reference to the transport taken when its request was passed
+ * to the workers. The transport accepted by the dispatcher is freed with
+ * the last reference after the connection is closed.
+ */
+void mmx_backapi_dispatch_transport_release(mmxba_transport_t *tr);
+
+/*
+ * Waits up to timeout_ms milliseconds (-1 - infinitely) and processes all
+ * received requests
+ */
+int mmx_backapi_dispatch_run_once(mmxba_dispatcher_t *d, int timeout_ms);
+
+/*
+ * Runs the dispatcher loop until mmx_backapi_dispatch_stop() is called
+ */
+int mmx_backapi_dispatch_run(mmxba_dispatcher_t *d);
+
+void mmx_backapi_dispatch_stop(mmxba_dispatcher_t *d);
+
+#endif /* MMX_BACKAPI_DISPATCH_H_ */
@@ -0,0 +1,271 @@
+/* mmx-backapi-emit.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Scatter-gather output of MMX backend API messages.
+ */
+
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-emit.h"
+
+/* ------------------------------------------------------------------- */
+/*  -----------  MMX emitter internal functions       -----------------*/
+/* ------------------------------------------------------------------- */
+
+/* Copies the bytes to the scratch buffer and appends them to the last
+   entry if it ends where the copy starts */
+static int emit_copy(mmxba_emitter_t *e, const char *s, size_t len)
+{
+    char *dst = e->scratch + e->scratch_len;
+    struct iovec *last = e->iov_num ? &e->iov[e->iov_num - 1] : NULL;
+
+    if (e->status != MMXBA_OK || len == 0)
+        return e->status;
+
+    /* Counting emitter: only the length of the message is needed */
+    if (e->iov == NULL)
+    {
+        e->total += len;
+        return MMXBA_OK;
+    }
+
+    if (len > e->scratch_size - e->scratch_len)
+        return (e->status = MMXBA_NOT_ENOUGH_MEMORY);
+
+    if (last && (char *)last->iov_base + last->iov_len == dst)
+        last->iov_len += len;
+    else if (e->iov_num < e->iov_max)
+    {
+        e->iov[e->iov_num].iov_base = dst;
+        e->iov[e->iov_num].iov_len = len;
+        e->iov_num++;
+    }
+    else
+        return (e->status = MMXBA_NOT_ENOUGH_MEMORY);
+
+    memcpy(dst, s, len);
+    e->scratch_len += len;
+    e->total += len;
+
+    return MMXBA_OK;
+}
+
+static const char *escape_entity(char c)
+{
+    switch (c)
+    {
+    case '&': return "&amp;";
+    case '<': return "&lt;";
+    case '>': return "&gt;";
+    case '"': return "&quot;";
+    default:  return NULL;
+    }
+}
+
+/* ------------------------------------------------------------------- */
+/*  ----------------  MMX emitter API functions  ----------------------*/
+/* ------------------------------------------------------------------- */
+void mmx_backapi_emit_init(mmxba_emitter_t *e, struct iovec *iov, unsigned int iov_max,
+                           char *scratch, size_t scratch_size)
+{
+    memset(e, 0, sizeof(*e));
+    e->iov = iov;
+    e->iov_max = iov_max;
+    e->scratch = scratch;
+    e->scratch_size = scratch_size;
+}
+
+int mmx_backapi_emit_raw(mmxba_emitter_t *e, const char *s, size_t len)
+{
+    return emit_copy(e, s, len);
+}
+
+int mmx_backapi_emit_ref(mmxba_emitter_t *e, const char *s, size_t len)
+{
+    if (e->status != MMXBA_OK)
+        return e->status;
+
+    /* One more entry is kept for the copies that follow the reference */
+    if (len < MMXBA_EMIT_REF_MIN || e->iov_num + 2 > e->iov_max)
+        return emit_copy(e, s, len);
+
+    e->iov[e->iov_num].iov_base = (void *)s;
+    e->iov[e->iov_num].iov_len = len;
+    e->iov_num++;
+    e->total += len;
+
+    return MMXBA_OK;
+}
+
+int mmx_backapi_emit_text(mmxba_emitter_t *e, const char *s)
+{
+    const char *run = s;
+    const char *entity;
+
+    if (s == NULL)
+        return e->status;
+
+    for (; *s; s++)
+    {
+        if ((entity = escape_entity(*s)) == NULL)
+            continue;
+
+        mmx_backapi_emit_ref(e, run, s - run);
+        emit_copy(e, entity, strlen(entity));
+        run = s + 1;
+    }
+
+    return mmx_backapi_emit_ref(e, run, s - run);
+}
+
+int mmx_backapi_emit_uint(mmxba_emitter_t *e, uint64_t val)
+{
+    char buf[24];
+    char *p = buf + sizeof(buf);
+
+    do {
+        *--p = '0' + val % 10;
+        val /= 10;
+    } while (val);
+
+    return emit_copy(e, p, buf + sizeof(buf) - p);
+}
+
+int mmx_backapi_emit_int(mmxba_emitter_t *e, int64_t val)
+{
+    if (val < 0)
+    {
+        emit_copy(e, "-", 1);
+        return mmx_backapi_emit_uint(e, -(uint64_t)val);
+    }
+
+    return mmx_backapi_emit_uint(e, val);
+}
+
+int mmx_backapi_emit_start(mmxba_emitter_t *e, const char *tag)
+{
+    emit_copy(e, "<", 1);
+    return emit_copy(e, tag, strlen(tag));
+}
+
+int mmx_backapi_emit_attr(mmxba_emitter_t *e, const char *name, const char *value)
+{
+    emit_copy(e, " ", 1);
+    emit_copy(e, name, strlen(name));
+    emit_copy(e, "=\"", 2);
+    mmx_backapi_emit_text(e, value);
+    return emit_copy(e, "\"", 1);
+}
+
+int mmx_backapi_emit_attr_uint(mmxba_emitter_t *e, const char *name, uint64_t val)
+{
+    emit_copy(e, " ", 1);
+    emit_copy(e, name, strlen(name));
+    emit_copy(e, "=\"", 2);
+    mmx_backapi_emit_uint(e, val);
+    return emit_copy(e, "\"", 1);
+}
+
+int mmx_backapi_emit_start_end(mmxba_emitter_t *e)
+{
+    return emit_copy(e, ">", 1);
+}
+
+int mmx_backapi_emit_open(mmxba_emitter_t *e, const char *tag)
+{
+    mmx_backapi_emit_start(e, tag);
+    return emit_copy(e, ">", 1);
+}
+
+int mmx_backapi_emit_close(mmxba_emitter_t *e, const char *tag)
+{
+    emit_copy(e, "</", 2);
+    emit_copy(e, tag, strlen(tag));
+    return emit_copy(e, ">", 1);
+}
+
+int mmx_backapi_emit_elem_text(mmxba_emitter_t *e, const char *tag, const char *text)
+{
+    mmx_backapi_emit_open(e, tag);
+    mmx_backapi_emit_text(e, text);
+    return mmx_backapi_emit_close(e, tag);
+}
+
+int mmx_backapi_emit_elem_uint(mmxba_emitter_t *e, const char *tag, uint64_t val)
+{
+    mmx_backapi_emit_open(e, tag);
+    mmx_backapi_emit_uint(e, val);
+    return mmx_backapi_emit_close(e, tag);
+}
+
+int mmx_backapi_emit_elem_int(mmxba_emitter_t *e, const char *tag, int64_t val)
+{
+    mmx_backapi_emit_open(e, tag);
+    mmx_backapi_emit_int(e, val);
+    return mmx_backapi_emit_close(e, tag);
+}
@@ -0,0 +1,173 @@
+/* mmx-backapi-emit.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Scatter-gather output of MMX backend API messages.
+ *
+ * The emitter builds xml message as an array of iovec entries that can be
+ * passed to writev/sendmsg directly, without saving the message to one
+ * contiguous buffer. Markup and short strings are copied to the scratch
+ * buffer of the emitter (adjacent copies are merged into one entry), long
+ * strings (param values, objects) are referenced in place, so they must
+ * be kept unchanged until the message is sent.
+ *
+ * Errors are sticky: after the first failure the emitter ignores all
+ * output and keeps the failure status.
+ *
+ * Emitter initialized without iovec array only counts the length of the
+ * message: it never fails and stores nothing. Emitter with one iovec
+ * entry copies the whole message to the scratch buffer contiguously.
+ */
+
+#ifndef MMX_BACKAPI_EMIT_H_
+#define MMX_BACKAPI_EMIT_H_
+
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include "mmx-backapi.h"
+
+/* Strings shorter than this are copied: an iovec entry costs more than
+   copying a few bytes */
+#define MMXBA_EMIT_REF_MIN      64
+
+typedef struct mmxba_emitter_s {
+    struct iovec  *iov;
+    unsigned int  iov_max;
+    unsigned int  iov_num;      /* used entries */
+
+    char          *scratch;
+    size_t        scratch_size;
+    size_t        scratch_len;
+
+    size_t        total;        /* length of the emitted message */
+    int           status;       /* MMXBA_OK or the first failure */
+} mmxba_emitter_t;
+
+
+/*
+ * Initializes the emitter over the caller iovec array and scratch buffer.
+ * If iov is NULL the emitter only counts the message length in total.
+ */
+void mmx_backapi_emit_init(mmxba_emitter_t *e, struct iovec *iov, unsigned int iov_max,
+                           char *scratch, size_t scratch_size);
+
+/*
+ * Copies len bytes of markup to the scratch buffer
+ */
+int mmx_backapi_emit_raw(mmxba_emitter_t *e, const char *s, size_t len);
+
+/*
+ * Adds len bytes of markup: long strings are referenced, short ones are
+ * copied. Falls back to copying when the iovec array is nearly full.
+ */
+int mmx_backapi_emit_ref(mmxba_emitter_t *e, const char *s, size_t len);
+
+/*
+ * Adds text with the xml special characters escaped; the unescaped runs
+ * are added by mmx_backapi_emit_ref()
+ */
+int mmx_backapi_emit_text(mmxba_emitter_t *e, const char *s);
+
+/*
+ * Adds decimal representation of the number
+ */
+int mmx_backapi_emit_uint(mmxba_emitter_t *e, uint64_t val);
+int mmx_backapi_emit_int(mmxba_emitter_t *e, int64_t val);
+
+/*
+ * Adds start tag "<tag" of the element: attributes may follow, the tag
+ * is closed by mmx_backapi_emit_start_end()
+ */
+int mmx_backapi_emit_start(mmxba_emitter_t *e, const char *tag);
+
+/*
+ * Adds attribute ` name="value"' to the started tag
+ */
+int mmx_backapi_emit_attr(mmxba_emitter_t *e, const char *name, const char *value);
+int mmx_backapi_emit_attr_uint(mmxba_emitter_t *e, const char *name, uint64_t val);
+
+/*
+ * Closes the started tag by ">"
+ */
+int mmx_backapi_emit_start_end(mmxba_emitter_t *e);
+
+/*
+ * Adds "<tag>" and "</tag>"
+ */
+int mmx_backapi_emit_open(mmxba_emitter_t *e, const char *tag);
+int mmx_backapi_emit_close(mmxba_emitter_t *e, const char *tag);
+
+/*
+ * Adds element with escaped text or number: <tag>text</tag>
+ */
+int mmx_backapi_emit_elem_text(mmxba_emitter_t *e, const char *tag, const char *text);
+int mmx_backapi_emit_elem_uint(mmxba_emitter_t *e, const char *tag, uint64_t val);
+int mmx_backapi_emit_elem_int(mmxba_emitter_t *e, const char *tag, int64_t val);
+
+#endif /* MMX_BACKAPI_EMIT_H_ */
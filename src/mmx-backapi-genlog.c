@@ -0,0 +1,197 @@
+/* mmx-backapi-genlog.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Backend change log for incremental GETALL responses.
+ */
+
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-genlog.h"
+
+
+/* ------------------------------------------------------------------- */
+/*  -----------  MMX change log internal functions    -----------------*/
+/* ------------------------------------------------------------------- */
+
+static int delta_has_object(const mmxba_request_t *req, const char *obj)
+{
+    uint32_t i;
+
+    for (i = 0; i < req->getAll.objNum; i++)
+        if (!strcmp(req->getAll.objects[i], obj))
+            return TRUE;
+
+    return FALSE;
+}
+
+
+/* ------------------------------------------------------------------- */
+/*  ----------------  MMX change log API functions    -----------------*/
+/* ------------------------------------------------------------------- */
+int mmx_backapi_genlog_init(mmxba_genlog_t *log, unsigned int size)
+{
+    int status = MMXBA_OK;
+
+    if (log == NULL || size == 0 || (size & (size - 1)))
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    memset(log, 0, sizeof(*log));
+    if ((log->recs = calloc(size, sizeof(mmxba_genlog_rec_t))) == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "%s: Could not allocate log", __func__);
+
+    log->size = size;
+    log->generation = (uint32_t)mmx_backapi_time_ms();
+    if (log->generation == 0)
+        log->generation = 1;
+
+ret:
+    return status;
+}
+
+int mmx_backapi_genlog_destroy(mmxba_genlog_t *log)
+{
+    if (log == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    free(log->recs);
+    memset(log, 0, sizeof(*log));
+
+    return MMXBA_OK;
+}
+
+uint32_t mmx_backapi_genlog_record(mmxba_genlog_t *log, const char *objKeyValues,
+                                   int removed)
+{
+    mmxba_genlog_rec_t *rec;
+
+    /* Generation 0 means "none" in the requests */
+    if (++log->generation == 0)
+        log->generation = 1;
+
+    rec = &log->recs[log->generation & (log->size - 1)];
+    rec->generation = log->generation;
+    rec->removed = removed ? TRUE : FALSE;
+    strcpy_safe(rec->obj, objKeyValues, sizeof(rec->obj));
+
+    if (log->count < log->size)
+        log->count++;
+
+    return log->generation;
+}
+
+int mmx_backapi_genlog_fill(mmxba_genlog_t *log, mmxba_request_t *req)
+{
+    uint32_t since, changes, gen, n;
+    mmxba_genlog_rec_t *rec;
+
+    if (log == NULL || req == NULL || req->op_type != MMXBA_OP_TYPE_GETALL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    since = req->getAll.generation;
+    changes = log->generation - since;
+
+    req->getAll.generation = log->generation;
+    req->getAll.isDelta = FALSE;
+
+    /* Unknown or too old generation (or one of the previous backend run) */
+    if (since == 0 || changes > log->count)
+        return MMXBA_OK;
+
+    /* The newest change of each object wins */
+    req->getAll.objNum = 0;
+    for (gen = log->generation, n = 0; n < changes; gen--, n++)
+    {
+        if (gen == 0)
+            gen--;
+        rec = &log->recs[gen & (log->size - 1)];
+        if (rec->generation != gen)
+            break;
+        if (delta_has_object(req, rec->obj))
+            continue;
+
+        if (req->getAll.objNum == MMXBA_MAX_NUMBER_OF_GETALL_PARAMS)
+        {
+            req->getAll.objNum = 0;
+            return MMXBA_OK;
+        }
+
+        strcpy_safe(req->getAll.objects[req->getAll.objNum], rec->obj, MMXBA_MAX_STR_LEN);
+        req->getAll.objRemoved[req->getAll.objNum] = rec->removed;
+        req->getAll.objNum++;
+    }
+
+    if (n < changes)
+    {
+        req->getAll.objNum = 0;
+        return MMXBA_OK;
+    }
+
+    req->getAll.isDelta = TRUE;
+
+    return MMXBA_OK;
+}
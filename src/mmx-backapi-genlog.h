@@ -0,0 +1,122 @@
+/* mmx-backapi-genlog.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+/*
+ * Backend change log of the objects table used to answer incremental
+ * GETALL requests.
+ *
+ * The backend records every added or removed object; each record gets the
+ * next generation number of the table. A GETALL request carrying the
+ * generation seen by the EP is answered with the objects changed since
+ * then if the log still covers it, otherwise the backend sends a full
+ * snapshot. The initial generation is taken from the monotonic clock, so
+ * generations seen before a backend restart are not mistaken for the
+ * current ones.
+ */
+
+#ifndef MMX_BACKAPI_GENLOG_H_
+#define MMX_BACKAPI_GENLOG_H_
+
+#include "mmx-backapi.h"
+
+typedef struct mmxba_genlog_rec_s {
+    uint32_t generation;
+    uint8_t  removed;
+    char     obj[MMXBA_MAX_STR_LEN];   /* objKeyValues of the object */
+} mmxba_genlog_rec_t;
+
+typedef struct mmxba_genlog_s {
+    uint32_t            generation;  /* current generation */
+    unsigned int        size;        /* records number, power of 2 */
+    unsigned int        count;       /* stored records */
+    mmxba_genlog_rec_t  *recs;
+} mmxba_genlog_t;
+
+
+/*
+ * Initializes change log keeping the last size (power of 2) changes
+ */
+int mmx_backapi_genlog_init(mmxba_genlog_t *log, unsigned int size);
+
+int mmx_backapi_genlog_destroy(mmxba_genlog_t *log);
+
+/*
+ * Records added (removed = FALSE) or removed object.
+ * Returns the new generation of the table
+ */
+uint32_t mmx_backapi_genlog_record(mmxba_genlog_t *log, const char *objKeyValues,
+                                   int removed);
+
+/*
+ * Fills GETALL response from the change log. If the requested generation
+ * is covered by the log, the objects changed since it are set and
+ * getAll.isDelta is set to TRUE; otherwise isDelta is FALSE and the caller
+ * must fill the full snapshot. getAll.generation is set to the current one.
+ */
+int mmx_backapi_genlog_fill(mmxba_genlog_t *log, mmxba_request_t *req);
+
+#endif /* MMX_BACKAPI_GENLOG_H_ */
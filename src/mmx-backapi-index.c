@@ -0,0 +1,239 @@
+/* mmx-backapi-index.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Hash index of param names of parsed messages.
+ */
+
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-index.h"
+
+#define INDEX_HASH_SEED     0
+#define INDEX_NO_NAME       0xffff
+
+/* Index kept in the message memory pool: hashes of the names and
+   open addressing table of their positions */
+typedef struct mmxba_name_index_s {
+    uint8_t   names;        /* TRUE - paramNames, FALSE - param values */
+    uint16_t  num;
+    uint16_t  mask;
+    uint32_t  *hashes;
+    uint16_t  *slots;
+} mmxba_name_index_t;
+
+
+/* ------------------------------------------------------------------- */
+/*  -----------  MMX names index internal functions   -----------------*/
+/* ------------------------------------------------------------------- */
+
+/* Returns the indexed param values array of the message and its size */
+static nvpair_t *message_values(const mmxba_request_t *req, uint32_t *num)
+{
+    if (req->op_type == MMXBA_OP_TYPE_ADDOBJ)
+    {
+        *num = req->addObj_req.paramNum;
+        return (nvpair_t *)req->addObj_req.paramValues;
+    }
+
+    *num = req->paramValues.arraySize;
+    return (nvpair_t *)req->paramValues.paramValues;
+}
+
+static const char *name_at(const mmxba_request_t *req, int names, uint32_t i)
+{
+    uint32_t num;
+
+    return names ? req->paramNames.paramNames[i] : message_values(req, &num)[i].name;
+}
+
+/* Returns position of the name, or -1 */
+static int find(const mmxba_request_t *req, int names, const char *name, uint32_t hash)
+{
+    const mmxba_name_index_t *index = req->nameIndex;
+    uint32_t i, num;
+
+    if (name == NULL)
+        return -1;
+
+    if (index && index->names == names)
+    {
+        for (i = hash & index->mask; index->slots[i] != INDEX_NO_NAME; i = (i + 1) & index->mask)
+            if (index->hashes[index->slots[i]] == hash &&
+                !strcmp(name_at(req, names, index->slots[i]), name))
+                return index->slots[i];
+
+        return -1;
+    }
+
+    /* No index: scan the names */
+    if (names)
+        num = req->paramNames.arraySize;
+    else
+        message_values(req, &num);
+
+    for (i = 0; i < num; i++)
+        if (!strcmp(name_at(req, names, i), name))
+            return i;
+
+    return -1;
+}
+
+
+/* ------------------------------------------------------------------- */
+/*  ----------------  MMX names index API functions   -----------------*/
+/* ------------------------------------------------------------------- */
+uint32_t mmx_backapi_name_hash(const char *name)
+{
+    return mmx_backapi_strhash(name, INDEX_HASH_SEED);
+}
+
+int mmx_backapi_msgstruct_index(mmxba_request_t *req, int names)
+{
+    mmxba_name_index_t *index;
+    uint32_t i, j, num, size = 1;
+    uint16_t savedOffset;
+
+    if (req == NULL || !req->mem_pool.initialized)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    req->nameIndex = NULL;
+
+    if (names)
+        num = req->paramNames.arraySize;
+    else
+        message_values(req, &num);
+
+    /* The table is kept at most half full */
+    while (size < 2 * num)
+        size <<= 1;
+
+    savedOffset = req->mem_pool.curr_offset;
+    if ((index = mmxba_pool_alloc(req, sizeof(*index))) == NULL ||
+        (index->hashes = mmxba_pool_alloc(req, num * sizeof(uint32_t))) == NULL ||
+        (index->slots = mmxba_pool_alloc(req, size * sizeof(uint16_t))) == NULL)
+    {
+        req->mem_pool.curr_offset = savedOffset;
+        ing_log(LOG_DEBUG, "No space in back-api req pool for names index\n");
+        return MMXBA_NOT_ENOUGH_MEMORY;
+    }
+
+    index->names = names ? TRUE : FALSE;
+    index->num = num;
+    index->mask = size - 1;
+    memset(index->slots, 0xff, size * sizeof(uint16_t));
+
+    for (i = 0; i < num; i++)
+    {
+        index->hashes[i] = mmx_backapi_name_hash(name_at(req, names, i));
+        for (j = index->hashes[i] & index->mask; index->slots[j] != INDEX_NO_NAME;
+             j = (j + 1) & index->mask)
+            ;
+        index->slots[j] = i;
+    }
+
+    req->nameIndex = index;
+
+    return MMXBA_OK;
+}
+
+int mmx_backapi_msgstruct_find_name(const mmxba_request_t *req, const char *name)
+{
+    if (req == NULL || name == NULL)
+        return -1;
+
+    return find(req, TRUE, name, mmx_backapi_name_hash(name));
+}
+
+int mmx_backapi_msgstruct_find_name_hash(const mmxba_request_t *req, const char *name,
+                                         uint32_t hash)
+{
+    if (req == NULL)
+        return -1;
+
+    return find(req, TRUE, name, hash);
+}
+
+nvpair_t *mmx_backapi_msgstruct_find_value(const mmxba_request_t *req, const char *name)
+{
+    if (req == NULL || name == NULL)
+        return NULL;
+
+    return mmx_backapi_msgstruct_find_value_hash(req, name, mmx_backapi_name_hash(name));
+}
+
+nvpair_t *mmx_backapi_msgstruct_find_value_hash(const mmxba_request_t *req,
+                                                const char *name, uint32_t hash)
+{
+    uint32_t num;
+    int i;
+
+    if (req == NULL || (i = find(req, FALSE, name, hash)) < 0)
+        return NULL;
+
+    return &message_values(req, &num)[i];
+}
@@ -0,0 +1,121 @@
+/* mmx-backapi-index.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Hash index of param names of parsed messages.
+ *
+ * If MMXBA_PARSE_FLAG_INDEX is set in parseFlags of the message before
+ * parsing, the parser builds a small open addressing index of the param
+ * names (of paramNames in GET and SUBSCRIBE requests, or of the param
+ * values of GET response, SET and ADDOBJ requests and NOTIFY) in the
+ * message memory pool. The index is not built if the pool has no space
+ * for it; the lookup functions scan the names in this case.
+ *
+ * Handlers can precompute hashes of the names they check by
+ * mmx_backapi_name_hash() and use the _hash lookup variants.
+ *
+ * The index is valid until names of the message are changed; it is
+ * dropped by mmx_backapi_msgstruct_init().
+ */
+
+#ifndef MMX_BACKAPI_INDEX_H_
+#define MMX_BACKAPI_INDEX_H_
+
+#include <stdint.h>
+
+#include "mmx-backapi.h"
+
+/*
+ * Returns hash of the param name used by the index
+ */
+uint32_t mmx_backapi_name_hash(const char *name);
+
+/*
+ * Builds index of paramNames (names is TRUE) or of param values of the
+ * message in its memory pool; called by the parser
+ */
+int mmx_backapi_msgstruct_index(mmxba_request_t *req, int names);
+
+/*
+ * Returns index of the name in paramNames, or -1
+ */
+int mmx_backapi_msgstruct_find_name(const mmxba_request_t *req, const char *name);
+
+int mmx_backapi_msgstruct_find_name_hash(const mmxba_request_t *req, const char *name,
+                                         uint32_t hash);
+
+/*
+ * Returns name-value pair of the name in param values (addObj_req
+ * param values in ADDOBJ request), or NULL
+ */
+nvpair_t *mmx_backapi_msgstruct_find_value(const mmxba_request_t *req, const char *name);
+
+nvpair_t *mmx_backapi_msgstruct_find_value_hash(const mmxba_request_t *req,
+                                                const char *name, uint32_t hash);
+
+#endif /* MMX_BACKAPI_INDEX_H_ */
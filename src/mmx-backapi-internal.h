@@ -0,0 +1,165 @@
+/* mmx-backapi-internal.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+/*
+ * Internal definitions shared by the translation units of the library.
+ * This header is not installed and must not be included by applications.
+ */
+
+#ifndef MMX_BACKAPI_INTERNAL_H_
+#define MMX_BACKAPI_INTERNAL_H_
+
+#include "mmx-backapi.h"
+
+#define GOTO_RET_WITH_ERROR(err_num, msg, ...)     do { \
+    ing_log(LOG_ERR, msg"\n", ##__VA_ARGS__); \
+    status = err_num; \
+    goto ret; \
+} while (0)
+
+/*
+ * Message schema: sections of the message body (after the common header)
+ * used by each operation in the request (or notification) and in the
+ * response. The builders, the parser and the push parser are driven by
+ * the table, so a new operation or field is described here once.
+ *
+ * Bits of the sections are ordered as the sections follow each other in
+ * the messages: the builders emit the sections from the lowest bit.
+ */
+#define MMXBA_SEC_MMXINSTANCE   0x0001  /* mmxInstances                         */
+#define MMXBA_SEC_SUBSCRID      0x0002  /* subscrId                             */
+#define MMXBA_SEC_BEKEYPARAMS   0x0004  /* beKeyParams                          */
+#define MMXBA_SEC_KEYFILTER     0x0008  /* beKeyParams, optional filter         */
+#define MMXBA_SEC_NAMEFILTER    0x0010  /* paramNames, optional filter          */
+#define MMXBA_SEC_PARAMVALUES   0x0020  /* paramValues, optional when parsing   */
+#define MMXBA_SEC_CHANGES       0x0040  /* paramValues, required                */
+#define MMXBA_SEC_BEKEYNAMES    0x0080  /* beKeyNames of getAll or addObj       */
+#define MMXBA_SEC_QUERY         0x0100  /* generation and objEnc of getAll      */
+#define MMXBA_SEC_PARAMNAMES    0x0200  /* paramNames, optional when parsing    */
+#define MMXBA_SEC_NEWVALUES     0x0400  /* addObj_req.paramValues, optional     */
+#define MMXBA_SEC_OBJECTS       0x0800  /* objects of getAll (and generation)   */
+                                        /* or of addObj_resp, optional          */
+
+/* Sections the parsers fail without */
+#define MMXBA_SEC_REQUIRED      (MMXBA_SEC_MMXINSTANCE | MMXBA_SEC_SUBSCRID | \
+                                 MMXBA_SEC_BEKEYPARAMS | MMXBA_SEC_CHANGES | \
+                                 MMXBA_SEC_BEKEYNAMES)
+
+#define SEC_(name)  MMXBA_SEC_##name
+
+/*  X(op, request or notification sections, response sections) */
+#define MMXBA_SCHEMA(X) \
+    X(GET,          SEC_(MMXINSTANCE) | SEC_(BEKEYPARAMS) | SEC_(PARAMNAMES), \
+                    SEC_(MMXINSTANCE) | SEC_(BEKEYPARAMS) | SEC_(PARAMVALUES)) \
+    X(SET,          SEC_(MMXINSTANCE) | SEC_(BEKEYPARAMS) | SEC_(PARAMVALUES), \
+                    SEC_(MMXINSTANCE) | SEC_(BEKEYPARAMS)) \
+    X(GETALL,       SEC_(BEKEYNAMES) | SEC_(QUERY), \
+                    SEC_(BEKEYNAMES) | SEC_(OBJECTS)) \
+    X(ADDOBJ,       SEC_(MMXINSTANCE) | SEC_(BEKEYPARAMS) | SEC_(BEKEYNAMES) | SEC_(NEWVALUES), \
+                    SEC_(MMXINSTANCE) | SEC_(BEKEYPARAMS) | SEC_(BEKEYNAMES) | SEC_(OBJECTS)) \
+    X(DELOBJ,       SEC_(MMXINSTANCE) | SEC_(BEKEYPARAMS), \
+                    SEC_(MMXINSTANCE) | SEC_(BEKEYPARAMS)) \
+    X(SUBSCRIBE,    SEC_(SUBSCRID) | SEC_(KEYFILTER) | SEC_(NAMEFILTER), \
+                    SEC_(SUBSCRID)) \
+    X(UNSUBSCRIBE,  SEC_(SUBSCRID), \
+                    SEC_(SUBSCRID)) \
+    X(NOTIFY,       SEC_(SUBSCRID) | SEC_(BEKEYPARAMS) | SEC_(CHANGES), \
+                    0)
+
+typedef struct mmxba_schema_s {
+    const char  *opName;
+    uint32_t    sections[2];    /* of the response and of the request */
+} mmxba_schema_t;
+
+/* Returns sections of the message of the operation (0 - unknown one) */
+uint32_t mmxba_schema_sections(int op_type, int isRequest);
+
+/* Dictionary used to resolve param names of the parsed message */
+typedef struct msg_names_s {
+    const struct mmxba_dict_s  *dict;
+    int                        sameDict;   /* the message is built with dict */
+} msg_names_t;
+
+/* Parsing helpers of mmx-backapi.c shared with the push parser */
+mmxba_op_type_t mmxba_optype2num(const char *str);
+void mmxba_names_init(msg_names_t *names, const char *dictAttr);
+int  mmxba_resolve_name(const msg_names_t *names, const char *idStr,
+                        const char **name, uint16_t *id);
+int  mmxba_front_expand(char *obj, const char *prev, const char *prefix_str);
+void mmxba_object_split_keys(const char *obj, mmxba_key_ref_t *refs, uint32_t keyNum);
+void mmxba_message_finish(mmxba_request_t *req, int isRequest);
+
+/* Aligned allocation in the message pool (names index, transfers) */
+void *mmxba_pool_alloc(mmxba_request_t *req, size_t size);
+
+/* Base64 coding of mmx-backapi-value.c shared with chunked transfers */
+#define MMXBA_BASE64_LEN(len)   (((len) + 2) / 3 * 4)
+
+size_t mmxba_base64_encode(const void *data, size_t len, char *out);
+int    mmxba_base64_decode(const char *s, size_t slen, void *data, size_t *len);
+
+#endif /* MMX_BACKAPI_INTERNAL_H_ */
@@ -0,0 +1,619 @@
+/* mmx-backapi-notify.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Backend change notifications with coalescing window.
+ */
+
+#include <limits.h>
+
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-notify.h"
+
+
+/* ------------------------------------------------------------------- */
+/*  -----------  MMX notifications internal functions -----------------*/
+/* ------------------------------------------------------------------- */
+
+static uint32_t instance_hash(const char *beObjName, const nvpair_t *keys, uint32_t keyNum)
+{
+    uint32_t i, h = mmx_backapi_strhash(beObjName, 0);
+
+    for (i = 0; i < keyNum; i++)
+    {
+        h = mmx_backapi_strhash(keys[i].name, h);
+        h = mmx_backapi_strhash(keys[i].pValue ? keys[i].pValue : "", h);
+    }
+
+    return h;
+}
+
+static const char *key_value(const nvpair_t *keys, uint32_t keyNum, const char *name)
+{
+    uint32_t i;
+
+    for (i = 0; i < keyNum; i++)
+        if (!strcmp(keys[i].name, name))
+            return keys[i].pValue ? keys[i].pValue : "";
+
+    return NULL;
+}
+
+static int subscr_match(const mmxba_subscr_t *sub, const nvpair_t *keys, uint32_t keyNum,
+                        const char *name)
+{
+    const char *value;
+    uint32_t i;
+
+    for (i = 0; i < sub->keyNum; i++)
+        if ((value = key_value(keys, keyNum, sub->keyNames[i])) == NULL ||
+            strcmp(value, sub->keyValues[i]))
+            return FALSE;
+
+    if (sub->paramNum == 0)
+        return TRUE;
+
+    for (i = 0; i < sub->paramNum; i++)
+        if (!strcmp(sub->paramNames[i], name))
+            return TRUE;
+
+    return FALSE;
+}
+
+/* Copies string to the notification data; returns its offset or -1 */
+static int notif_append(mmxba_notif_t *e, const char *str)
+{
+    size_t len = strlen(str) + 1;
+    int offset = e->used;
+
+    if (e->used + len > sizeof(e->data))
+        return -1;
+
+    memcpy(e->data + e->used, str, len);
+    e->used += len;
+
+    return offset;
+}
+
+static int notif_same_instance(const mmxba_notif_t *e, const nvpair_t *keys, uint32_t keyNum)
+{
+    uint32_t i;
+
+    if (e->keyNum != keyNum)
+        return FALSE;
+
+    for (i = 0; i < keyNum; i++)
+        if (strcmp(e->data + e->keys[i][0], keys[i].name) ||
+            strcmp(e->data + e->keys[i][1], keys[i].pValue ? keys[i].pValue : ""))
+            return FALSE;
+
+    return TRUE;
+}
+
+/* Starts notification of the object instance */
+static int notif_start(mmxba_notifier_t *n, mmxba_notif_t *e, int subscr, uint32_t hash,
+                       const nvpair_t *keys, uint32_t keyNum)
+{
+    int name, value;
+    uint32_t i;
+
+    e->subscr = subscr;
+    e->hash = hash;
+    e->send_ms = mmx_backapi_time_ms() + n->window_ms;
+    e->keyNum = 0;
+    e->valNum = 0;
+    e->used = 0;
+
+    for (i = 0; i < keyNum; i++)
+    {
+        if ((name = notif_append(e, keys[i].name)) < 0 ||
+            (value = notif_append(e, keys[i].pValue ? keys[i].pValue : "")) < 0)
+        {
+            e->subscr = -1;
+            return MMXBA_NOT_ENOUGH_MEMORY;
+        }
+        e->keys[i][0] = name;
+        e->keys[i][1] = value;
+        e->keyNum++;
+    }
+
+    return MMXBA_OK;
+}
+
+/* Sets the last value of the parameter in the notification */
+static int notif_set(mmxba_notif_t *e, const char *name, const char *value)
+{
+    int name_off = -1, value_off;
+    uint32_t i;
+
+    for (i = 0; i < e->valNum; i++)
+        if (!strcmp(e->data + e->vals[i][0], name))
+        {
+            name_off = e->vals[i][0];
+            break;
+        }
+
+    if (name_off < 0 && e->valNum == MMXBA_MAX_NUMBER_OF_SET_PARAMS)
+        return MMXBA_NOT_ENOUGH_MEMORY;
+
+    /* The replaced value stays in data until the notification is sent */
+    if (name_off < 0 && (name_off = notif_append(e, name)) < 0)
+        return MMXBA_NOT_ENOUGH_MEMORY;
+    if ((value_off = notif_append(e, value)) < 0)
+        return MMXBA_NOT_ENOUGH_MEMORY;
+
+    if (i == e->valNum)
+        e->valNum++;
+    e->vals[i][0] = name_off;
+    e->vals[i][1] = value_off;
+
+    return MMXBA_OK;
+}
+
+/* Adds built message to the send queue; the messages are kept one after
+   another with their terminating zeros */
+static int outq_append(mmxba_notifier_t *n, const char *xml)
+{
+    size_t len = strlen(xml) + 1;
+    size_t size = n->outq_size ? n->outq_size : MMXBA_MAX_MSG_SIZE;
+    char *q;
+
+    while (size < n->outq_len + len)
+        size <<= 1;
+
+    if (size > n->outq_size)
+    {
+        if ((q = realloc(n->outq, size)) == NULL)
+        {
+            ing_log(LOG_ERR, "Could not queue notification of %zu bytes\n", len);
+            return MMXBA_NOT_ENOUGH_MEMORY;
+        }
+        n->outq = q;
+        n->outq_size = size;
+    }
+
+    memcpy(n->outq + n->outq_len, xml, len);
+    n->outq_len += len;
+
+    return MMXBA_OK;
+}
+
+static int notif_send(mmxba_notifier_t *n, mmxba_notif_t *e)
+{
+    int status;
+    uint32_t i;
+    mmxba_request_t *msg = n->msg;
+    mmxba_subscr_t *sub = &n->subscrs[e->subscr];
+
+    msg->op_type = MMXBA_OP_TYPE_NOTIFY;
+    msg->opSeqNum = n->seq;
+    n->seq = (n->seq == INT_MAX) ? 0 : n->seq + 1;
+    strcpy_safe(msg->beObjName, sub->beObjName, sizeof(msg->beObjName));
+    msg->subscrId = sub->subscrId;
+
+    msg->beKeyParamsNum = e->keyNum;
+    for (i = 0; i < e->keyNum; i++)
+    {
+        strcpy_safe(msg->beKeyParams[i].name, e->data + e->keys[i][0],
+                    sizeof(msg->beKeyParams[i].name));
+        msg->beKeyParams[i].pValue = e->data + e->keys[i][1];
+    }
+
+    msg->paramValues.arraySize = e->valNum;
+    for (i = 0; i < e->valNum; i++)
+    {
+        strcpy_safe(msg->paramValues.paramValues[i].name, e->data + e->vals[i][0],
+                    sizeof(msg->paramValues.paramValues[i].name));
+        msg->paramValues.paramValues[i].pValue = e->data + e->vals[i][1];
+    }
+
+    e->subscr = -1;
+
+    if ((status = mmx_backapi_notify_build(msg, n->xml, MMXBA_MAX_MSG_SIZE)) != MMXBA_OK)
+        return status;
+
+    if ((status = outq_append(n, n->xml)) != MMXBA_OK)
+        return status;
+
+    n->sent++;
+    return MMXBA_OK;
+}
+
+/* Releases the lock and sends the queued messages. The send callback is
+   called without the lock, so it may report changes and flush; the
+   messages queued meanwhile are sent by the thread already sending, so
+   they are sent in order and the callback is never entered twice */
+static void notify_unlock(mmxba_notifier_t *n)
+{
+    char *q;
+    size_t size, len, off, msg_len;
+
+    if (n->sending)
+    {
+        pthread_mutex_unlock(&n->lock);
+        return;
+    }
+
+    n->sending = TRUE;
+    while (n->outq_len > 0)
+    {
+        q = n->outq;
+        size = n->outq_size;
+        len = n->outq_len;
+        n->outq = NULL;
+        n->outq_size = n->outq_len = 0;
+        pthread_mutex_unlock(&n->lock);
+
+        for (off = 0; off < len; off += msg_len + 1)
+        {
+            msg_len = strlen(q + off);
+            n->send(n->send_ctx, q + off, msg_len);
+        }
+
+        pthread_mutex_lock(&n->lock);
+
+        /* Keep the buffer for the next messages */
+        if (n->outq == NULL)
+        {
+            n->outq = q;
+            n->outq_size = size;
+        }
+        else
+            free(q);
+    }
+    n->sending = FALSE;
+
+    pthread_mutex_unlock(&n->lock);
+}
+
+/* Drops pending notifications of the subscription */
+static void notif_drop(mmxba_notifier_t *n, int subscr)
+{
+    unsigned int i;
+
+    for (i = 0; i < n->notif_num; i++)
+        if (n->notifs[i].subscr == subscr)
+            n->notifs[i].subscr = -1;
+}
+
+/* Returns notification entry of the object instance; if all entries are
+   busy, the one with the nearest send time is sent to free it */
+static mmxba_notif_t *notif_get(mmxba_notifier_t *n, int subscr, uint32_t hash,
+                                const nvpair_t *keys, uint32_t keyNum)
+{
+    mmxba_notif_t *e, *free_e = NULL, *oldest = NULL;
+    unsigned int i;
+
+    for (i = 0; i < n->notif_num; i++)
+    {
+        e = &n->notifs[i];
+        if (e->subscr < 0)
+        {
+            if (!free_e)
+                free_e = e;
+            continue;
+        }
+        if (e->subscr == subscr && e->hash == hash && notif_same_instance(e, keys, keyNum))
+            return e;
+        if (!oldest || e->send_ms < oldest->send_ms)
+            oldest = e;
+    }
+
+    if (!free_e)
+    {
+        notif_send(n, oldest);
+        free_e = oldest;
+    }
+
+    if (notif_start(n, free_e, subscr, hash, keys, keyNum) != MMXBA_OK)
+        return NULL;
+
+    return free_e;
+}
+
+
+/* ------------------------------------------------------------------- */
+/*  ----------------  MMX notifications API functions -----------------*/
+/* ------------------------------------------------------------------- */
+int mmx_backapi_notify_init(mmxba_notifier_t *n, unsigned int subscr_num,
+                            unsigned int notif_num, unsigned int window_ms,
+                            mmxba_notify_send_t send, void *send_ctx)
+{
+    int status = MMXBA_OK;
+    unsigned int i;
+
+    if (n == NULL || subscr_num == 0 || notif_num == 0 || send == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    memset(n, 0, sizeof(*n));
+    n->subscrs = calloc(subscr_num, sizeof(mmxba_subscr_t));
+    n->notifs = calloc(notif_num, sizeof(mmxba_notif_t));
+    n->msg = calloc(1, sizeof(mmxba_request_t));
+    n->xml = malloc(MMXBA_MAX_MSG_SIZE);
+    if (!n->subscrs || !n->notifs || !n->msg || !n->xml)
+    {
+        free(n->subscrs);
+        free(n->notifs);
+        free(n->msg);
+        free(n->xml);
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "%s: Could not allocate notifier", __func__);
+    }
+
+    for (i = 0; i < notif_num; i++)
+        n->notifs[i].subscr = -1;
+
+    pthread_mutex_init(&n->lock, NULL);
+    n->subscr_num = subscr_num;
+    n->notif_num = notif_num;
+    n->window_ms = window_ms;
+    n->send = send;
+    n->send_ctx = send_ctx;
+
+ret:
+    return status;
+}
+
+int mmx_backapi_notify_destroy(mmxba_notifier_t *n)
+{
+    if (n == NULL || n->subscrs == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    pthread_mutex_destroy(&n->lock);
+    free(n->subscrs);
+    free(n->notifs);
+    free(n->msg);
+    free(n->xml);
+    free(n->outq);
+    memset(n, 0, sizeof(*n));
+
+    return MMXBA_OK;
+}
+
+int mmx_backapi_notify_subscribe(mmxba_notifier_t *n, const mmxba_request_t *req)
+{
+    int status = MMXBA_OK;
+    int idx = -1;
+    unsigned int i;
+    mmxba_subscr_t *sub;
+
+    if (n == NULL || req == NULL || req->subscrId == 0 ||
+        req->beKeyParamsNum > MMXBA_MAX_NUMBER_OF_KEY_PARAMS ||
+        req->paramNames.arraySize > MMXBA_MAX_NUMBER_OF_GET_PARAMS)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    pthread_mutex_lock(&n->lock);
+
+    for (i = 0; i < n->subscr_num; i++)
+    {
+        if (n->subscrs[i].subscrId == req->subscrId)
+        {
+            idx = i;
+            notif_drop(n, idx);
+            break;
+        }
+        if (idx < 0 && n->subscrs[i].subscrId == 0)
+            idx = i;
+    }
+
+    if (idx < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Too many subscriptions");
+
+    sub = &n->subscrs[idx];
+    sub->subscrId = req->subscrId;
+    strcpy_safe(sub->beObjName, req->beObjName, sizeof(sub->beObjName));
+    sub->objHash = mmx_backapi_strhash(sub->beObjName, 0);
+
+    sub->keyNum = req->beKeyParamsNum;
+    for (i = 0; i < sub->keyNum; i++)
+    {
+        strcpy_safe(sub->keyNames[i], req->beKeyParams[i].name, MMXBA_MAX_STR_LEN);
+        strcpy_safe(sub->keyValues[i], req->beKeyParams[i].pValue ?
+                    req->beKeyParams[i].pValue : "", MMXBA_MAX_STR_LEN);
+    }
+
+    sub->paramNum = req->paramNames.arraySize;
+    for (i = 0; i < sub->paramNum; i++)
+        strcpy_safe(sub->paramNames[i], req->paramNames.paramNames[i], MMXBA_MAX_STR_LEN);
+
+ret:
+    pthread_mutex_unlock(&n->lock);
+    return status;
+}
+
+int mmx_backapi_notify_unsubscribe(mmxba_notifier_t *n, uint32_t subscrId)
+{
+    int status = MMXBA_GENERAL_ERROR;
+    unsigned int i;
+
+    if (n == NULL || subscrId == 0)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    pthread_mutex_lock(&n->lock);
+    for (i = 0; i < n->subscr_num; i++)
+        if (n->subscrs[i].subscrId == subscrId)
+        {
+            notif_drop(n, i);
+            n->subscrs[i].subscrId = 0;
+            status = MMXBA_OK;
+            break;
+        }
+    pthread_mutex_unlock(&n->lock);
+
+    return status;
+}
+
+int mmx_backapi_notify_handler(mmxba_request_t *req, void *ctx)
+{
+    mmxba_notifier_t *n = (mmxba_notifier_t *)ctx;
+
+    if (req->op_type == MMXBA_OP_TYPE_SUBSCRIBE)
+        return mmx_backapi_notify_subscribe(n, req);
+    else if (req->op_type == MMXBA_OP_TYPE_UNSUBSCRIBE)
+        return mmx_backapi_notify_unsubscribe(n, req->subscrId);
+
+    return MMXBA_BAD_INPUT_PARAMS;
+}
+
+int mmx_backapi_notify_changed(mmxba_notifier_t *n, const char *beObjName,
+                               const nvpair_t *keys, uint32_t keyNum,
+                               const char *name, const char *value)
+{
+    int status = MMXBA_OK;
+    uint32_t obj_hash, hash = 0;
+    unsigned int i;
+    mmxba_subscr_t *sub;
+    mmxba_notif_t *e;
+
+    if (n == NULL || beObjName == NULL || name == NULL ||
+        keyNum > MMXBA_MAX_NUMBER_OF_KEY_PARAMS || (keyNum && keys == NULL))
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    obj_hash = mmx_backapi_strhash(beObjName, 0);
+
+    pthread_mutex_lock(&n->lock);
+
+    for (i = 0; i < n->subscr_num; i++)
+    {
+        sub = &n->subscrs[i];
+        if (sub->subscrId == 0 || sub->objHash != obj_hash ||
+            strcmp(sub->beObjName, beObjName) || !subscr_match(sub, keys, keyNum, name))
+            continue;
+
+        if (hash == 0)
+            hash = instance_hash(beObjName, keys, keyNum);
+
+        if ((e = notif_get(n, i, hash, keys, keyNum)) == NULL)
+        {
+            status = MMXBA_NOT_ENOUGH_MEMORY;
+            continue;
+        }
+
+        if (e->valNum)
+            n->coalesced++;
+
+        /* Notification is full: send it and start the next one */
+        if (notif_set(e, name, value ? value : "") != MMXBA_OK)
+        {
+            notif_send(n, e);
+            if (notif_start(n, e, i, hash, keys, keyNum) != MMXBA_OK ||
+                notif_set(e, name, value ? value : "") != MMXBA_OK)
+            {
+                e->subscr = -1;
+                status = MMXBA_NOT_ENOUGH_MEMORY;
+                continue;
+            }
+        }
+
+        if (n->window_ms == 0)
+            notif_send(n, e);
+    }
+
+    notify_unlock(n);
+
+    return status;
+}
+
+int mmx_backapi_notify_flush(mmxba_notifier_t *n, uint64_t now_ms)
+{
+    unsigned int i;
+    int sent = 0;
+
+    if (n == NULL)
+        return 0;
+
+    pthread_mutex_lock(&n->lock);
+    for (i = 0; i < n->notif_num; i++)
+        if (n->notifs[i].subscr >= 0 && n->notifs[i].send_ms <= now_ms)
+        {
+            notif_send(n, &n->notifs[i]);
+            sent++;
+        }
+    notify_unlock(n);
+
+    return sent;
+}
+
+int mmx_backapi_notify_next_timeout(mmxba_notifier_t *n, uint64_t now_ms)
+{
+    uint64_t nearest = UINT64_MAX;
+    unsigned int i;
+
+    if (n == NULL)
+        return -1;
+
+    pthread_mutex_lock(&n->lock);
+    for (i = 0; i < n->notif_num; i++)
+        if (n->notifs[i].subscr >= 0 && n->notifs[i].send_ms < nearest)
+            nearest = n->notifs[i].send_ms;
+    pthread_mutex_unlock(&n->lock);
+
+    if (nearest == UINT64_MAX)
+        return -1;
+
+    return (nearest <= now_ms) ? 0 : (int)(nearest - now_ms);
+}
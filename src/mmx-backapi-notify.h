@@ -0,0 +1,206 @@
+/* mmx-backapi-notify.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+/*
+ * Backend change notifications.
+ *
+ * The Entry point subscribes to changes of a backend object by SUBSCRIBE
+ * request with optional filters: values of some key parameters (only the
+ * object instances having these values are reported) and names of the
+ * parameters (only these parameters are reported). The backend reports
+ * every changed value by mmx_backapi_notify_changed(); the changes of the
+ * same object instance are coalesced during the notification window and
+ * sent as a single NOTIFY message with the last values.
+ *
+ * mmx_backapi_notify_handler() handles SUBSCRIBE and UNSUBSCRIBE requests
+ * and can be registered in the dispatcher for the backend objects.
+ * The backend calls mmx_backapi_notify_flush() when the timeout returned
+ * by mmx_backapi_notify_next_timeout() expires.
+ */
+
+#ifndef MMX_BACKAPI_NOTIFY_H_
+#define MMX_BACKAPI_NOTIFY_H_
+
+#include <pthread.h>
+
+#include "mmx-backapi.h"
+
+/* Size of names and values buffer of a pending notification */
+#define MMXBA_NOTIFY_DATA_SIZE   4096
+
+/*
+ * Sends built NOTIFY message to the Entry point. The callback is called
+ * without the notifier lock, so it may call the notifier functions; the
+ * messages are sent in order by one thread at a time, which may be not
+ * the thread that has reported the change.
+ */
+typedef int (*mmxba_notify_send_t)(void *ctx, const char *xml, size_t len);
+
+typedef struct mmxba_subscr_s {
+    uint32_t  subscrId;         /* 0 - free entry */
+    uint32_t  objHash;
+    char      beObjName[MMXBA_MAX_STR_LEN];
+
+    /* Filter of object instances */
+    uint32_t  keyNum;
+    char      keyNames[MMXBA_MAX_NUMBER_OF_KEY_PARAMS][MMXBA_MAX_STR_LEN];
+    char      keyValues[MMXBA_MAX_NUMBER_OF_KEY_PARAMS][MMXBA_MAX_STR_LEN];
+
+    /* Filter of parameters; 0 - all parameters are reported */
+    uint32_t  paramNum;
+    char      paramNames[MMXBA_MAX_NUMBER_OF_GET_PARAMS][MMXBA_MAX_STR_LEN];
+} mmxba_subscr_t;
+
+/* Notification being coalesced; names and values are kept in data
+   and referenced by offsets */
+typedef struct mmxba_notif_s {
+    int       subscr;           /* subscription index, -1 - free entry */
+    uint32_t  hash;             /* hash of the object instance */
+    uint64_t  send_ms;          /* end of the coalescing window */
+    uint32_t  keyNum;
+    uint32_t  valNum;
+    uint16_t  used;
+    uint16_t  keys[MMXBA_MAX_NUMBER_OF_KEY_PARAMS][2];
+    uint16_t  vals[MMXBA_MAX_NUMBER_OF_SET_PARAMS][2];
+    char      data[MMXBA_NOTIFY_DATA_SIZE];
+} mmxba_notif_t;
+
+typedef struct mmxba_notifier_s {
+    pthread_mutex_t      lock;
+    unsigned int         window_ms;
+
+    unsigned int         subscr_num;
+    mmxba_subscr_t       *subscrs;
+    unsigned int         notif_num;
+    mmxba_notif_t        *notifs;
+
+    int                  seq;
+    mmxba_notify_send_t  send;
+    void                 *send_ctx;
+    mmxba_request_t      *msg;
+    char                 *xml;
+
+    /* Built messages waiting for the send callback */
+    char                 *outq;
+    size_t               outq_size;
+    size_t               outq_len;
+    int                  sending;
+
+    /* statistics */
+    unsigned long        sent;
+    unsigned long        coalesced;
+} mmxba_notifier_t;
+
+
+/*
+ * Initializes notifier with up to subscr_num subscriptions and notif_num
+ * notifications coalesced at the same time during window_ms.
+ * Window 0 means that notifications are sent immediately.
+ */
+int mmx_backapi_notify_init(mmxba_notifier_t *n, unsigned int subscr_num,
+                            unsigned int notif_num, unsigned int window_ms,
+                            mmxba_notify_send_t send, void *send_ctx);
+
+/*
+ * Frees the notifier; the pending notifications are dropped
+ */
+int mmx_backapi_notify_destroy(mmxba_notifier_t *n);
+
+/*
+ * Adds or replaces subscription of SUBSCRIBE request
+ */
+int mmx_backapi_notify_subscribe(mmxba_notifier_t *n, const mmxba_request_t *req);
+
+int mmx_backapi_notify_unsubscribe(mmxba_notifier_t *n, uint32_t subscrId);
+
+/*
+ * Request handler of SUBSCRIBE and UNSUBSCRIBE operations; ctx is the notifier
+ */
+int mmx_backapi_notify_handler(mmxba_request_t *req, void *ctx);
+
+/*
+ * Reports changed value of parameter of the object instance specified
+ * by key parameters
+ */
+int mmx_backapi_notify_changed(mmxba_notifier_t *n, const char *beObjName,
+                               const nvpair_t *keys, uint32_t keyNum,
+                               const char *name, const char *value);
+
+/*
+ * Sends notifications which coalescing window is over by now_ms;
+ * UINT64_MAX sends all pending notifications.
+ * Returns number of sent notifications
+ */
+int mmx_backapi_notify_flush(mmxba_notifier_t *n, uint64_t now_ms);
+
+/*
+ * Returns time in ms till the nearest notification must be sent,
+ * or -1 if there are no pending notifications
+ */
+int mmx_backapi_notify_next_timeout(mmxba_notifier_t *n, uint64_t now_ms);
+
+#endif /* MMX_BACKAPI_NOTIFY_H_ */
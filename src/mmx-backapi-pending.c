@@ -0,0 +1,358 @@
+/* mmx-backapi-pending.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Pending requests table of the Entry point: correlation of responses
+ * by opSeqNum and request timeouts.
+ */
+
+#include <limits.h>
+
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-pending.h"
+
+#define PENDING_WHEEL_SIZE   256
+
+
+/* ------------------------------------------------------------------- */
+/*  -----------  MMX pending table internal functions  ----------------*/
+/* ------------------------------------------------------------------- */
+/* The entry waits for the response or for its timeout callback */
+static int entry_busy(const mmxba_pending_entry_t *e)
+{
+    return e->state == MMXBA_PENDING_WAITING || e->state == MMXBA_PENDING_EXPIRING;
+}
+
+static void wheel_link(mmxba_pending_t *tbl, int idx)
+{
+    mmxba_pending_entry_t *e = &tbl->entries[idx];
+    uint64_t tick = (e->deadline_ms + tbl->tick_ms - 1) / tbl->tick_ms;
+    unsigned int slot;
+
+    /* Never put the entry to the already processed ticks */
+    if (tick <= tbl->wheel_tick)
+        tick = tbl->wheel_tick + 1;
+    slot = tick & (tbl->wheel_size - 1);
+
+    e->wheel_slot = slot;
+    e->wheel_prev = -1;
+    e->wheel_next = tbl->wheel[slot];
+    if (e->wheel_next >= 0)
+        tbl->entries[e->wheel_next].wheel_prev = idx;
+    tbl->wheel[slot] = idx;
+}
+
+static void wheel_unlink(mmxba_pending_t *tbl, int idx)
+{
+    mmxba_pending_entry_t *e = &tbl->entries[idx];
+
+    if (e->wheel_prev >= 0)
+        tbl->entries[e->wheel_prev].wheel_next = e->wheel_next;
+    else
+        tbl->wheel[e->wheel_slot] = e->wheel_next;
+
+    if (e->wheel_next >= 0)
+        tbl->entries[e->wheel_next].wheel_prev = e->wheel_prev;
+
+    e->wheel_prev = e->wheel_next = -1;
+}
+
+/* ------------------------------------------------------------------- */
+/*  ----------------  MMX pending table API functions  ----------------*/
+/* ------------------------------------------------------------------- */
+int mmx_backapi_pending_init(mmxba_pending_t *tbl, unsigned int size,
+                             unsigned int tick_ms)
+{
+    int status = MMXBA_OK;
+    unsigned int n = 1, i;
+
+    if (tbl == NULL || size == 0 || size > (1U << 24) || tick_ms == 0)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    while (n < size)
+        n <<= 1;
+
+    memset(tbl, 0, sizeof(*tbl));
+    tbl->size = n;
+    tbl->wheel_size = PENDING_WHEEL_SIZE;
+    tbl->tick_ms = tick_ms;
+    tbl->wheel_tick = mmx_backapi_time_ms() / tick_ms;
+
+    tbl->entries = calloc(n, sizeof(mmxba_pending_entry_t));
+    tbl->wheel = malloc(tbl->wheel_size * sizeof(int));
+    if (!tbl->entries || !tbl->wheel)
+    {
+        mmx_backapi_pending_destroy(tbl);
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "%s: Could not allocate pending table",
+                            __func__);
+    }
+
+    for (i = 0; i < tbl->wheel_size; i++)
+        tbl->wheel[i] = -1;
+
+ret:
+    return status;
+}
+
+int mmx_backapi_pending_destroy(mmxba_pending_t *tbl)
+{
+    if (tbl == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    free(tbl->entries);
+    free(tbl->wheel);
+    memset(tbl, 0, sizeof(*tbl));
+
+    return MMXBA_OK;
+}
+
+int mmx_backapi_pending_next_seq(mmxba_pending_t *tbl)
+{
+    unsigned int i;
+    int seq;
+
+    for (i = 0; i < tbl->size; i++)
+    {
+        seq = tbl->next_seq;
+        tbl->next_seq = (seq == INT_MAX) ? 0 : seq + 1;
+
+        if (!entry_busy(&tbl->entries[seq & (tbl->size - 1)]))
+            return seq;
+    }
+
+    return -1;
+}
+
+int mmx_backapi_pending_add(mmxba_pending_t *tbl, int opSeqNum, unsigned int timeout_ms,
+                            mmxba_pending_cb_t cb, void *ctx)
+{
+    int status = MMXBA_OK;
+    int idx;
+    mmxba_pending_entry_t *e;
+
+    if (tbl == NULL || tbl->entries == NULL || opSeqNum < 0 || cb == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    idx = opSeqNum & (tbl->size - 1);
+    e = &tbl->entries[idx];
+    if (entry_busy(e))
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY,
+                            "Pending entry of seq %d is busy by request %d",
+                            opSeqNum, e->opSeqNum);
+
+    e->opSeqNum = opSeqNum;
+    e->state = MMXBA_PENDING_WAITING;
+    e->expire_next = -1;
+    e->deadline_ms = mmx_backapi_time_ms() + timeout_ms;
+    e->cb = cb;
+    e->ctx = ctx;
+    wheel_link(tbl, idx);
+
+    tbl->inflight++;
+
+ret:
+    return status;
+}
+
+int mmx_backapi_pending_cancel(mmxba_pending_t *tbl, int opSeqNum)
+{
+    int idx = opSeqNum & (tbl->size - 1);
+    mmxba_pending_entry_t *e = &tbl->entries[idx];
+
+    if (opSeqNum < 0 || e->state != MMXBA_PENDING_WAITING || e->opSeqNum != opSeqNum)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    wheel_unlink(tbl, idx);
+    e->state = MMXBA_PENDING_FREE;
+    tbl->inflight--;
+
+    return MMXBA_OK;
+}
+
+mmxba_pending_res_t mmx_backapi_pending_complete(mmxba_pending_t *tbl,
+                                                 mmxba_request_t *resp)
+{
+    int idx;
+    mmxba_pending_entry_t *e;
+
+    if (resp->opSeqNum < 0)
+    {
+        tbl->unknown_cnt++;
+        return MMXBA_PENDING_UNKNOWN;
+    }
+
+    idx = resp->opSeqNum & (tbl->size - 1);
+    e = &tbl->entries[idx];
+
+    if (e->opSeqNum != resp->opSeqNum || e->state == MMXBA_PENDING_FREE)
+    {
+        ing_log(LOG_DEBUG, "Response of unknown request %d\n", resp->opSeqNum);
+        tbl->unknown_cnt++;
+        return MMXBA_PENDING_UNKNOWN;
+    }
+
+    switch (e->state)
+    {
+    case MMXBA_PENDING_COMPLETED:
+        ing_log(LOG_DEBUG, "Duplicated response of request %d\n", resp->opSeqNum);
+        tbl->dup_cnt++;
+        return MMXBA_PENDING_DUPLICATE;
+
+    case MMXBA_PENDING_EXPIRED:
+    case MMXBA_PENDING_EXPIRING:
+        ing_log(LOG_DEBUG, "Late response of expired request %d\n", resp->opSeqNum);
+        tbl->late_cnt++;
+        return MMXBA_PENDING_LATE;
+
+    default:
+        break;
+    }
+
+    /* Only the shedding of the matched request is counted */
+    if (resp->opResCode == MMXBA_SHED)
+        tbl->shed_cnt++;
+
+    wheel_unlink(tbl, idx);
+    e->state = MMXBA_PENDING_COMPLETED;
+    tbl->inflight--;
+
+    e->cb(e->ctx, e->opSeqNum, resp, MMXBA_OK);
+
+    return MMXBA_PENDING_MATCHED;
+}
+
+unsigned int mmx_backapi_pending_expire(mmxba_pending_t *tbl, uint64_t now_ms)
+{
+    uint64_t now_tick = now_ms / tbl->tick_ms;
+    uint64_t ticks, t;
+    unsigned int slot, expired = 0;
+    int idx, next, list = -1;
+
+    if (now_tick <= tbl->wheel_tick)
+        return 0;
+
+    ticks = now_tick - tbl->wheel_tick;
+    if (ticks > tbl->wheel_size)
+        ticks = tbl->wheel_size;
+
+    /* Collect the expired entries first: the callbacks may add and
+       cancel requests, so the wheel lists must be consistent. The
+       collected entries are busy until their callbacks are called. */
+    for (t = tbl->wheel_tick + 1; t <= tbl->wheel_tick + ticks; t++)
+    {
+        slot = t & (tbl->wheel_size - 1);
+        for (idx = tbl->wheel[slot]; idx >= 0; idx = next)
+        {
+            next = tbl->entries[idx].wheel_next;
+            if (tbl->entries[idx].deadline_ms > now_ms)
+                continue;
+
+            wheel_unlink(tbl, idx);
+            tbl->entries[idx].state = MMXBA_PENDING_EXPIRING;
+            tbl->entries[idx].expire_next = list;
+            list = idx;
+        }
+    }
+    tbl->wheel_tick = now_tick;
+
+    for (idx = list; idx >= 0; idx = next)
+    {
+        mmxba_pending_entry_t *e = &tbl->entries[idx];
+
+        next = e->expire_next;
+        e->expire_next = -1;
+        e->state = MMXBA_PENDING_EXPIRED;
+        tbl->inflight--;
+        tbl->timeout_cnt++;
+        expired++;
+
+        e->cb(e->ctx, e->opSeqNum, NULL, MMXBA_TIMEOUT);
+    }
+
+    return expired;
+}
+
+int mmx_backapi_pending_next_timeout(mmxba_pending_t *tbl, uint64_t now_ms)
+{
+    uint64_t t, next_ms;
+
+    if (tbl->inflight == 0)
+        return -1;
+
+    /* The entries of the slot may wait for the next wheel turns, then
+       the expire call of this tick just does nothing */
+    for (t = tbl->wheel_tick + 1; t <= tbl->wheel_tick + tbl->wheel_size; t++)
+    {
+        if (tbl->wheel[t & (tbl->wheel_size - 1)] >= 0)
+            break;
+    }
+
+    next_ms = t * tbl->tick_ms;
+
+    return (next_ms > now_ms) ? (int)(next_ms - now_ms) : 0;
+}
@@ -0,0 +1,203 @@
+/* mmx-backapi-pending.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+/*
+ * Correlation of backend responses with outstanding requests.
+ *
+ * The Entry point registers every sent request in the pending table by its
+ * opSeqNum. The table is a ring of entries indexed by (opSeqNum mod size),
+ * so a response is matched by one array access. Request timeouts are kept
+ * in a hashed timer wheel. When a response is matched or a request expires
+ * the callback of the request is called.
+ *
+ * The entry keeps the sequence number after completion, so late responses
+ * (received after the timeout) and duplicated responses are recognized.
+ *
+ * The request deadline (mmx_backapi_request_set_budget()) should be set
+ * to its timeout, so the backend does not process the request after the
+ * EP has stopped waiting for it; such requests are answered with MMXBA_SHED
+ * result code and counted by the table.
+ *
+ * The table is not thread safe: it should be used by one EP thread.
+ */
+
+#ifndef MMX_BACKAPI_PENDING_H_
+#define MMX_BACKAPI_PENDING_H_
+
+#include <stdint.h>
+
+#include "mmx-backapi.h"
+
+/*
+ * Completion callback: status is MMXBA_OK if the response resp is received
+ * or MMXBA_TIMEOUT if the request is expired (resp is NULL)
+ */
+typedef void (*mmxba_pending_cb_t)(void *ctx, int opSeqNum,
+                                   mmxba_request_t *resp, int status);
+
+/* Result of response matching */
+typedef enum mmxba_pending_res_e {
+    MMXBA_PENDING_MATCHED = 0,  /* response of the pending request      */
+    MMXBA_PENDING_DUPLICATE,    /* request was already completed        */
+    MMXBA_PENDING_LATE,         /* request was already expired          */
+    MMXBA_PENDING_UNKNOWN       /* no request with such sequence number */
+} mmxba_pending_res_t;
+
+typedef enum mmxba_pending_state_e {
+    MMXBA_PENDING_FREE = 0,
+    MMXBA_PENDING_WAITING,
+    MMXBA_PENDING_COMPLETED,
+    MMXBA_PENDING_EXPIRED,
+    MMXBA_PENDING_EXPIRING      /* expired, its callback is not called yet */
+} mmxba_pending_state_t;
+
+typedef struct mmxba_pending_entry_s {
+    int                 opSeqNum;
+    int                 state;
+    uint64_t            deadline_ms;
+    mmxba_pending_cb_t  cb;
+    void                *ctx;
+    unsigned int        wheel_slot;   /* timer wheel slot and its list */
+    int                 wheel_prev;   /* links (entry indexes, -1 -    */
+    int                 wheel_next;   /* none)                         */
+    int                 expire_next;  /* list of the expiring entries  */
+} mmxba_pending_entry_t;
+
+typedef struct mmxba_pending_s {
+    unsigned int           size;        /* entries number, power of 2 */
+    mmxba_pending_entry_t  *entries;
+
+    unsigned int           wheel_size;  /* timer wheel slots, power of 2 */
+    unsigned int           tick_ms;
+    int                    *wheel;      /* first entry of each slot */
+    uint64_t               wheel_tick;  /* last processed tick */
+
+    int                    next_seq;
+    unsigned int           inflight;
+
+    /* statistics */
+    unsigned long          late_cnt;
+    unsigned long          dup_cnt;
+    unsigned long          unknown_cnt;
+    unsigned long          timeout_cnt;
+    unsigned long          shed_cnt;    /* matched responses with MMXBA_SHED code */
+} mmxba_pending_t;
+
+
+/*
+ * Initializes pending table of up to size outstanding requests (rounded up
+ * to power of 2). Timeouts are checked with tick_ms granularity.
+ */
+int mmx_backapi_pending_init(mmxba_pending_t *tbl, unsigned int size,
+                             unsigned int tick_ms);
+
+/*
+ * Frees the table. Callbacks of the waiting requests are not called.
+ */
+int mmx_backapi_pending_destroy(mmxba_pending_t *tbl);
+
+/*
+ * Returns the next sequence number whose table entry is not waiting for
+ * a response or for its timeout callback, or -1 if all entries are busy
+ */
+int mmx_backapi_pending_next_seq(mmxba_pending_t *tbl);
+
+/*
+ * Registers request with the specified sequence number. The callback is
+ * called when the response is matched or after timeout_ms milliseconds.
+ */
+int mmx_backapi_pending_add(mmxba_pending_t *tbl, int opSeqNum, unsigned int timeout_ms,
+                            mmxba_pending_cb_t cb, void *ctx);
+
+/*
+ * Removes the waiting request without calling its callback
+ */
+int mmx_backapi_pending_cancel(mmxba_pending_t *tbl, int opSeqNum);
+
+/*
+ * Matches parsed response (or its header) to the waiting request and
+ * calls the request callback
+ */
+mmxba_pending_res_t mmx_backapi_pending_complete(mmxba_pending_t *tbl,
+                                                 mmxba_request_t *resp);
+
+/*
+ * Calls callbacks of all requests expired by now_ms. The callbacks may add
+ * new requests (e.g. retry the expired one): the entries of the requests
+ * whose callbacks are not called yet are not reused.
+ * Returns number of the expired requests.
+ */
+unsigned int mmx_backapi_pending_expire(mmxba_pending_t *tbl, uint64_t now_ms);
+
+/*
+ * Returns time in milliseconds until the tick of the nearest not empty
+ * timer wheel slot (to be used as poll/epoll timeout) or -1 if nothing
+ * is waiting
+ */
+int mmx_backapi_pending_next_timeout(mmxba_pending_t *tbl, uint64_t now_ms);
+
+#endif /* MMX_BACKAPI_PENDING_H_ */
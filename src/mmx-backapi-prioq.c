@@ -0,0 +1,156 @@
+/* mmx-backapi-prioq.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Multi-level priority queue of requests.
+ */
+
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-prioq.h"
+
+#define PRIOQ_MASK      (MMXBA_PRIOQ_SIZE - 1)
+
+#if (MMXBA_PRIOQ_SIZE & PRIOQ_MASK)
+#error "MMXBA_PRIOQ_SIZE must be power of 2"
+#endif
+
+/* Levels of the classes in order of taking */
+static const unsigned int prio_level[MMXBA_PRIO_NUM] = {
+    [MMXBA_PRIO_INTERACTIVE] = 0,
+    [MMXBA_PRIO_NORMAL]      = 1,
+    [MMXBA_PRIO_BULK]        = 2
+};
+
+static const uint32_t default_aging_ms[MMXBA_PRIO_NUM] = {
+    [MMXBA_PRIO_INTERACTIVE] = 0,
+    [MMXBA_PRIO_NORMAL]      = MMXBA_PRIOQ_AGING_NORMAL_MS,
+    [MMXBA_PRIO_BULK]        = MMXBA_PRIOQ_AGING_BULK_MS
+};
+
+
+/* ------------------------------------------------------------------- */
+/*  ----------------  MMX priority queue API functions  ---------------*/
+/* ------------------------------------------------------------------- */
+void mmx_backapi_prioq_init(mmxba_prioq_t *q, const uint32_t *aging_ms)
+{
+    unsigned int p;
+
+    memset(q, 0, sizeof(*q));
+
+    for (p = 0; p < MMXBA_PRIO_NUM; p++)
+        q->levels[prio_level[p]].aging_ms = aging_ms ? aging_ms[p] : default_aging_ms[p];
+}
+
+int mmx_backapi_prioq_push(mmxba_prioq_t *q, void *item, mmxba_prio_t prio,
+                           uint64_t now_ms)
+{
+    mmxba_prioq_level_t *l;
+
+    if ((unsigned int)prio >= MMXBA_PRIO_NUM)
+        prio = MMXBA_PRIO_NORMAL;
+
+    l = &q->levels[prio_level[prio]];
+    if (l->tail - l->head > PRIOQ_MASK)
+        return MMXBA_NOT_ENOUGH_MEMORY;
+
+    l->items[l->tail & PRIOQ_MASK].item = item;
+    l->items[l->tail & PRIOQ_MASK].queued_ms = now_ms;
+    l->tail++;
+    q->count++;
+
+    return MMXBA_OK;
+}
+
+void *mmx_backapi_prioq_pop(mmxba_prioq_t *q, uint64_t now_ms)
+{
+    mmxba_prioq_level_t *l, *next = NULL;
+    unsigned int i;
+
+    if (q->count == 0)
+        return NULL;
+
+    for (i = 0; i < MMXBA_PRIO_NUM; i++)
+    {
+        l = &q->levels[i];
+        if (l->head == l->tail)
+            continue;
+
+        /* The first non-empty level, unless a lower one has aged */
+        if (next == NULL)
+            next = l;
+        else if (l->aging_ms && now_ms - l->items[l->head & PRIOQ_MASK].queued_ms >= l->aging_ms)
+        {
+            next = l;
+            break;
+        }
+    }
+
+    q->count--;
+
+    return next->items[next->head++ & PRIOQ_MASK].item;
+}
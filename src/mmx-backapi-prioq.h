@@ -0,0 +1,130 @@
+/* mmx-backapi-prioq.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Multi-level priority queue of requests.
+ *
+ * The queue has one FIFO level per priority class. Requests are taken by
+ * strict priority (interactive, then normal, then bulk), but a request of
+ * a lower class which has waited longer than the aging time of its class
+ * is taken first, so bulk requests are delayed but never starved.
+ *
+ * The queue is not thread safe; it is used by the worker threads under
+ * their locks and may be used by the EP send path the same way.
+ */
+
+#ifndef MMX_BACKAPI_PRIOQ_H_
+#define MMX_BACKAPI_PRIOQ_H_
+
+#include <stdint.h>
+
+#include "mmx-backapi.h"
+
+#define MMXBA_PRIOQ_SIZE                256     /* items per level, power of 2 */
+
+/* Default aging times of the classes */
+#define MMXBA_PRIOQ_AGING_NORMAL_MS     200
+#define MMXBA_PRIOQ_AGING_BULK_MS       1000
+
+typedef struct mmxba_prioq_item_s {
+    void      *item;
+    uint64_t  queued_ms;
+} mmxba_prioq_item_t;
+
+typedef struct mmxba_prioq_level_s {
+    mmxba_prioq_item_t  items[MMXBA_PRIOQ_SIZE];
+    unsigned int        head;     /* next item to take */
+    unsigned int        tail;     /* next free place   */
+    uint32_t            aging_ms; /* 0 - no aging      */
+} mmxba_prioq_level_t;
+
+typedef struct mmxba_prioq_s {
+    mmxba_prioq_level_t  levels[MMXBA_PRIO_NUM];  /* in order of taking */
+    unsigned int         count;
+} mmxba_prioq_t;
+
+
+/*
+ * Initializes empty queue. aging_ms (may be NULL - defaults) are aging
+ * times of the classes indexed by mmxba_prio_t (0 - no aging).
+ */
+void mmx_backapi_prioq_init(mmxba_prioq_t *q, const uint32_t *aging_ms);
+
+/*
+ * Queues the item of the priority class; MMXBA_NOT_ENOUGH_MEMORY is
+ * returned if the level of the class is full
+ */
+int mmx_backapi_prioq_push(mmxba_prioq_t *q, void *item, mmxba_prio_t prio,
+                           uint64_t now_ms);
+
+/*
+ * Takes the next item, or returns NULL if the queue is empty
+ */
+void *mmx_backapi_prioq_pop(mmxba_prioq_t *q, uint64_t now_ms);
+
+#endif /* MMX_BACKAPI_PRIOQ_H_ */
@@ -0,0 +1,416 @@
+/* mmx-backapi-shmring.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Shared-memory SPSC ring transport of MMX backend API messages.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-shmring.h"
+
+/* Every slot keeps message length followed by the message data and
+   the terminating null character */
+typedef struct shmring_slot_s {
+    uint32_t len;
+    char     data[0];
+} shmring_slot_t;
+
+#define SLOT_STRIDE(slot_size) \
+    (((sizeof(shmring_slot_t) + (slot_size) + 1) + 63) & ~(size_t)63)
+
+#define SLOT(ring, idx) ((shmring_slot_t *)((ring)->slots + \
+    (size_t)((idx) & ((ring)->slot_num - 1)) * SLOT_STRIDE((ring)->slot_size)))
+
+#define SLOTS_OFFSET   ((sizeof(mmxba_shmring_hdr_t) + 63) & ~(size_t)63)
+
+
+/* ------------------------------------------------------------------- */
+/*  -----------  MMX shm ring internal functions      -----------------*/
+/* ------------------------------------------------------------------- */
+static int shmring_map(mmxba_shmring_t *ring, int mem_fd, int event_fd, size_t size)
+{
+    int status = MMXBA_OK;
+    void *addr;
+
+    addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, mem_fd, 0);
+    if (addr == MAP_FAILED)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not map ring memory: %s",
+                            strerror(errno));
+
+    ring->mem_fd = mem_fd;
+    ring->event_fd = event_fd;
+    ring->map_size = size;
+    ring->hdr = (mmxba_shmring_hdr_t *)addr;
+    ring->slots = (char *)addr + SLOTS_OFFSET;
+
+ret:
+    return status;
+}
+
+
+/* ------------------------------------------------------------------- */
+/*  ----------------  MMX shm ring API functions      -----------------*/
+/* ------------------------------------------------------------------- */
+int mmx_backapi_shmring_create(mmxba_shmring_t *ring, size_t slot_size,
+                               unsigned int slot_num)
+{
+    int status = MMXBA_OK;
+    int mem_fd = -1, event_fd = -1;
+    unsigned int n = 1;
+    size_t size;
+
+    if (ring == NULL || slot_size == 0 || slot_size > UINT32_MAX / 2 ||
+        slot_num == 0 || slot_num > (1U << 20))
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    while (n < slot_num)
+        n <<= 1;
+    size = SLOTS_OFFSET + (size_t)n * SLOT_STRIDE(slot_size);
+
+    if ((mem_fd = memfd_create("mmx-backapi-ring", MFD_CLOEXEC)) < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not create ring memory: %s",
+                            strerror(errno));
+
+    if (ftruncate(mem_fd, size) < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not set ring memory size: %s",
+                            strerror(errno));
+
+    if ((event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not create ring eventfd: %s",
+                            strerror(errno));
+
+    if ((status = shmring_map(ring, mem_fd, event_fd, size)) != MMXBA_OK)
+        goto ret;
+
+    ring->slot_size = ring->hdr->slot_size = slot_size;
+    ring->slot_num = ring->hdr->slot_num = n;
+    ring->hdr->head = 0;
+    ring->hdr->tail = 0;
+    __atomic_store_n(&ring->hdr->magic, MMXBA_SHMRING_MAGIC, __ATOMIC_RELEASE);
+
+ret:
+    if (status != MMXBA_OK)
+    {
+        if (mem_fd >= 0)
+            close(mem_fd);
+        if (event_fd >= 0)
+            close(event_fd);
+    }
+    return status;
+}
+
+int mmx_backapi_shmring_attach(mmxba_shmring_t *ring, int mem_fd, int event_fd)
+{
+    int status = MMXBA_OK;
+    struct stat st;
+    mmxba_shmring_hdr_t *hdr;
+    uint32_t slot_size, slot_num;
+
+    if (ring == NULL || mem_fd < 0 || event_fd < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    if (fstat(mem_fd, &st) < 0 || (size_t)st.st_size < SLOTS_OFFSET)
+        GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Bad size of ring memory");
+
+    if ((status = shmring_map(ring, mem_fd, event_fd, st.st_size)) != MMXBA_OK)
+        goto ret;
+
+    /* The geometry is read from the shared header once: the values that
+       are validated are the ones used */
+    hdr = ring->hdr;
+    slot_size = __atomic_load_n(&hdr->slot_size, __ATOMIC_RELAXED);
+    slot_num = __atomic_load_n(&hdr->slot_num, __ATOMIC_RELAXED);
+    if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != MMXBA_SHMRING_MAGIC ||
+        slot_num == 0 || (slot_num & (slot_num - 1)) ||
+        SLOTS_OFFSET + (size_t)slot_num * SLOT_STRIDE(slot_size) > ring->map_size)
+    {
+        munmap(ring->hdr, ring->map_size);
+        ring->hdr = NULL;
+        GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Ring memory is not initialized");
+    }
+    ring->slot_size = slot_size;
+    ring->slot_num = slot_num;
+
+ret:
+    return status;
+}
+
+int mmx_backapi_shmring_detach(mmxba_shmring_t *ring)
+{
+    if (ring == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    if (ring->hdr)
+        munmap(ring->hdr, ring->map_size);
+    if (ring->mem_fd >= 0)
+        close(ring->mem_fd);
+    if (ring->event_fd >= 0)
+        close(ring->event_fd);
+
+    memset(ring, 0, sizeof(*ring));
+    ring->mem_fd = ring->event_fd = -1;
+
+    return MMXBA_OK;
+}
+
+int mmx_backapi_shmring_send_fds(int sock, mmxba_shmring_t *ring)
+{
+    int status = MMXBA_OK;
+    char dummy = 'R';
+    struct iovec iov = { .iov_base = &dummy, .iov_len = 1 };
+    union {
+        struct cmsghdr hdr;
+        char buf[CMSG_SPACE(2 * sizeof(int))];
+    } ctrl;
+    struct msghdr msg;
+    struct cmsghdr *cmsg;
+    int fds[2];
+
+    if (sock < 0 || ring == NULL || ring->hdr == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    fds[0] = ring->mem_fd;
+    fds[1] = ring->event_fd;
+
+    memset(&msg, 0, sizeof(msg));
+    memset(&ctrl, 0, sizeof(ctrl));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl.buf;
+    msg.msg_controllen = sizeof(ctrl.buf);
+
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    if (sendmsg(sock, &msg, 0) < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not send ring descriptors: %s",
+                            strerror(errno));
+
+ret:
+    return status;
+}
+
+int mmx_backapi_shmring_recv_fds(int sock, int *mem_fd, int *event_fd)
+{
+    int status = MMXBA_OK;
+    char dummy;
+    struct iovec iov = { .iov_base = &dummy, .iov_len = 1 };
+    union {
+        struct cmsghdr hdr;
+        char buf[CMSG_SPACE(2 * sizeof(int))];
+    } ctrl;
+    struct msghdr msg;
+    struct cmsghdr *cmsg;
+    int fds[2];
+
+    if (sock < 0 || mem_fd == NULL || event_fd == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl.buf;
+    msg.msg_controllen = sizeof(ctrl.buf);
+
+    if (recvmsg(sock, &msg, MSG_CMSG_CLOEXEC) <= 0)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not receive ring descriptors: %s",
+                            strerror(errno));
+
+    cmsg = CMSG_FIRSTHDR(&msg);
+    if (cmsg == NULL || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS ||
+        cmsg->cmsg_len != CMSG_LEN(sizeof(fds)))
+        GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Ring descriptors are not received");
+
+    memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+    *mem_fd = fds[0];
+    *event_fd = fds[1];
+
+ret:
+    return status;
+}
+
+char *mmx_backapi_shmring_reserve(mmxba_shmring_t *ring, size_t *size)
+{
+    mmxba_shmring_hdr_t *hdr = ring->hdr;
+    uint32_t head = hdr->head;   /* written by this side only */
+
+    if (head - __atomic_load_n(&hdr->tail, __ATOMIC_ACQUIRE) >= ring->slot_num)
+        return NULL;
+
+    if (size)
+        *size = ring->slot_size;
+
+    return SLOT(ring, head)->data;
+}
+
+int mmx_backapi_shmring_commit(mmxba_shmring_t *ring, size_t len)
+{
+    int status = MMXBA_OK;
+    mmxba_shmring_hdr_t *hdr = ring->hdr;
+    uint32_t head = hdr->head;
+    shmring_slot_t *slot = SLOT(ring, head);
+    uint64_t one = 1;
+
+    if (len > ring->slot_size)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "Message of %zu bytes exceeds ring slot",
+                            len);
+
+    slot->len = len;
+    slot->data[len] = '\0';
+
+    /* Publish the slot; if the consumer had nothing to read before it
+       could be sleeping on the eventfd */
+    __atomic_store_n(&hdr->head, head + 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&hdr->tail, __ATOMIC_SEQ_CST) == head)
+    {
+        if (write(ring->event_fd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+            GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not signal ring eventfd: %s",
+                                strerror(errno));
+    }
+
+ret:
+    return status;
+}
+
+char *mmx_backapi_shmring_peek(mmxba_shmring_t *ring, size_t *len)
+{
+    mmxba_shmring_hdr_t *hdr = ring->hdr;
+    uint32_t tail = hdr->tail;   /* written by this side only */
+    shmring_slot_t *slot;
+    uint32_t slot_len;
+
+    if (__atomic_load_n(&hdr->head, __ATOMIC_SEQ_CST) == tail)
+        return NULL;
+
+    slot = SLOT(ring, tail);
+    slot_len = __atomic_load_n(&slot->len, __ATOMIC_RELAXED);
+    if (slot_len > ring->slot_size)
+    {
+        ing_log(LOG_ERR, "Bad message length %u in ring slot\n", slot_len);
+        return NULL;
+    }
+
+    if (len)
+        *len = slot_len;
+
+    return slot->data;
+}
+
+int mmx_backapi_shmring_release(mmxba_shmring_t *ring)
+{
+    mmxba_shmring_hdr_t *hdr = ring->hdr;
+    uint32_t tail = hdr->tail;
+
+    if (__atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE) == tail)
+        return MMXBA_GENERAL_ERROR;
+
+    __atomic_store_n(&hdr->tail, tail + 1, __ATOMIC_SEQ_CST);
+
+    return MMXBA_OK;
+}
+
+int mmx_backapi_shmring_wait(mmxba_shmring_t *ring, int timeout_ms)
+{
+    int status = MMXBA_OK;
+    struct pollfd pfd = { .fd = ring->event_fd, .events = POLLIN };
+    uint64_t cnt;
+    int res;
+
+    while (__atomic_load_n(&ring->hdr->head, __ATOMIC_SEQ_CST) ==
+           __atomic_load_n(&ring->hdr->tail, __ATOMIC_SEQ_CST))
+    {
+        res = poll(&pfd, 1, timeout_ms);
+        if (res < 0 && errno != EINTR)
+            GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not wait for ring: %s",
+                                strerror(errno));
+        if (res == 0)
+        {
+            status = MMXBA_TIMEOUT;
+            goto ret;
+        }
+        if (res > 0 && read(ring->event_fd, &cnt, sizeof(cnt)) < 0 && errno != EAGAIN)
+            GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not read ring eventfd: %s",
+                                strerror(errno));
+    }
+
+ret:
+    return status;
+}
@@ -0,0 +1,178 @@
+/* mmx-backapi-shmring.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+/*
+ * Shared-memory transport of MMX backend API messages between the Entry
+ * point and a backend running on the same host.
+ *
+ * A ring is a single-producer/single-consumer queue of fixed size slots
+ * placed in memfd memory mapped by both processes. The producer builds the
+ * xml message directly into a reserved slot (for example by calling
+ * mmx_backapi_response_build() on the slot buffer) and the consumer parses
+ * it in place, so no data is copied through a socket. The consumer is
+ * woken up by eventfd which can be polled together with other descriptors.
+ *
+ * A ring carries messages in one direction, so a pair of rings is used
+ * per backend (requests and responses). The memfd and the eventfd of a
+ * ring are passed to the peer process over AF_UNIX socket.
+ */
+
+#ifndef MMX_BACKAPI_SHMRING_H_
+#define MMX_BACKAPI_SHMRING_H_
+
+#include <stdint.h>
+
+#include "mmx-backapi.h"
+
+#define MMXBA_SHMRING_MAGIC     0x4d4d5852  /* "MMXR" */
+
+/* Ring control block placed at the beginning of the shared memory */
+typedef struct mmxba_shmring_hdr_s {
+    uint32_t magic;
+    uint32_t slot_size;         /* bytes of message data per slot */
+    uint32_t slot_num;          /* number of slots (power of 2)   */
+
+    /* head is written by the producer only and tail by the consumer only;
+       they are placed in separate cache lines */
+    uint32_t head __attribute__((aligned(64)));
+    uint32_t tail __attribute__((aligned(64)));
+} mmxba_shmring_hdr_t;
+
+typedef struct mmxba_shmring_s {
+    int                  mem_fd;
+    int                  event_fd;
+    size_t               map_size;
+    mmxba_shmring_hdr_t  *hdr;
+    char                 *slots;
+
+    /* Copies of the header geometry validated at create/attach time; the
+       shared header can be changed by the peer afterwards */
+    uint32_t             slot_size;
+    uint32_t             slot_num;
+} mmxba_shmring_t;
+
+
+/*
+ * Creates a new ring of slot_num slots (rounded up to power of 2),
+ * each one can keep a message of up to slot_size bytes
+ */
+int mmx_backapi_shmring_create(mmxba_shmring_t *ring, size_t slot_size,
+                               unsigned int slot_num);
+
+/*
+ * Maps the ring created by the peer process. The descriptors are owned
+ * by the ring after successful attachment.
+ */
+int mmx_backapi_shmring_attach(mmxba_shmring_t *ring, int mem_fd, int event_fd);
+
+/*
+ * Unmaps the ring and closes its descriptors
+ */
+int mmx_backapi_shmring_detach(mmxba_shmring_t *ring);
+
+/*
+ * Passes the ring descriptors to the peer over connected AF_UNIX socket
+ */
+int mmx_backapi_shmring_send_fds(int sock, mmxba_shmring_t *ring);
+
+/*
+ * Receives the ring descriptors sent by mmx_backapi_shmring_send_fds()
+ */
+int mmx_backapi_shmring_recv_fds(int sock, int *mem_fd, int *event_fd);
+
+/*
+ * Producer: returns the buffer of the next free slot and its size or
+ * NULL if the ring is full. The message is not visible to the consumer
+ * until mmx_backapi_shmring_commit() is called.
+ */
+char *mmx_backapi_shmring_reserve(mmxba_shmring_t *ring, size_t *size);
+
+/*
+ * Producer: publishes the message of len bytes written to the reserved
+ * slot and wakes up the consumer if it could be waiting
+ */
+int mmx_backapi_shmring_commit(mmxba_shmring_t *ring, size_t len);
+
+/*
+ * Consumer: returns the null-terminated message of the oldest slot and
+ * its length or NULL if the ring is empty. The message stays valid until
+ * mmx_backapi_shmring_release() is called.
+ */
+char *mmx_backapi_shmring_peek(mmxba_shmring_t *ring, size_t *len);
+
+/*
+ * Consumer: returns the oldest slot to the producer
+ */
+int mmx_backapi_shmring_release(mmxba_shmring_t *ring);
+
+/*
+ * Consumer: waits up to timeout_ms milliseconds (-1 - infinitely) until
+ * the ring is not empty. MMXBA_OK is returned if there are messages.
+ */
+int mmx_backapi_shmring_wait(mmxba_shmring_t *ring, int timeout_ms);
+
+#endif /* MMX_BACKAPI_SHMRING_H_ */
@@ -0,0 +1,491 @@
+/* mmx-backapi-snapshot.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Memory-mapped table snapshots.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-snapshot.h"
+
+#define HDR_SIZE    ((sizeof(mmxba_snapshot_hdr_t) + 63) & ~(size_t)63)
+
+#define REGION(snap, idx) ((mmxba_snapshot_region_t *)((char *)(snap)->hdr + \
+    HDR_SIZE + (size_t)(idx) * (snap)->hdr->region_size))
+
+#define CELLS_SIZE(hdr) \
+    ((size_t)(hdr)->max_rows * (hdr)->col_num * sizeof(mmxba_snapshot_cell_t))
+
+
+/* ------------------------------------------------------------------- */
+/*  -----------  MMX snapshot internal functions      -----------------*/
+/* ------------------------------------------------------------------- */
+static void snapshot_set_region(mmxba_snapshot_t *snap, uint32_t idx)
+{
+    snap->region = REGION(snap, idx);
+    snap->heap = (char *)snap->region->cells + CELLS_SIZE(snap->hdr);
+}
+
+static int snapshot_map(mmxba_snapshot_t *snap, int fd, size_t size, int writer)
+{
+    int status = MMXBA_OK;
+    void *addr;
+
+    addr = mmap(NULL, size, writer ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not map snapshot: %s", strerror(errno));
+
+    snap->fd = fd;
+    snap->writer = writer;
+    snap->map_size = size;
+    snap->hdr = (mmxba_snapshot_hdr_t *)addr;
+    snap->region = NULL;
+    snap->heap = NULL;
+
+ret:
+    return status;
+}
+
+
+/* ------------------------------------------------------------------- */
+/*  ----------------  MMX snapshot API functions      -----------------*/
+/* ------------------------------------------------------------------- */
+int mmx_backapi_snapshot_create(mmxba_snapshot_t *snap, const char *path,
+                                const char *beObjName, const char *cols[],
+                                uint32_t col_num, uint32_t key_num,
+                                uint32_t max_rows, uint32_t heap_size)
+{
+    int status = MMXBA_OK;
+    int fd = -1;
+    char tmp_path[MMXBA_MAX_STR_LEN + 8];
+    uint64_t region_size;
+    mmxba_snapshot_hdr_t *hdr;
+    uint32_t i;
+
+    if (snap == NULL || path == NULL || strlen(path) >= sizeof(snap->path) ||
+        beObjName == NULL || cols == NULL || col_num == 0 ||
+        col_num > MMXBA_SNAPSHOT_MAX_COLS || key_num == 0 || key_num > col_num ||
+        max_rows == 0 || heap_size == 0)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    memset(snap, 0, sizeof(*snap));
+    snap->fd = -1;
+
+    region_size = sizeof(mmxba_snapshot_region_t) +
+                  (uint64_t)max_rows * col_num * sizeof(mmxba_snapshot_cell_t) + heap_size;
+    region_size = (region_size + 63) & ~(uint64_t)63;
+
+    /* The file is prepared under temporary name and then renamed,
+       so readers never see partially initialized header */
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    if ((fd = open(tmp_path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)) < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not create snapshot %s: %s",
+                            tmp_path, strerror(errno));
+
+    if (ftruncate(fd, HDR_SIZE + 2 * region_size) < 0)
+    {
+        close(fd);
+        unlink(tmp_path);
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not size snapshot: %s", strerror(errno));
+    }
+
+    if ((status = snapshot_map(snap, fd, HDR_SIZE + 2 * region_size, TRUE)) != MMXBA_OK)
+    {
+        close(fd);
+        unlink(tmp_path);
+        goto ret;
+    }
+
+    hdr = snap->hdr;
+    hdr->magic = MMXBA_SNAPSHOT_MAGIC;
+    hdr->format = MMXBA_SNAPSHOT_FORMAT;
+    hdr->col_num = col_num;
+    hdr->key_num = key_num;
+    hdr->max_rows = max_rows;
+    hdr->heap_size = heap_size;
+    hdr->region_size = region_size;
+    hdr->writer_pid = getpid();
+    strcpy_safe(hdr->beObjName, beObjName, sizeof(hdr->beObjName));
+    for (i = 0; i < col_num; i++)
+        strcpy_safe(hdr->cols[i], cols[i], sizeof(hdr->cols[i]));
+    hdr->update_ms = mmx_backapi_time_ms();
+
+    if (rename(tmp_path, path) < 0)
+    {
+        mmx_backapi_snapshot_close(snap, FALSE);
+        unlink(tmp_path);
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not publish snapshot %s: %s",
+                            path, strerror(errno));
+    }
+
+    strcpy_safe(snap->path, path, sizeof(snap->path));
+
+ret:
+    return status;
+}
+
+int mmx_backapi_snapshot_begin(mmxba_snapshot_t *snap)
+{
+    if (snap == NULL || !snap->writer)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    /* The previous switch must be visible before the old region is
+       overwritten */
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    snapshot_set_region(snap, !snap->hdr->active);
+    snap->region->row_num = 0;
+    snap->region->heap_used = 0;
+
+    return MMXBA_OK;
+}
+
+int mmx_backapi_snapshot_add_row(mmxba_snapshot_t *snap, const char *values[])
+{
+    mmxba_snapshot_hdr_t *hdr;
+    mmxba_snapshot_region_t *region;
+    mmxba_snapshot_cell_t *cells;
+    size_t len, need = 0;
+    uint32_t i;
+
+    if (snap == NULL || !snap->writer || snap->region == NULL || values == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    hdr = snap->hdr;
+    region = snap->region;
+    if (region->row_num == hdr->max_rows)
+        return MMXBA_NOT_ENOUGH_MEMORY;
+
+    for (i = 0; i < hdr->col_num; i++)
+        need += strlen(values[i] ? values[i] : "") + 1;
+    if (region->heap_used + need > hdr->heap_size)
+        return MMXBA_NOT_ENOUGH_MEMORY;
+
+    cells = &region->cells[(size_t)region->row_num * hdr->col_num];
+    for (i = 0; i < hdr->col_num; i++)
+    {
+        len = strlen(values[i] ? values[i] : "");
+        memcpy(snap->heap + region->heap_used, values[i] ? values[i] : "", len + 1);
+        cells[i].off = region->heap_used;
+        cells[i].len = len;
+        region->heap_used += len + 1;
+    }
+    region->row_num++;
+
+    return MMXBA_OK;
+}
+
+int mmx_backapi_snapshot_publish(mmxba_snapshot_t *snap)
+{
+    mmxba_snapshot_hdr_t *hdr;
+    uint32_t seq;
+
+    if (snap == NULL || !snap->writer || snap->region == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    hdr = snap->hdr;
+    seq = hdr->seq;
+
+    __atomic_store_n(&hdr->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    __atomic_store_n(&hdr->active, !hdr->active, __ATOMIC_RELAXED);
+    hdr->generation++;
+    hdr->update_ms = mmx_backapi_time_ms();
+
+    __atomic_store_n(&hdr->seq, seq + 2, __ATOMIC_RELEASE);
+    snap->region = NULL;
+
+    return MMXBA_OK;
+}
+
+int mmx_backapi_snapshot_open(mmxba_snapshot_t *snap, const char *path)
+{
+    int status = MMXBA_OK;
+    int fd = -1;
+    struct stat st;
+    mmxba_snapshot_hdr_t *hdr;
+
+    if (snap == NULL || path == NULL || strlen(path) >= sizeof(snap->path))
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    memset(snap, 0, sizeof(*snap));
+    snap->fd = -1;
+
+    /* Missing snapshot is not an error: GETALL is used instead */
+    if ((fd = open(path, O_RDONLY | O_CLOEXEC)) < 0)
+        return MMXBA_NOT_INITIALIZED;
+
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < HDR_SIZE)
+    {
+        close(fd);
+        GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Bad snapshot file %s", path);
+    }
+
+    if ((status = snapshot_map(snap, fd, st.st_size, FALSE)) != MMXBA_OK)
+    {
+        close(fd);
+        goto ret;
+    }
+
+    hdr = snap->hdr;
+    if (hdr->magic != MMXBA_SNAPSHOT_MAGIC || hdr->format != MMXBA_SNAPSHOT_FORMAT ||
+        hdr->col_num == 0 || hdr->col_num > MMXBA_SNAPSHOT_MAX_COLS ||
+        hdr->key_num > hdr->col_num ||
+        HDR_SIZE + 2 * hdr->region_size != (uint64_t)st.st_size ||
+        sizeof(mmxba_snapshot_region_t) + CELLS_SIZE(hdr) + hdr->heap_size > hdr->region_size)
+    {
+        mmx_backapi_snapshot_close(snap, FALSE);
+        GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Bad snapshot header in %s", path);
+    }
+
+    strcpy_safe(snap->path, path, sizeof(snap->path));
+
+ret:
+    return status;
+}
+
+uint32_t mmx_backapi_snapshot_read_begin(mmxba_snapshot_t *snap)
+{
+    uint32_t seq;
+    int spins = 0;
+
+    while (((seq = __atomic_load_n(&snap->hdr->seq, __ATOMIC_ACQUIRE)) & 1) &&
+           ++spins < MMXBA_SNAPSHOT_BEGIN_SPINS)
+        sched_yield();
+
+    snapshot_set_region(snap, __atomic_load_n(&snap->hdr->active, __ATOMIC_RELAXED) & 1);
+
+    return seq;
+}
+
+int mmx_backapi_snapshot_read_end(mmxba_snapshot_t *snap, uint32_t seq)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return !(seq & 1) && __atomic_load_n(&snap->hdr->seq, __ATOMIC_RELAXED) == seq;
+}
+
+uint32_t mmx_backapi_snapshot_rows(mmxba_snapshot_t *snap)
+{
+    uint32_t rows = snap->region->row_num;
+
+    return (rows > snap->hdr->max_rows) ? 0 : rows;
+}
+
+const char *mmx_backapi_snapshot_cell(mmxba_snapshot_t *snap, uint32_t row,
+                                      uint32_t col, uint32_t *len)
+{
+    mmxba_snapshot_hdr_t *hdr = snap->hdr;
+    mmxba_snapshot_cell_t cell;
+
+    if (row >= hdr->max_rows || col >= hdr->col_num)
+        return NULL;
+
+    /* The cell may be torn by the writer: it is checked against the
+       heap bounds, the reading is validated by the seqlock */
+    cell = snap->region->cells[(size_t)row * hdr->col_num + col];
+    if ((uint64_t)cell.off + cell.len >= hdr->heap_size)
+        return NULL;
+
+    if (len)
+        *len = cell.len;
+
+    return snap->heap + cell.off;
+}
+
+int mmx_backapi_snapshot_col(mmxba_snapshot_t *snap, const char *name)
+{
+    uint32_t i;
+
+    for (i = 0; i < snap->hdr->col_num; i++)
+        if (!strcmp(snap->hdr->cols[i], name))
+            return i;
+
+    return -1;
+}
+
+int mmx_backapi_snapshot_getall(mmxba_snapshot_t *snap, mmxba_request_t *req)
+{
+    int cols[MMXBA_MAX_NUMBER_OF_KEY_PARAMS];
+    uint32_t i, k, rows, len, pos, seq;
+    const char *value;
+    int attempt, separated;
+    char *obj;
+
+    if (snap == NULL || snap->hdr == NULL || req == NULL ||
+        req->op_type != MMXBA_OP_TYPE_GETALL || req->getAll.beKeyNamesNum == 0 ||
+        req->getAll.beKeyNamesNum > MMXBA_MAX_NUMBER_OF_KEY_PARAMS)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    if (strcmp(snap->hdr->beObjName, req->beObjName))
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    /* The table of the terminated writer is not maintained anymore */
+    if (kill(snap->hdr->writer_pid, 0) < 0 && errno == ESRCH)
+        return MMXBA_NOT_INITIALIZED;
+
+    for (k = 0; k < req->getAll.beKeyNamesNum; k++)
+        if ((cols[k] = mmx_backapi_snapshot_col(snap, req->getAll.beKeyNames[k])) < 0)
+            return MMXBA_GENERAL_ERROR;
+
+    for (attempt = 0; attempt < MMXBA_SNAPSHOT_READ_RETRIES; attempt++)
+    {
+        /* The busy writer counts as the failed attempt */
+        if ((seq = mmx_backapi_snapshot_read_begin(snap)) & 1)
+            continue;
+
+        /* No generation: the snapshot is never published yet */
+        if (snap->hdr->generation == 0)
+            return MMXBA_NOT_INITIALIZED;
+
+        if ((rows = mmx_backapi_snapshot_rows(snap)) > MMXBA_MAX_NUMBER_OF_GETALL_PARAMS)
+        {
+            if (mmx_backapi_snapshot_read_end(snap, seq))
+                return MMXBA_NOT_ENOUGH_MEMORY;
+            continue;
+        }
+
+        /* Object key values are comma separated; the structured view
+           of the objects is filled as well. The value containing the
+           separator would be split differently by the receiver */
+        separated = FALSE;
+        for (i = 0; i < rows; i++)
+        {
+            obj = req->getAll.objects[i];
+            for (k = 0, pos = 0; k < req->getAll.beKeyNamesNum; k++)
+            {
+                if ((value = mmx_backapi_snapshot_cell(snap, i, cols[k], &len)) == NULL)
+                    break;
+                if (pos + len + 2 > MMXBA_MAX_STR_LEN)
+                    break;
+                if (memchr(value, ',', len) || memchr(value, ';', len))
+                {
+                    separated = TRUE;
+                    break;
+                }
+                if (k)
+                    obj[pos++] = ',';
+                memcpy(obj + pos, value, len);
+                req->getAll.objKeys[i][k].off = pos;
+                req->getAll.objKeys[i][k].len = len;
+                pos += len;
+            }
+            obj[pos] = '\0';
+            if (k < req->getAll.beKeyNamesNum)
+                break;
+        }
+
+        if (!mmx_backapi_snapshot_read_end(snap, seq))
+            continue;
+
+        /* Consistent reading of a bad cell */
+        if (separated)
+            return MMXBA_BAD_INPUT_PARAMS;
+        if (i < rows)
+            return MMXBA_INVALID_FORMAT;
+
+        req->getAll.objNum = rows;
+        req->getAll.generation = 0;
+        req->getAll.isDelta = FALSE;
+        req->opResCode = 0;
+
+        return MMXBA_OK;
+    }
+
+    return MMXBA_TIMEOUT;
+}
+
+int mmx_backapi_snapshot_close(mmxba_snapshot_t *snap, int unlink_file)
+{
+    if (snap == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    if (snap->hdr)
+        munmap(snap->hdr, snap->map_size);
+    if (snap->fd >= 0)
+        close(snap->fd);
+    if (unlink_file && snap->writer && snap->path[0])
+        unlink(snap->path);
+
+    memset(snap, 0, sizeof(*snap));
+    snap->fd = -1;
+
+    return MMXBA_OK;
+}
@@ -0,0 +1,234 @@
+/* mmx-backapi-snapshot.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+/*
+ * Memory-mapped table snapshots published by backends.
+ *
+ * A backend keeps a large read-mostly table (e.g. ARP entries or routes)
+ * in a file in tmpfs (e.g. /dev/shm), and the Entry point reads its rows
+ * from the mapping without any message exchange.
+ *
+ * The file keeps a header with column names and two regions. Each region
+ * keeps the rows as fixed-stride arrays of (offset, length) cells of the
+ * columns and a heap of null-terminated strings. The writer fills the
+ * inactive region and publishes it by switching the active region under
+ * a seqlock; a reader reads the active region in place and validates the
+ * seqlock afterwards, retrying if the regions were switched meanwhile.
+ *
+ * The first key_num columns are the backend key parameters of the table.
+ * mmx_backapi_snapshot_getall() fills a GETALL response from the snapshot
+ * and fails if the snapshot is not usable, then the Entry point falls back
+ * to the normal GETALL request.
+ */
+
+#ifndef MMX_BACKAPI_SNAPSHOT_H_
+#define MMX_BACKAPI_SNAPSHOT_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "mmx-backapi.h"
+
+#define MMXBA_SNAPSHOT_MAGIC      0x4d4d5853  /* "MMXS" */
+#define MMXBA_SNAPSHOT_FORMAT     1
+#define MMXBA_SNAPSHOT_MAX_COLS   32
+
+/* Reader retries before falling back to GETALL */
+#define MMXBA_SNAPSHOT_READ_RETRIES  8
+
+/* Reader yields waiting for the writer to finish the update */
+#define MMXBA_SNAPSHOT_BEGIN_SPINS   64
+
+typedef struct mmxba_snapshot_hdr_s {
+    uint32_t magic;
+    uint32_t format;
+    uint32_t col_num;
+    uint32_t key_num;           /* first key_num columns are key params */
+    uint32_t max_rows;
+    uint32_t heap_size;
+    uint64_t region_size;
+    int32_t  writer_pid;
+    char     beObjName[MMXBA_MAX_STR_LEN];
+    char     cols[MMXBA_SNAPSHOT_MAX_COLS][MMXBA_MAX_STR_LEN];
+
+    /* Written on publishing only */
+    uint32_t seq __attribute__((aligned(64)));   /* odd while switching */
+    uint32_t active;            /* active region: 0 or 1 */
+    uint32_t generation;        /* incremented on every publishing */
+    uint64_t update_ms;
+} mmxba_snapshot_hdr_t;
+
+typedef struct mmxba_snapshot_cell_s {
+    uint32_t off;               /* offset in the heap */
+    uint32_t len;
+} mmxba_snapshot_cell_t;
+
+/* Region: rows of col_num cells followed by the strings heap */
+typedef struct mmxba_snapshot_region_s {
+    uint32_t row_num;
+    uint32_t heap_used;
+    mmxba_snapshot_cell_t cells[0];
+} mmxba_snapshot_region_t;
+
+typedef struct mmxba_snapshot_s {
+    char                     path[MMXBA_MAX_STR_LEN];
+    int                      fd;
+    int                      writer;
+    size_t                   map_size;
+    mmxba_snapshot_hdr_t     *hdr;
+
+    /* Writer: region being filled; reader: region being read */
+    mmxba_snapshot_region_t  *region;
+    char                     *heap;
+} mmxba_snapshot_t;
+
+
+/* ---------------------------  Writer  ---------------------------- */
+
+/*
+ * Creates snapshot file of beObjName table with columns cols (the first
+ * key_num are the key parameters) for up to max_rows rows and heap_size
+ * bytes of strings per region
+ */
+int mmx_backapi_snapshot_create(mmxba_snapshot_t *snap, const char *path,
+                                const char *beObjName, const char *cols[],
+                                uint32_t col_num, uint32_t key_num,
+                                uint32_t max_rows, uint32_t heap_size);
+
+/*
+ * Starts filling the new table contents
+ */
+int mmx_backapi_snapshot_begin(mmxba_snapshot_t *snap);
+
+/*
+ * Adds row of col_num values
+ */
+int mmx_backapi_snapshot_add_row(mmxba_snapshot_t *snap, const char *values[]);
+
+/*
+ * Publishes the filled contents to the readers
+ */
+int mmx_backapi_snapshot_publish(mmxba_snapshot_t *snap);
+
+
+/* ---------------------------  Reader  ---------------------------- */
+
+/*
+ * Maps the snapshot file for reading
+ */
+int mmx_backapi_snapshot_open(mmxba_snapshot_t *snap, const char *path);
+
+/*
+ * Starts reading the active region; returns the seqlock value to be
+ * validated by mmx_backapi_snapshot_read_end(). The odd value is returned
+ * if the writer is busy after MMXBA_SNAPSHOT_BEGIN_SPINS yields (or died
+ * in the middle of the update); the reading is never validated then.
+ */
+uint32_t mmx_backapi_snapshot_read_begin(mmxba_snapshot_t *snap);
+
+/*
+ * Returns TRUE if the data read since mmx_backapi_snapshot_read_begin()
+ * is consistent, FALSE if the reading must be retried
+ */
+int mmx_backapi_snapshot_read_end(mmxba_snapshot_t *snap, uint32_t seq);
+
+/*
+ * Returns number of rows of the region being read
+ */
+uint32_t mmx_backapi_snapshot_rows(mmxba_snapshot_t *snap);
+
+/*
+ * Returns value of the column of the row in the mapping (or NULL if the
+ * cell is out of bounds); the value is valid if the reading is validated
+ */
+const char *mmx_backapi_snapshot_cell(mmxba_snapshot_t *snap, uint32_t row,
+                                      uint32_t col, uint32_t *len);
+
+/*
+ * Returns index of the column or -1
+ */
+int mmx_backapi_snapshot_col(mmxba_snapshot_t *snap, const char *name);
+
+/*
+ * Fills GETALL response (objects of the requested beKeyNames) from the
+ * snapshot. Returns error if the snapshot cannot be used: the writer is
+ * gone, a key name is unknown, the objects do not fit the response or the
+ * reading was not consistent after MMXBA_SNAPSHOT_READ_RETRIES attempts
+ * (MMXBA_TIMEOUT). A key value containing "," or ";" can not be joined
+ * into the objKeyValues string and fails with MMXBA_BAD_INPUT_PARAMS.
+ * MMXBA_NOT_INITIALIZED means the snapshot was not published yet or its
+ * writer is gone; the restarted writer creates a new file to be reopened.
+ */
+int mmx_backapi_snapshot_getall(mmxba_snapshot_t *snap, mmxba_request_t *req);
+
+
+/*
+ * Unmaps the snapshot; the writer removes the file if unlink_file is set
+ */
+int mmx_backapi_snapshot_close(mmxba_snapshot_t *snap, int unlink_file);
+
+#endif /* MMX_BACKAPI_SNAPSHOT_H_ */
@@ -0,0 +1,1106 @@
+/* mmx-backapi-stream.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Incremental (push) parser of MMX backend API messages.
+ */
+
+#include <arpa/inet.h>
+
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-stream.h"
+#include "mmx-backapi-value.h"
+#include "mmx-backapi-dict.h"
+
+/* Lexer states */
+enum {
+    ST_FRAME_HDR = 0,   /* length of the next frame          */
+    ST_SKIP,            /* rest of the broken frame           */
+    ST_TEXT,
+    ST_LT,              /* after "<"                          */
+    ST_START_NAME,
+    ST_ATTRS,           /* between attributes of start tag    */
+    ST_ATTR_NAME,
+    ST_ATTR_EQ,
+    ST_ATTR_QUOTE,
+    ST_ATTR_VALUE,
+    ST_EMPTY_END,       /* after "/" of empty element tag     */
+    ST_END_NAME,
+    ST_END_WS,
+    ST_BANG,            /* after "<!": comment is expected    */
+    ST_COMMENT,
+    ST_PI,
+    ST_ENTITY,
+    ST_DONE
+};
+
+/* Elements of the messages */
+enum {
+    E_UNKNOWN = 0,
+    E_ROOT,
+    E_OPNAME,
+    E_SEQNUM,
+    E_PRIO,
+    E_DEADLINE,
+    E_BEOBJNAME,
+    E_OPRESCODE,
+    E_OPEXTCODE,
+    E_ERRMSG,
+    E_POSTOPSTATUS,
+    E_MMXINSTANCE,
+    E_SUBSCRID,
+    E_GENERATION,
+    E_OBJENC,
+    E_BEKEYPARAMS,
+    E_PARAMNAMES,
+    E_PARAMVALUES,
+    E_BEKEYNAMES,
+    E_OBJECTS,
+    E_NVPAIR,
+    E_NAME,
+    E_VALUE,
+    E_OBJKEYVALUES
+};
+
+#define SEEN(e)     (1u << (e))
+
+/* Parts of nvPair item */
+#define ITEM_NAME   0x01
+#define ITEM_VALUE  0x02
+
+static const struct {
+    const char  *tag;
+    uint8_t     id;
+} stream_elems[] = {
+    { MMXBA_STR_REQUEST,        E_ROOT },
+    { MMXBA_STR_RESPONSE,       E_ROOT },
+    { MMXBA_STR_NOTIFY,         E_ROOT },
+    { MMXBA_STR_OPNAME,         E_OPNAME },
+    { MMXBA_STR_SEQNUM,         E_SEQNUM },
+    { MMXBA_STR_PRIO,           E_PRIO },
+    { MMXBA_STR_DEADLINE,       E_DEADLINE },
+    { MMXBA_STR_BEOBJNAME,      E_BEOBJNAME },
+    { MMXBA_STR_OPRESCODE,      E_OPRESCODE },
+    { MMXBA_STR_OPEXTCODE,      E_OPEXTCODE },
+    { MMXBA_STR_ERRMSG,         E_ERRMSG },
+    { MMX_STR_POSTOPSTATUS,     E_POSTOPSTATUS },
+    { MMXBA_STR_MMXINSTANCE,    E_MMXINSTANCE },
+    { MMXBA_STR_SUBSCRID,       E_SUBSCRID },
+    { MMXBA_STR_GENERATION,     E_GENERATION },
+    { MMXBA_STR_OBJENC,         E_OBJENC },
+    { MMXBA_STR_BEKEYPARAMS,    E_BEKEYPARAMS },
+    { MMXBA_STR_PARAMNAMES,     E_PARAMNAMES },
+    { MMXBA_STR_PARAMVALUES,    E_PARAMVALUES },
+    { MMXBA_STR_BEKEYNAMES,     E_BEKEYNAMES },
+    { MMXBA_STR_OBJECTS,        E_OBJECTS },
+    { MMXBA_STR_NAMEVALUEPAIR,  E_NVPAIR },
+    { MMXBA_STR_NAME,           E_NAME },
+    { MMXBA_STR_VALUE,          E_VALUE },
+    { MMXBA_STR_OBJKEYVALUES,   E_OBJKEYVALUES }
+};
+
+/* ------------------------------------------------------------------- */
+/*  -----------  MMX stream parser internal functions  ----------------*/
+/* ------------------------------------------------------------------- */
+static int is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static int stream_fail(mmxba_stream_t *s, int status, const char *msg)
+{
+    if (s->status == MMXBA_OK)
+    {
+        ing_log(LOG_ERR, "Stream parser: %s\n", msg);
+        s->status = status;
+    }
+    return status;
+}
+
+static uint8_t elem_id(const mmxba_stream_t *s)
+{
+    unsigned int i;
+
+    if (s->tag_len >= MMXBA_STREAM_TAG_LEN)
+        return E_UNKNOWN;
+
+    for (i = 0; i < sizeof(stream_elems) / sizeof(stream_elems[0]); i++)
+        if (!strcmp(s->tag, stream_elems[i].tag))
+            return stream_elems[i].id;
+
+    return E_UNKNOWN;
+}
+
+/* Appends the char to the name buffer; too long names are marked by the
+   length equal to the buffer size */
+static void name_put(char *buf, unsigned int *len, unsigned int size, char c)
+{
+    if (*len < size - 1)
+    {
+        buf[(*len)++] = c;
+        buf[*len] = '\0';
+    }
+    else
+        *len = size;
+}
+
+static void text_put(mmxba_stream_t *s, char c)
+{
+    /* Text of the ignored elements and whitespace between elements */
+    if (s->text == NULL)
+    {
+        if (s->depth == 0 && !is_space(c))
+            stream_fail(s, MMXBA_INVALID_FORMAT, "text out of the root element");
+        return;
+    }
+
+    if (s->text_len + 1 < s->text_size)
+        s->text[s->text_len++] = c;
+    else if (s->text_pool)
+        stream_fail(s, MMXBA_NOT_ENOUGH_MEMORY, "not enough memory in the pool for value");
+    /* other texts are truncated as by the DOM parser */
+}
+
+static void val_put(mmxba_stream_t *s, char c)
+{
+    if (s->val_len < sizeof(s->val) - 1)
+        s->val[s->val_len++] = c;
+}
+
+/* Puts decoded char of entity (code point in UTF-8) to the text or to
+   the attribute value */
+static void entity_put(mmxba_stream_t *s, unsigned long cp)
+{
+    char utf[4];
+    int n, i;
+
+    if (cp < 0x80)
+        utf[0] = cp, n = 1;
+    else if (cp < 0x800)
+        utf[0] = 0xC0 | (cp >> 6), utf[1] = 0x80 | (cp & 0x3F), n = 2;
+    else if (cp < 0x10000)
+        utf[0] = 0xE0 | (cp >> 12), utf[1] = 0x80 | ((cp >> 6) & 0x3F),
+        utf[2] = 0x80 | (cp & 0x3F), n = 3;
+    else
+        utf[0] = 0xF0 | (cp >> 18), utf[1] = 0x80 | ((cp >> 12) & 0x3F),
+        utf[2] = 0x80 | ((cp >> 6) & 0x3F), utf[3] = 0x80 | (cp & 0x3F), n = 4;
+
+    for (i = 0; i < n; i++)
+    {
+        if (s->ent_ret == ST_ATTR_VALUE)
+            val_put(s, utf[i]);
+        else
+            text_put(s, utf[i]);
+    }
+}
+
+static void entity_decode(mmxba_stream_t *s)
+{
+    unsigned long cp;
+    char *end;
+
+    s->ent[s->ent_len] = '\0';
+
+    if (!strcmp(s->ent, "amp"))
+        cp = '&';
+    else if (!strcmp(s->ent, "lt"))
+        cp = '<';
+    else if (!strcmp(s->ent, "gt"))
+        cp = '>';
+    else if (!strcmp(s->ent, "quot"))
+        cp = '"';
+    else if (!strcmp(s->ent, "apos"))
+        cp = '\'';
+    else if (s->ent[0] == '#')
+    {
+        if (s->ent[1] == 'x' || s->ent[1] == 'X')
+            cp = strtoul(s->ent + 2, &end, 16);
+        else
+            cp = strtoul(s->ent + 1, &end, 10);
+        if (*end || end == s->ent + 1 || cp == 0 || cp > 0x10FFFF)
+        {
+            stream_fail(s, MMXBA_INVALID_FORMAT, "bad character reference");
+            return;
+        }
+    }
+    else
+    {
+        stream_fail(s, MMXBA_INVALID_FORMAT, "unknown entity");
+        return;
+    }
+
+    entity_put(s, cp);
+}
+
+static void attrs_reset(mmxba_stream_t *s)
+{
+    s->a_size = -1;
+    s->a_id[0] = s->a_type[0] = s->a_prefix[0] = s->a_dict[0] = '\0';
+    s->a_removed = s->a_delta = s->a_front = FALSE;
+}
+
+/* Keeps the attributes used by the messages */
+static void attr_done(mmxba_stream_t *s)
+{
+    s->val[s->val_len] = '\0';
+
+    if (s->attr_len >= MMXBA_STREAM_TAG_LEN)
+        return;
+
+    if (!strcmp(s->attr, MMXBA_STR_ATTR_ARRAYSIZE))
+        s->a_size = (s->val_len && s->val_len < 12) ? strtol(s->val, NULL, 10) : -1;
+    else if (!strcmp(s->attr, MMXBA_STR_ATTR_ID))
+        strcpy_safe(s->a_id, s->val, sizeof(s->a_id));
+    else if (!strcmp(s->attr, MMXBA_STR_ATTR_TYPE))
+        strcpy_safe(s->a_type, s->val, sizeof(s->a_type));
+    else if (!strcmp(s->attr, MMXBA_STR_ATTR_PREFIX))
+        strcpy_safe(s->a_prefix, s->val, sizeof(s->a_prefix));
+    else if (!strcmp(s->attr, MMXBA_STR_ATTR_DICT))
+        strcpy_safe(s->a_dict, s->val, sizeof(s->a_dict));
+    else if (!strcmp(s->attr, MMXBA_STR_ATTR_REMOVED))
+        s->a_removed = atoi(s->val) ? TRUE : FALSE;
+    else if (!strcmp(s->attr, MMXBA_STR_ATTR_DELTA))
+        s->a_delta = atoi(s->val) ? TRUE : FALSE;
+    else if (!strcmp(s->attr, MMXBA_STR_ATTR_ENC))
+        s->a_front = !strcmp(s->val, MMXBA_STR_ENC_FRONT);
+}
+
+static void text_set(mmxba_stream_t *s, char *text, size_t size, int pool)
+{
+    s->text = text;
+    s->text_size = size;
+    s->text_len = 0;
+    s->text_pool = pool;
+}
+
+/* Resets the request fields as mmx_backapi_message_parse() does */
+static void message_start(mmxba_stream_t *s)
+{
+    mmxba_request_t *req = s->req;
+    msg_names_t names;
+
+    if (strcmp(s->tag, MMXBA_STR_REQUEST) && strcmp(s->tag, MMXBA_STR_RESPONSE) &&
+        strcmp(s->tag, MMXBA_STR_NOTIFY))
+    {
+        stream_fail(s, MMXBA_INVALID_FORMAT, "bad type of management message");
+        return;
+    }
+    s->isRequest = strcmp(s->tag, MMXBA_STR_RESPONSE) ? TRUE : FALSE;
+
+    memset(req->valTypes, 0, sizeof(req->valTypes));
+    memset(req->beKeyIds, 0, sizeof(req->beKeyIds));
+    memset(req->nameIds, 0, sizeof(req->nameIds));
+    req->nameIndex = NULL;
+    req->prio = MMXBA_PRIO_NORMAL;
+    req->deadline = 0;
+
+    mmxba_names_init(&names, s->a_dict[0] ? s->a_dict : NULL);
+    s->dict = names.dict;
+    s->sameDict = names.sameDict;
+}
+
+/* Selects the request array filled by the array element; FALSE is
+   returned if the element is not used by the message */
+static int array_select(mmxba_stream_t *s, uint8_t id)
+{
+    mmxba_request_t *req = s->req;
+    uint32_t secs = mmxba_schema_sections(req->op_type, s->isRequest);
+    uint32_t *count = NULL;
+    uint32_t max = 0;
+
+    s->pairs = NULL;
+    s->names = NULL;
+    s->ids = NULL;
+    s->typed = FALSE;
+
+    switch (id)
+    {
+    case E_BEKEYPARAMS:
+        if (secs & (MMXBA_SEC_BEKEYPARAMS | MMXBA_SEC_KEYFILTER))
+        {
+            s->pairs = req->beKeyParams;
+            s->ids = req->beKeyIds;
+            count = &req->beKeyParamsNum;
+            max = MMXBA_MAX_NUMBER_OF_KEY_PARAMS;
+        }
+        break;
+
+    case E_PARAMNAMES:
+        if (secs & (MMXBA_SEC_PARAMNAMES | MMXBA_SEC_NAMEFILTER))
+        {
+            s->names = req->paramNames.paramNames;
+            s->ids = req->nameIds;
+            count = &req->paramNames.arraySize;
+            max = MMXBA_MAX_NUMBER_OF_GET_PARAMS;
+        }
+        break;
+
+    case E_PARAMVALUES:
+        if (secs & (MMXBA_SEC_PARAMVALUES | MMXBA_SEC_CHANGES))
+        {
+            s->pairs = req->paramValues.paramValues;
+            count = &req->paramValues.arraySize;
+        }
+        else if (secs & MMXBA_SEC_NEWVALUES)
+        {
+            s->pairs = req->addObj_req.paramValues;
+            count = &req->addObj_req.paramNum;
+        }
+        s->ids = req->nameIds;
+        s->typed = TRUE;
+        max = MMXBA_MAX_NUMBER_OF_SET_PARAMS;
+        break;
+
+    case E_BEKEYNAMES:
+        if (!(secs & MMXBA_SEC_BEKEYNAMES))
+            break;
+        if (req->op_type == MMXBA_OP_TYPE_GETALL)
+        {
+            s->names = req->getAll.beKeyNames;
+            count = &req->getAll.beKeyNamesNum;
+        }
+        else
+        {
+            s->names = req->addObj_resp.beKeyNames;
+            count = &req->addObj_resp.beKeyNamesNum;
+        }
+        max = MMXBA_MAX_NUMBER_OF_KEY_PARAMS;
+        break;
+
+    case E_OBJECTS:
+        if (!(secs & MMXBA_SEC_OBJECTS))
+            break;
+        if (req->op_type == MMXBA_OP_TYPE_GETALL)
+        {
+            s->names = req->getAll.objects;
+            count = &req->getAll.objNum;
+            max = MMXBA_MAX_NUMBER_OF_GETALL_PARAMS;
+            req->getAll.isDelta = s->a_delta;
+            req->getAll.objEnc = s->a_front ? MMXBA_OBJ_ENC_FRONT : MMXBA_OBJ_ENC_PLAIN;
+        }
+        else
+        {
+            s->names = req->addObj_resp.objects;
+            count = &req->addObj_resp.objNum;
+            max = MMXBA_MAX_NUMBER_OF_ADDED_INSTANCES;
+        }
+        break;
+    }
+
+    if (count == NULL)
+        return FALSE;
+
+    if (s->a_size < 0 || s->a_size > max)
+    {
+        stream_fail(s, MMXBA_INVALID_FORMAT, "incorrect value of attribute " MMXBA_STR_ATTR_ARRAYSIZE);
+        return FALSE;
+    }
+
+    *count = s->arr_size = s->a_size;
+    s->arr_num = 0;
+    s->arr = id;
+
+    return TRUE;
+}
+
+/* Handles the start tag; FALSE is returned for elements which are not
+   used by the message, their subtree is skipped */
+static int elem_open(mmxba_stream_t *s, uint8_t id)
+{
+    unsigned int depth = s->depth;      /* the element is not pushed yet */
+
+    s->text = NULL;
+
+    if (depth == 0)
+    {
+        message_start(s);
+        return TRUE;
+    }
+
+    if (depth == 1)
+    {
+        switch (id)
+        {
+        case E_BEKEYPARAMS: case E_PARAMNAMES: case E_PARAMVALUES:
+        case E_BEKEYNAMES: case E_OBJECTS:
+            return array_select(s, id);
+        case E_UNKNOWN: case E_ROOT: case E_NVPAIR: case E_NAME: case E_VALUE:
+        case E_OBJKEYVALUES:
+            return FALSE;
+        default:
+            text_set(s, s->buf, sizeof(s->buf), FALSE);
+            return TRUE;
+        }
+    }
+
+    /* Items of the arrays: extra items are ignored as by the DOM parser */
+    if (depth == 2 && s->arr_num < s->arr_size)
+    {
+        if (s->pairs && id == E_NVPAIR)
+        {
+            s->item_parts = 0;
+            return TRUE;
+        }
+        if (s->names && id == (s->arr == E_OBJECTS ? E_OBJKEYVALUES : E_NAME))
+        {
+            text_set(s, s->names[s->arr_num], MMXBA_MAX_STR_LEN, FALSE);
+            return TRUE;
+        }
+        return FALSE;
+    }
+
+    /* Name and value of nvPair item */
+    if (depth == 3 && s->pairs)
+    {
+        nvpair_t *pnv = &s->pairs[s->arr_num];
+        mmxba_req_mempool_t *pool = &s->req->mem_pool;
+
+        if (id == E_NAME)
+        {
+            text_set(s, pnv->name, sizeof(pnv->name), FALSE);
+            return TRUE;
+        }
+        if (id == E_VALUE)
+        {
+            if (!pool->initialized)
+            {
+                stream_fail(s, MMXBA_NOT_INITIALIZED, "memory pool is not initialized");
+                return FALSE;
+            }
+            /* Even empty value needs its terminating zero */
+            if (pool->curr_offset >= pool->size_bytes)
+            {
+                stream_fail(s, MMXBA_NOT_ENOUGH_MEMORY, "not enough memory in the pool for value");
+                return FALSE;
+            }
+            text_set(s, pool->pool + pool->curr_offset,
+                     pool->size_bytes - pool->curr_offset, TRUE);
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/* Completes the name of names array or of nvPair item */
+static int name_done(mmxba_stream_t *s, uint16_t *id)
+{
+    msg_names_t names = { s->dict, s->sameDict };
+    const char *name = s->text_len ? s->text : NULL;
+
+    if (mmxba_resolve_name(&names, s->a_id[0] ? s->a_id : NULL, &name, id) != MMXBA_OK)
+        return stream_fail(s, MMXBA_INVALID_FORMAT, "unknown id of param name");
+
+    if (name == NULL)
+        s->text[0] = '\0';
+    else if (name != s->text)
+        strcpy_safe(s->text, name, s->text_size);
+
+    return MMXBA_OK;
+}
+
+/* Resets the arrays and optional fields of the message sections as
+   tree_get_sections() does: the sections may be missing in the message
+   and the request is reused for the next messages of the stream */
+static void sections_reset(mmxba_request_t *req, uint32_t secs)
+{
+    if (secs & (MMXBA_SEC_BEKEYPARAMS | MMXBA_SEC_KEYFILTER))
+        req->beKeyParamsNum = 0;
+    if (secs & (MMXBA_SEC_PARAMNAMES | MMXBA_SEC_NAMEFILTER))
+        req->paramNames.arraySize = 0;
+    if (secs & (MMXBA_SEC_PARAMVALUES | MMXBA_SEC_CHANGES))
+        req->paramValues.arraySize = 0;
+    if (secs & MMXBA_SEC_NEWVALUES)
+        req->addObj_req.paramNum = 0;
+    if (req->op_type == MMXBA_OP_TYPE_GETALL)
+    {
+        req->getAll.generation = 0;
+        req->getAll.isDelta = FALSE;
+        req->getAll.objEnc = MMXBA_OBJ_ENC_PLAIN;
+    }
+}
+
+static void scalar_done(mmxba_stream_t *s, uint8_t id)
+{
+    mmxba_request_t *req = s->req;
+    const char *str = s->buf;
+    int prio;
+
+    switch (id)
+    {
+    case E_OPNAME:
+        req->op_type = mmxba_optype2num(str);
+        sections_reset(req, mmxba_schema_sections(req->op_type, s->isRequest));
+        break;
+    case E_SEQNUM:
+        req->opSeqNum = atoi(str);
+        break;
+    case E_PRIO:
+        prio = atoi(str);
+        if (s->isRequest)
+            req->prio = (prio >= 0 && prio < MMXBA_PRIO_NUM) ? prio : MMXBA_PRIO_NORMAL;
+        break;
+    case E_DEADLINE:
+        if (s->isRequest)
+            req->deadline = strtoull(str, NULL, 10);
+        break;
+    case E_BEOBJNAME:
+        strcpy_safe(req->beObjName, str, sizeof(req->beObjName));
+        break;
+    case E_OPRESCODE:
+        if (!s->isRequest)
+            req->opResCode = atoi(str);
+        break;
+    case E_OPEXTCODE:
+        if (!s->isRequest)
+            req->opExtErrCode = atoi(str);
+        break;
+    case E_ERRMSG:
+        if (!s->isRequest)
+            strcpy_safe(req->errMsg, str, sizeof(req->errMsg));
+        break;
+    case E_POSTOPSTATUS:
+        if (!s->isRequest)
+            req->postOpStatus = atoi(str);
+        break;
+    case E_MMXINSTANCE:
+        strcpy_safe(req->mmxInstances, str, sizeof(req->mmxInstances));
+        break;
+    case E_SUBSCRID:
+        req->subscrId = strtoul(str, NULL, 10);
+        break;
+    case E_GENERATION:
+        if (req->op_type == MMXBA_OP_TYPE_GETALL)
+            req->getAll.generation = strtoul(str, NULL, 10);
+        break;
+    case E_OBJENC:
+        if (req->op_type == MMXBA_OP_TYPE_GETALL && !strcmp(str, MMXBA_STR_ENC_FRONT))
+            req->getAll.objEnc = MMXBA_OBJ_ENC_FRONT;
+        break;
+    }
+}
+
+/* Checks the elements required by the operation and completes the request */
+static void message_end(mmxba_stream_t *s)
+{
+    mmxba_request_t *req = s->req;
+    int op = req->op_type;
+    uint32_t secs = mmxba_schema_sections(op, s->isRequest);
+    uint32_t need = SEEN(E_OPNAME) | SEEN(E_SEQNUM) | SEEN(E_BEOBJNAME);
+    uint32_t i;
+
+    /* Elements of the required sections (MMXBA_SEC_REQUIRED) */
+    if (secs & MMXBA_SEC_MMXINSTANCE)
+        need |= SEEN(E_MMXINSTANCE);
+    if (secs & MMXBA_SEC_SUBSCRID)
+        need |= SEEN(E_SUBSCRID);
+    if (secs & MMXBA_SEC_BEKEYPARAMS)
+        need |= SEEN(E_BEKEYPARAMS);
+    if (secs & MMXBA_SEC_CHANGES)
+        need |= SEEN(E_PARAMVALUES);
+    if (secs & MMXBA_SEC_BEKEYNAMES)
+        need |= SEEN(E_BEKEYNAMES);
+
+    if ((s->seen & need) != need)
+    {
+        stream_fail(s, MMXBA_INVALID_FORMAT, "required element is missing");
+        return;
+    }
+
+    if (op == MMXBA_OP_TYPE_NOTIFY)
+        req->opResCode = 0;
+
+    if ((secs & MMXBA_SEC_OBJECTS) && (s->seen & SEEN(E_OBJECTS)))
+    {
+        if (op == MMXBA_OP_TYPE_GETALL)
+            for (i = 0; i < req->getAll.objNum; i++)
+                mmxba_object_split_keys(req->getAll.objects[i], req->getAll.objKeys[i],
+                                        req->getAll.beKeyNamesNum);
+        else
+            for (i = 0; i < req->addObj_resp.objNum; i++)
+                mmxba_object_split_keys(req->addObj_resp.objects[i], req->addObj_resp.objKeys[i],
+                                        req->addObj_resp.beKeyNamesNum);
+    }
+
+    mmxba_message_finish(req, s->isRequest);
+}
+
+/* Handles the end tag of the element which is not skipped */
+static void elem_close(mmxba_stream_t *s, uint8_t id)
+{
+    mmxba_request_t *req = s->req;
+    unsigned int depth = s->depth;      /* the element is still pushed */
+    nvpair_t *pnv;
+    char *obj;
+    uint16_t nameId;
+
+    if (s->text && s->text_len < s->text_size)
+        s->text[s->text_len] = '\0';
+
+    if (depth == 1)
+        message_end(s);
+    else if (depth == 2)
+    {
+        if (s->arr)
+        {
+            if (s->arr_num != s->arr_size)
+                stream_fail(s, MMXBA_INVALID_FORMAT,
+                            "number of parameters does not match arraySize attribute");
+            s->arr = 0;
+        }
+        else
+            scalar_done(s, id);
+        s->seen |= SEEN(id);
+    }
+    else if (depth == 3 && id == E_NVPAIR)
+    {
+        if (s->item_parts != (ITEM_NAME | ITEM_VALUE))
+            stream_fail(s, MMXBA_INVALID_FORMAT, "incorrect syntax: pair name or value missing");
+        s->arr_num++;
+    }
+    else if (depth == 3 && id == E_NAME)
+    {
+        if (name_done(s, &nameId) == MMXBA_OK && s->ids)
+            s->ids[s->arr_num] = nameId;
+        s->arr_num++;
+    }
+    else if (depth == 3 && id == E_OBJKEYVALUES)
+    {
+        if (req->op_type == MMXBA_OP_TYPE_GETALL)
+        {
+            obj = req->getAll.objects[s->arr_num];
+            req->getAll.objRemoved[s->arr_num] = req->getAll.isDelta ? s->a_removed : FALSE;
+            if (s->arr_num > 0 && req->getAll.objEnc == MMXBA_OBJ_ENC_FRONT &&
+                mmxba_front_expand(obj, req->getAll.objects[s->arr_num - 1],
+                                   s->a_prefix[0] ? s->a_prefix : NULL) != MMXBA_OK)
+                stream_fail(s, MMXBA_INVALID_FORMAT, "bad front coded object");
+        }
+        s->arr_num++;
+    }
+    else if (depth == 4 && id == E_NAME)
+    {
+        if (name_done(s, &s->ids[s->arr_num]) == MMXBA_OK && s->text_len == 0 &&
+            s->a_id[0] == '\0')
+            stream_fail(s, MMXBA_INVALID_FORMAT, "incorrect syntax: pair name missing");
+        s->item_parts |= ITEM_NAME;
+    }
+    else if (depth == 4 && id == E_VALUE)
+    {
+        pnv = &s->pairs[s->arr_num];
+        pnv->pValue = s->text;
+        req->mem_pool.curr_offset += s->text_len + 1;
+        if (s->typed)
+            mmx_backapi_value_decode(s->a_type[0] ? s->a_type : NULL, pnv->pValue,
+                                     &req->valTypes[s->arr_num], &req->valNums[s->arr_num]);
+        s->item_parts |= ITEM_VALUE;
+    }
+
+    s->text = NULL;
+}
+
+static void tag_start(mmxba_stream_t *s, int empty)
+{
+    uint8_t id = elem_id(s);
+
+    if (s->depth == MMXBA_STREAM_MAX_DEPTH)
+    {
+        stream_fail(s, MMXBA_INVALID_FORMAT, "elements are nested too deep");
+        return;
+    }
+
+    if (s->skip_depth == 0 && !elem_open(s, id))
+        s->skip_depth = s->depth + 1;
+
+    s->elems[s->depth++] = id;
+    s->state = ST_TEXT;
+
+    if (empty)
+    {
+        if (s->skip_depth == 0)
+            elem_close(s, id);
+        if (s->skip_depth == s->depth)
+            s->skip_depth = 0;
+        s->depth--;
+        if (s->depth == 0)
+            s->state = ST_DONE;
+    }
+}
+
+static void tag_end(mmxba_stream_t *s)
+{
+    uint8_t id = elem_id(s);
+
+    if (s->depth == 0 || s->elems[s->depth - 1] != id)
+    {
+        stream_fail(s, MMXBA_INVALID_FORMAT, "mismatched end tag");
+        return;
+    }
+
+    if (s->skip_depth == 0)
+        elem_close(s, id);
+    else if (s->skip_depth == s->depth)
+        s->skip_depth = 0;
+
+    s->depth--;
+    s->state = (s->depth == 0) ? ST_DONE : ST_TEXT;
+}
+
+/* Feeds the chars to the lexer until the end of the message */
+static size_t stream_lex(mmxba_stream_t *s, const char *data, size_t len)
+{
+    size_t i;
+    char c;
+
+    for (i = 0; i < len && s->status == MMXBA_OK && s->state != ST_DONE; i++)
+    {
+        c = data[i];
+
+        switch (s->state)
+        {
+        case ST_TEXT:
+            if (c == '<')
+                s->state = ST_LT;
+            else if (c == '&' && s->text)
+            {
+                s->ent_len = 0;
+                s->ent_ret = ST_TEXT;
+                s->state = ST_ENTITY;
+            }
+            else if (c != '\0' || s->depth > 0)
+                text_put(s, c);
+            break;
+
+        case ST_LT:
+            if (c == '/')
+            {
+                s->tag_len = 0;
+                s->tag[0] = '\0';
+                s->state = ST_END_NAME;
+            }
+            else if (c == '?')
+            {
+                s->skip_match = 0;
+                s->state = ST_PI;
+            }
+            else if (c == '!')
+            {
+                s->skip_match = 0;
+                s->state = ST_BANG;
+            }
+            else if (!is_space(c) && c != '>')
+            {
+                s->tag_len = 0;
+                name_put(s->tag, &s->tag_len, sizeof(s->tag), c);
+                attrs_reset(s);
+                s->state = ST_START_NAME;
+            }
+            else
+                stream_fail(s, MMXBA_INVALID_FORMAT, "bad tag");
+            break;
+
+        case ST_START_NAME:
+            if (is_space(c))
+                s->state = ST_ATTRS;
+            else if (c == '>')
+                tag_start(s, FALSE);
+            else if (c == '/')
+                s->state = ST_EMPTY_END;
+            else
+                name_put(s->tag, &s->tag_len, sizeof(s->tag), c);
+            break;
+
+        case ST_ATTRS:
+            if (c == '>')
+                tag_start(s, FALSE);
+            else if (c == '/')
+                s->state = ST_EMPTY_END;
+            else if (!is_space(c))
+            {
+                s->attr_len = 0;
+                name_put(s->attr, &s->attr_len, sizeof(s->attr), c);
+                s->state = ST_ATTR_NAME;
+            }
+            break;
+
+        case ST_ATTR_NAME:
+            if (c == '=')
+                s->state = ST_ATTR_QUOTE;
+            else if (is_space(c))
+                s->state = ST_ATTR_EQ;
+            else
+                name_put(s->attr, &s->attr_len, sizeof(s->attr), c);
+            break;
+
+        case ST_ATTR_EQ:
+            if (c == '=')
+                s->state = ST_ATTR_QUOTE;
+            else if (!is_space(c))
+                stream_fail(s, MMXBA_INVALID_FORMAT, "bad attribute");
+            break;
+
+        case ST_ATTR_QUOTE:
+            if (c == '"' || c == '\'')
+            {
+                s->quote = c;
+                s->val_len = 0;
+                s->state = ST_ATTR_VALUE;
+            }
+            else if (!is_space(c))
+                stream_fail(s, MMXBA_INVALID_FORMAT, "bad attribute");
+            break;
+
+        case ST_ATTR_VALUE:
+            if (c == s->quote)
+            {
+                attr_done(s);
+                s->state = ST_ATTRS;
+            }
+            else if (c == '&')
+            {
+                s->ent_len = 0;
+                s->ent_ret = ST_ATTR_VALUE;
+                s->state = ST_ENTITY;
+            }
+            else if (c == '<')
+                stream_fail(s, MMXBA_INVALID_FORMAT, "bad attribute");
+            else
+                val_put(s, c);
+            break;
+
+        case ST_EMPTY_END:
+            if (c == '>')
+                tag_start(s, TRUE);
+            else
+                stream_fail(s, MMXBA_INVALID_FORMAT, "bad tag");
+            break;
+
+        case ST_END_NAME:
+            if (c == '>')
+                tag_end(s);
+            else if (is_space(c))
+                s->state = ST_END_WS;
+            else
+                name_put(s->tag, &s->tag_len, sizeof(s->tag), c);
+            break;
+
+        case ST_END_WS:
+            if (c == '>')
+                tag_end(s);
+            else if (!is_space(c))
+                stream_fail(s, MMXBA_INVALID_FORMAT, "bad tag");
+            break;
+
+        case ST_BANG:
+            if (c != '-')
+                stream_fail(s, MMXBA_INVALID_FORMAT, "CDATA and DOCTYPE are not supported");
+            else if (++s->skip_match == 2)
+            {
+                s->skip_match = 0;
+                s->state = ST_COMMENT;
+            }
+            break;
+
+        case ST_COMMENT:
+            if (c == '>' && s->skip_match >= 2)
+                s->state = ST_TEXT;
+            else if (c == '-')
+                s->skip_match++;
+            else
+                s->skip_match = 0;
+            break;
+
+        case ST_PI:
+            if (c == '>' && s->skip_match)
+                s->state = ST_TEXT;
+            else
+                s->skip_match = (c == '?');
+            break;
+
+        case ST_ENTITY:
+            if (c == ';')
+            {
+                s->state = s->ent_ret;
+                entity_decode(s);
+            }
+            else if (s->ent_len < sizeof(s->ent) - 1)
+                s->ent[s->ent_len++] = c;
+            else
+                stream_fail(s, MMXBA_INVALID_FORMAT, "bad entity");
+            break;
+        }
+    }
+
+    return i;
+}
+
+/* Starts parsing of the next message */
+static void stream_start(mmxba_stream_t *s)
+{
+    s->status = MMXBA_OK;
+    s->state = s->framed ? ST_FRAME_HDR : ST_TEXT;
+    s->hdr_len = 0;
+    s->depth = 0;
+    s->skip_depth = 0;
+    s->text = NULL;
+    s->arr = 0;
+    s->seen = 0;
+}
+
+/* ------------------------------------------------------------------- */
+/*  ----------------  MMX stream parser API functions  ----------------*/
+/* ------------------------------------------------------------------- */
+void mmx_backapi_stream_init(mmxba_stream_t *s, mmxba_request_t *req, int framed)
+{
+    memset(s, 0, sizeof(*s));
+    s->req = req;
+    s->framed = framed;
+    stream_start(s);
+}
+
+int mmx_backapi_stream_feed(mmxba_stream_t *s, const char *data, size_t len, size_t *used)
+{
+    size_t i = 0, n;
+
+    while (i < len && s->status == MMXBA_OK && !mmx_backapi_stream_complete(s))
+    {
+        if (!s->framed)
+        {
+            i += stream_lex(s, data + i, len - i);
+            continue;
+        }
+
+        if (s->state == ST_FRAME_HDR)
+        {
+            s->hdr[s->hdr_len++] = data[i++];
+            if (s->hdr_len < MMXBA_STREAM_FRAME_HDR_SIZE)
+                continue;
+
+            memcpy(&s->frame_left, s->hdr, sizeof(s->frame_left));
+            s->frame_left = ntohl(s->frame_left);
+            if (s->frame_left == 0 || s->frame_left > MMXBA_MAX_MSG_SIZE)
+                stream_fail(s, MMXBA_INVALID_FORMAT, "bad frame length");
+            else
+                s->state = ST_TEXT;
+            continue;
+        }
+
+        n = (len - i < s->frame_left) ? len - i : s->frame_left;
+
+        /* The rest of the frame after the message (or after the broken
+           message) is skipped */
+        if (s->state != ST_DONE && s->state != ST_SKIP)
+            n = stream_lex(s, data + i, n);
+
+        i += n;
+        s->frame_left -= n;
+
+        if (s->state == ST_SKIP && s->frame_left == 0)
+            stream_start(s);
+        else if (s->frame_left == 0 && s->state != ST_DONE)
+            stream_fail(s, MMXBA_INVALID_FORMAT, "message is truncated by the frame");
+    }
+
+    *used = i;
+    return s->status;
+}
+
+int mmx_backapi_stream_complete(const mmxba_stream_t *s)
+{
+    return s->status == MMXBA_OK && s->state == ST_DONE &&
+           (!s->framed || s->frame_left == 0);
+}
+
+int mmx_backapi_stream_next(mmxba_stream_t *s)
+{
+    int status = MMXBA_OK;
+
+    if (s->status != MMXBA_OK)
+    {
+        /* The rest of the broken frame is skipped if its length is known */
+        if (!s->framed || s->state == ST_FRAME_HDR)
+            GOTO_RET_WITH_ERROR(s->status, "Stream parser: stream cannot be resynchronized");
+
+        s->status = MMXBA_OK;
+        s->state = ST_SKIP;
+        if (s->frame_left == 0)
+            stream_start(s);
+        goto ret;
+    }
+
+    stream_start(s);
+
+ret:
+    return status;
+}
+
+void mmx_backapi_stream_frame_hdr(uint32_t len, char *hdr)
+{
+    uint32_t n = htonl(len);
+
+    memcpy(hdr, &n, sizeof(n));
+}
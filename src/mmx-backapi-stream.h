@@ -0,0 +1,217 @@
+/* mmx-backapi-stream.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Incremental (push) parser of MMX backend API messages for stream
+ * transports.
+ *
+ * The parser accepts the message in chunks of any size as they are read
+ * from the socket and fills mmxba_request_t as the elements arrive, so
+ * the message is never reassembled in one buffer: param values are
+ * unescaped directly to the memory pool of the request, other fields are
+ * written to the request structure. The parser keeps bounded state (the
+ * current tag, attribute and entity) and never refers to the fed chunks
+ * after mmx_backapi_stream_feed() returns.
+ *
+ * Two kinds of framing are supported:
+ *   - unframed: the message ends with the end tag of its root element,
+ *     whitespace and NUL characters between the messages are skipped;
+ *   - framed: every message is preceded by its length (4 bytes, network
+ *     byte order, see mmx_backapi_stream_frame_hdr()), so a broken
+ *     message can be skipped and the stream stays usable.
+ *
+ * The result is the same as of mmx_backapi_message_parse() for messages
+ * built by this library. CDATA sections and DOCTYPE are not supported;
+ * comments and processing instructions are skipped.
+ *
+ * Usage:
+ *     mmx_backapi_stream_init(&s, req, TRUE);
+ *     while ((n = read(fd, buf, sizeof(buf))) > 0)
+ *         for (off = 0; off < n; off += used)
+ *         {
+ *             if (mmx_backapi_stream_feed(&s, buf + off, n - off, &used) != MMXBA_OK)
+ *                 ... the message is broken, skip it by mmx_backapi_stream_next()
+ *             else if (mmx_backapi_stream_complete(&s))
+ *                 ... process req, then mmx_backapi_stream_next(&s)
+ *         }
+ *
+ * The param values of every message are added to the memory pool of req,
+ * so the caller must reset req->mem_pool.curr_offset to 0 before the next
+ * message (when req is processed); otherwise the pool runs out after a few
+ * messages.
+ */
+
+#ifndef MMX_BACKAPI_STREAM_H_
+#define MMX_BACKAPI_STREAM_H_
+
+#include <stdint.h>
+
+#include "mmx-backapi.h"
+
+#define MMXBA_STREAM_FRAME_HDR_SIZE   4
+
+#define MMXBA_STREAM_MAX_DEPTH        8     /* nesting of elements       */
+#define MMXBA_STREAM_TAG_LEN          24    /* longer names are unknown  */
+#define MMXBA_STREAM_ATTR_LEN         24    /* longer values are cut     */
+
+typedef struct mmxba_stream_s {
+    mmxba_request_t  *req;
+    int              framed;
+    int              state;         /* lexer state                          */
+    int              status;        /* MMXBA_OK or failure of the message   */
+
+    /* Framing */
+    uint8_t          hdr[MMXBA_STREAM_FRAME_HDR_SIZE];
+    unsigned int     hdr_len;
+    uint32_t         frame_left;    /* bytes of the frame not fed yet       */
+
+    /* Lexer: the current tag, attribute and entity */
+    char             tag[MMXBA_STREAM_TAG_LEN];
+    unsigned int     tag_len;
+    char             attr[MMXBA_STREAM_TAG_LEN];
+    unsigned int     attr_len;
+    char             val[MMXBA_STREAM_ATTR_LEN];
+    unsigned int     val_len;
+    char             quote;
+    char             ent[12];
+    unsigned int     ent_len;
+    int              ent_ret;       /* state to return after the entity     */
+    unsigned int     skip_match;    /* matched chars of "-->" or "?>"       */
+
+    /* Open elements and the attributes of the last started one */
+    uint8_t          elems[MMXBA_STREAM_MAX_DEPTH];
+    unsigned int     depth;
+    unsigned int     skip_depth;    /* depth of the ignored subtree (0-none) */
+    long             a_size;        /* arraySize, -1 - not set              */
+    char             a_id[8];       /* name id                              */
+    char             a_type[12];    /* value type                           */
+    char             a_prefix[8];   /* front coding prefix length           */
+    char             a_dict[12];    /* dictionary checksum                  */
+    uint8_t          a_removed;
+    uint8_t          a_delta;
+    uint8_t          a_front;
+
+    /* Text of the current element: scalar fields are collected in buf,
+       names and objects are written in place, values - to the pool */
+    char             *text;
+    size_t           text_size;
+    size_t           text_len;
+    int              text_pool;
+    char             buf[MMXBA_MAX_STR_LEN];
+
+    /* The current array element and its item */
+    uint8_t          arr;
+    uint32_t         arr_size;
+    uint32_t         arr_num;       /* parsed items                         */
+    nvpair_t         *pairs;
+    char             (*names)[MMXBA_MAX_STR_LEN];
+    uint16_t         *ids;
+    int              typed;
+    uint8_t          item_parts;    /* name and value of the nvPair item    */
+
+    /* Message */
+    int              isRequest;
+    const struct mmxba_dict_s *dict;
+    int              sameDict;
+    uint32_t         seen;          /* mask of the parsed elements          */
+} mmxba_stream_t;
+
+
+/*
+ * Initializes the parser of messages to the request structure (its memory
+ * pool must be initialized). framed - messages are length-prefixed.
+ */
+void mmx_backapi_stream_init(mmxba_stream_t *s, mmxba_request_t *req, int framed);
+
+/*
+ * Parses the next chunk of the stream. Stops at the end of the message:
+ * the number of the parsed bytes is returned in *used, the rest of the
+ * chunk belongs to the next message and must be fed again after
+ * mmx_backapi_stream_next(). A failure is returned for the broken message.
+ */
+int mmx_backapi_stream_feed(mmxba_stream_t *s, const char *data, size_t len, size_t *used);
+
+/*
+ * Returns TRUE if the request is filled by the complete message
+ */
+int mmx_backapi_stream_complete(const mmxba_stream_t *s);
+
+/*
+ * Prepares the parser for the next message after the complete or broken
+ * one. The rest of the broken framed message is skipped by the next feeds;
+ * broken unframed stream cannot be resynchronized: its failure is returned
+ * and the stream must be closed.
+ */
+int mmx_backapi_stream_next(mmxba_stream_t *s);
+
+/*
+ * Writes the frame header of the message of len bytes
+ */
+void mmx_backapi_stream_frame_hdr(uint32_t len, char *hdr);
+
+#endif /* MMX_BACKAPI_STREAM_H_ */
@@ -0,0 +1,497 @@
+/* mmx-backapi-transport.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Batched socket transport of MMX backend API messages.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-transport.h"
+
+#define RX_BUFF_SIZE    (MMXBA_MAX_MSG_SIZE + 1)
+
+
+/* ------------------------------------------------------------------- */
+/*  -----------  MMX transport internal functions     -----------------*/
+/* ------------------------------------------------------------------- */
+
+/* Allocates the batch buffers and prepares the constant parts of the
+   receive message headers */
+static int transport_init(mmxba_transport_t *tr, int fd, mmxba_transport_type_t type)
+{
+    int status = MMXBA_OK;
+    unsigned int i;
+    const unsigned int n = MMXBA_TRANSPORT_BATCH_SIZE;
+
+    memset(tr, 0, sizeof(*tr));
+    tr->fd = fd;
+    tr->type = type;
+
+    tr->rx_buffs = malloc((size_t)n * RX_BUFF_SIZE);
+    tr->rx_msgs  = calloc(n, sizeof(struct mmsghdr));
+    tr->rx_iov   = calloc(n, sizeof(struct iovec));
+    tr->rx_addrs = calloc(n, sizeof(mmxba_sockaddr_t));
+    tr->tx_msgs  = calloc(n, sizeof(struct mmsghdr));
+    tr->tx_iov   = calloc(2 * n, sizeof(struct iovec));
+    tr->tx_addrs = calloc(n, sizeof(mmxba_sockaddr_t));
+
+    if (!tr->rx_buffs || !tr->rx_msgs || !tr->rx_iov || !tr->rx_addrs ||
+        !tr->tx_msgs || !tr->tx_iov || !tr->tx_addrs)
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "%s: Could not allocate transport buffers",
+                            __func__);
+
+    for (i = 0; i < n; i++)
+    {
+        tr->rx_iov[i].iov_base = tr->rx_buffs + (size_t)i * RX_BUFF_SIZE;
+        tr->rx_iov[i].iov_len  = MMXBA_MAX_MSG_SIZE;
+        tr->rx_msgs[i].msg_hdr.msg_iov = &tr->rx_iov[i];
+        tr->rx_msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+ret:
+    if (status != MMXBA_OK)
+        mmx_backapi_transport_close(tr);   /* closes fd too */
+    return status;
+}
+
+
+/* ------------------------------------------------------------------- */
+/*  ----------------  MMX transport API functions     -----------------*/
+/* ------------------------------------------------------------------- */
+void mmx_backapi_transport_udp_addr(mmxba_sockaddr_t *addr, unsigned short port)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->in.sin_family = AF_INET;
+    addr->in.sin_port = htons(port);
+    inet_pton(AF_INET, MMXBA_EP_ADDR, &addr->in.sin_addr);
+}
+
+int mmx_backapi_transport_udp_open(mmxba_transport_t *tr, unsigned short port)
+{
+    int status = MMXBA_OK;
+    int fd = -1;
+    mmxba_sockaddr_t addr;
+
+    if (tr == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    if ((fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0)) < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not create UDP socket: %s",
+                            strerror(errno));
+
+    mmx_backapi_transport_udp_addr(&addr, port);
+    if (bind(fd, &addr.sa, sizeof(addr.in)) < 0)
+    {
+        close(fd);
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not bind UDP socket to port %u: %s",
+                            port, strerror(errno));
+    }
+
+    status = transport_init(tr, fd, MMXBA_TRANSPORT_UDP);
+
+ret:
+    return status;
+}
+
+int mmx_backapi_transport_unix_listen(const char *path, int *listen_fd)
+{
+    int status = MMXBA_OK;
+    int fd = -1;
+    mmxba_sockaddr_t addr;
+
+    if (path == NULL || listen_fd == NULL || strlen(path) >= sizeof(addr.un.sun_path))
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    if ((fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0)) < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not create unix socket: %s",
+                            strerror(errno));
+
+    memset(&addr, 0, sizeof(addr));
+    addr.un.sun_family = AF_UNIX;
+    strcpy_safe(addr.un.sun_path, path, sizeof(addr.un.sun_path));
+    unlink(path);
+
+    if (bind(fd, &addr.sa, sizeof(addr.un)) < 0 || listen(fd, SOMAXCONN) < 0)
+    {
+        close(fd);
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not listen on unix socket %s: %s",
+                            path, strerror(errno));
+    }
+
+    *listen_fd = fd;
+
+ret:
+    return status;
+}
+
+int mmx_backapi_transport_unix_accept(mmxba_transport_t *tr, int listen_fd)
+{
+    int status = MMXBA_OK;
+    int fd = -1;
+
+    if (tr == NULL || listen_fd < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    if ((fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC)) < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not accept unix connection: %s",
+                            strerror(errno));
+
+    status = transport_init(tr, fd, MMXBA_TRANSPORT_UNIX);
+
+ret:
+    return status;
+}
+
+int mmx_backapi_transport_unix_connect(mmxba_transport_t *tr, const char *path)
+{
+    int status = MMXBA_OK;
+    int fd = -1;
+    mmxba_sockaddr_t addr;
+
+    if (tr == NULL || path == NULL || strlen(path) >= sizeof(addr.un.sun_path))
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    if ((fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0)) < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not create unix socket: %s",
+                            strerror(errno));
+
+    memset(&addr, 0, sizeof(addr));
+    addr.un.sun_family = AF_UNIX;
+    strcpy_safe(addr.un.sun_path, path, sizeof(addr.un.sun_path));
+
+    if (connect(fd, &addr.sa, sizeof(addr.un)) < 0)
+    {
+        close(fd);
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not connect to unix socket %s: %s",
+                            path, strerror(errno));
+    }
+
+    status = transport_init(tr, fd, MMXBA_TRANSPORT_UNIX);
+
+ret:
+    return status;
+}
+
+int mmx_backapi_transport_close(mmxba_transport_t *tr)
+{
+    if (tr == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    if (tr->fd >= 0)
+        close(tr->fd);
+
+    free(tr->rx_buffs);
+    free(tr->rx_msgs);
+    free(tr->rx_iov);
+    free(tr->rx_addrs);
+    free(tr->tx_msgs);
+    free(tr->tx_iov);
+    free(tr->tx_addrs);
+
+    memset(tr, 0, sizeof(*tr));
+    tr->fd = -1;
+
+    return MMXBA_OK;
+}
+
+int mmx_backapi_transport_recv(mmxba_transport_t *tr, int wait, unsigned int *count)
+{
+    int status = MMXBA_OK;
+    int res;
+    unsigned int i;
+
+    if (tr == NULL || tr->fd < 0 || count == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    *count = tr->rx_count = 0;
+
+    /* Only msg_namelen and msg_flags are changed by the kernel */
+    for (i = 0; i < MMXBA_TRANSPORT_BATCH_SIZE; i++)
+    {
+        struct msghdr *hdr = &tr->rx_msgs[i].msg_hdr;
+
+        if (tr->type == MMXBA_TRANSPORT_UDP)
+        {
+            hdr->msg_name = &tr->rx_addrs[i];
+            hdr->msg_namelen = sizeof(mmxba_sockaddr_t);
+        }
+        hdr->msg_flags = 0;
+    }
+
+    do {
+        res = recvmmsg(tr->fd, tr->rx_msgs, MMXBA_TRANSPORT_BATCH_SIZE,
+                       wait ? MSG_WAITFORONE : MSG_DONTWAIT, NULL);
+    } while (res < 0 && errno == EINTR);
+
+    if (res < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            goto ret;
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not receive messages: %s",
+                            strerror(errno));
+    }
+
+    /* Null-terminate the received xml strings */
+    for (i = 0; i < (unsigned int)res; i++)
+        ((char *)tr->rx_iov[i].iov_base)[tr->rx_msgs[i].msg_len] = '\0';
+
+    *count = tr->rx_count = res;
+
+ret:
+    return status;
+}
+
+char *mmx_backapi_transport_rx_msg(mmxba_transport_t *tr, unsigned int i,
+                                   size_t *len, mmxba_sockaddr_t **peer)
+{
+    mmxba_packet_t *pkt;
+    unsigned int msg_len;
+
+    if (tr == NULL || i >= tr->rx_count)
+        return NULL;
+
+    msg_len = tr->rx_msgs[i].msg_len;
+    if (msg_len <= sizeof(pkt->flags) || (tr->rx_msgs[i].msg_hdr.msg_flags & MSG_TRUNC))
+    {
+        ing_log(LOG_ERR, "Malformed message of %u bytes is dropped\n", msg_len);
+        return NULL;
+    }
+
+    if (len)
+        *len = msg_len - sizeof(pkt->flags);
+    if (peer)
+        *peer = (tr->type == MMXBA_TRANSPORT_UDP) ? &tr->rx_addrs[i] : NULL;
+
+    pkt = (mmxba_packet_t *)tr->rx_iov[i].iov_base;
+    return pkt->msg;
+}
+
+int mmx_backapi_transport_send(mmxba_transport_t *tr, const mmxba_sockaddr_t *peer,
+                               const char *xml_string, size_t len)
+{
+    int status = MMXBA_OK;
+    struct msghdr *hdr;
+    struct iovec *iov;
+
+    if (tr == NULL || tr->fd < 0 || xml_string == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    if (tr->type == MMXBA_TRANSPORT_UDP && peer == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Peer address is not set", __func__);
+
+    if (len + sizeof(mmxba_flags) > MMXBA_MAX_MSG_SIZE)
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Message of %zu bytes is too long", len);
+
+    if (tr->tx_count == MMXBA_TRANSPORT_BATCH_SIZE &&
+        (status = mmx_backapi_transport_flush(tr)) != MMXBA_OK)
+        goto ret;
+
+    /* The flags header and the xml string are gathered by the kernel */
+    iov = &tr->tx_iov[2 * tr->tx_count];
+    iov[0].iov_base = mmxba_flags;
+    iov[0].iov_len  = sizeof(mmxba_flags);
+    iov[1].iov_base = (void *)xml_string;
+    iov[1].iov_len  = len;
+
+    hdr = &tr->tx_msgs[tr->tx_count].msg_hdr;
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->msg_iov = iov;
+    hdr->msg_iovlen = 2;
+    if (tr->type == MMXBA_TRANSPORT_UDP)
+    {
+        tr->tx_addrs[tr->tx_count] = *peer;
+        hdr->msg_name = &tr->tx_addrs[tr->tx_count];
+        hdr->msg_namelen = sizeof(struct sockaddr_in);
+    }
+
+    tr->tx_count++;
+
+ret:
+    return status;
+}
+
+int mmx_backapi_transport_flush(mmxba_transport_t *tr)
+{
+    int status = MMXBA_OK;
+    int res;
+    unsigned int sent = 0;
+
+    if (tr == NULL || tr->fd < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    while (sent < tr->tx_count)
+    {
+        res = sendmmsg(tr->fd, tr->tx_msgs + sent, tr->tx_count - sent, MSG_NOSIGNAL);
+        if (res < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            ing_log(LOG_ERR, "Could not send messages: %s (%u messages are dropped)\n",
+                    strerror(errno), tr->tx_count - sent);
+            status = MMXBA_SYSTEM_ERROR;
+            break;
+        }
+        sent += res;
+    }
+
+    tr->tx_count = 0;
+
+ret:
+    return status;
+}
+
+int mmx_backapi_transport_send_now(mmxba_transport_t *tr, const mmxba_sockaddr_t *peer,
+                                   const char *xml_string, size_t len)
+{
+    int status = MMXBA_OK;
+    struct iovec iov[2];
+    struct msghdr hdr;
+    ssize_t res;
+
+    if (tr == NULL || tr->fd < 0 || xml_string == NULL ||
+        (tr->type == MMXBA_TRANSPORT_UDP && peer == NULL))
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    if (len + sizeof(mmxba_flags) > MMXBA_MAX_MSG_SIZE)
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Message of %zu bytes is too long", len);
+
+    iov[0].iov_base = mmxba_flags;
+    iov[0].iov_len  = sizeof(mmxba_flags);
+    iov[1].iov_base = (void *)xml_string;
+    iov[1].iov_len  = len;
+
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.msg_iov = iov;
+    hdr.msg_iovlen = 2;
+    if (tr->type == MMXBA_TRANSPORT_UDP)
+    {
+        hdr.msg_name = (void *)peer;
+        hdr.msg_namelen = sizeof(struct sockaddr_in);
+    }
+
+    do {
+        res = sendmsg(tr->fd, &hdr, MSG_NOSIGNAL);
+    } while (res < 0 && errno == EINTR);
+
+    if (res < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not send message: %s", strerror(errno));
+
+ret:
+    return status;
+}
+
+int mmx_backapi_transport_sendv_now(mmxba_transport_t *tr, const mmxba_sockaddr_t *peer,
+                                    const struct iovec *iov, unsigned int iov_num)
+{
+    int status = MMXBA_OK;
+    struct iovec msg_iov[MMXBA_TRANSPORT_MAX_IOV + 1];
+    struct msghdr hdr;
+    size_t len = 0;
+    unsigned int i;
+    ssize_t res;
+
+    if (tr == NULL || tr->fd < 0 || iov == NULL || iov_num > MMXBA_TRANSPORT_MAX_IOV ||
+        (tr->type == MMXBA_TRANSPORT_UDP && peer == NULL))
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    msg_iov[0].iov_base = mmxba_flags;
+    msg_iov[0].iov_len  = sizeof(mmxba_flags);
+    for (i = 0; i < iov_num; i++)
+    {
+        msg_iov[i + 1] = iov[i];
+        len += iov[i].iov_len;
+    }
+
+    if (len + sizeof(mmxba_flags) > MMXBA_MAX_MSG_SIZE)
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Message of %zu bytes is too long", len);
+
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.msg_iov = msg_iov;
+    hdr.msg_iovlen = iov_num + 1;
+    if (tr->type == MMXBA_TRANSPORT_UDP)
+    {
+        hdr.msg_name = (void *)peer;
+        hdr.msg_namelen = sizeof(struct sockaddr_in);
+    }
+
+    do {
+        res = sendmsg(tr->fd, &hdr, MSG_NOSIGNAL);
+    } while (res < 0 && errno == EINTR);
+
+    if (res < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not send message: %s", strerror(errno));
+
+ret:
+    return status;
+}
@@ -0,0 +1,217 @@
+/* mmx-backapi-transport.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+/*
+ * Transport of MMX backend API messages between the Entry point and
+ * backends. The messages (mmxba_packet_t: flags + xml string) are received
+ * and sent in batches by recvmmsg/sendmmsg, the receive buffers are
+ * allocated once when the transport is opened and reused for every batch.
+ *
+ * Two socket types are supported:
+ *   - UDP socket bound on the loopback address (MMXBA_EP_ADDR)
+ *   - AF_UNIX socket of SOCK_SEQPACKET type (connection oriented, each
+ *     accepted or connected socket is a separate transport)
+ */
+
+#ifndef MMX_BACKAPI_TRANSPORT_H_
+#define MMX_BACKAPI_TRANSPORT_H_
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+
+#include "mmx-backapi.h"
+
+/* Max number of iovec entries of the message sent by
+   mmx_backapi_transport_sendv_now() */
+#define MMXBA_TRANSPORT_MAX_IOV     256
+
+typedef enum mmxba_transport_type_e {
+    MMXBA_TRANSPORT_UDP = 0,
+    MMXBA_TRANSPORT_UNIX
+} mmxba_transport_type_t;
+
+/* Address of the message peer */
+typedef union mmxba_sockaddr_u {
+    struct sockaddr     sa;
+    struct sockaddr_in  in;
+    struct sockaddr_un  un;
+} mmxba_sockaddr_t;
+
+typedef struct mmxba_transport_s {
+    int                     fd;
+    mmxba_transport_type_t  type;
+
+    /* Receive side: buffers are allocated once and reused by each batch.
+       Every buffer has MMXBA_MAX_MSG_SIZE + 1 bytes, so the received
+       xml string is always null-terminated */
+    char                    *rx_buffs;
+    struct mmsghdr          *rx_msgs;
+    struct iovec            *rx_iov;
+    mmxba_sockaddr_t        *rx_addrs;
+    unsigned int            rx_count;   /* messages in the last batch */
+
+    /* Send side: messages are not copied, each queued message refers to
+       the caller buffer until the queue is flushed */
+    struct mmsghdr          *tx_msgs;
+    struct iovec            *tx_iov;    /* 2 entries per message */
+    mmxba_sockaddr_t        *tx_addrs;
+    unsigned int            tx_count;   /* queued messages */
+
+    int                     refs;       /* references held by the users of
+                                           the transport (see dispatcher) */
+} mmxba_transport_t;
+
+
+/*
+ * Fills the UDP loopback address (MMXBA_EP_ADDR) with the specified port
+ */
+void mmx_backapi_transport_udp_addr(mmxba_sockaddr_t *addr, unsigned short port);
+
+/*
+ * Opens UDP transport bound on the loopback address and the specified
+ * port (0 - any free port is used)
+ */
+int mmx_backapi_transport_udp_open(mmxba_transport_t *tr, unsigned short port);
+
+/*
+ * Creates listening AF_UNIX socket of SOCK_SEQPACKET type on the specified
+ * path. The connections are accepted by mmx_backapi_transport_unix_accept()
+ */
+int mmx_backapi_transport_unix_listen(const char *path, int *listen_fd);
+
+/*
+ * Accepts the next connection on the listening AF_UNIX socket and opens
+ * the transport on it
+ */
+int mmx_backapi_transport_unix_accept(mmxba_transport_t *tr, int listen_fd);
+
+/*
+ * Connects to the AF_UNIX socket listening on the specified path and
+ * opens the transport on the connected socket
+ */
+int mmx_backapi_transport_unix_connect(mmxba_transport_t *tr, const char *path);
+
+/*
+ * Closes the transport socket and frees all its buffers.
+ * Messages that are still queued for sending are dropped.
+ */
+int mmx_backapi_transport_close(mmxba_transport_t *tr);
+
+/*
+ * Receives the next batch of messages (up to MMXBA_TRANSPORT_BATCH_SIZE)
+ * by one system call. If wait is TRUE the function blocks until at least
+ * one message is received, otherwise it returns immediately.
+ * The messages of the previous batch are overwritten.
+ * Number of the received messages is returned in *count.
+ */
+int mmx_backapi_transport_recv(mmxba_transport_t *tr, int wait, unsigned int *count);
+
+/*
+ * Returns null-terminated xml string of the i-th message of the last
+ * received batch, its length and the sender address (if peer is not NULL).
+ * NULL is returned for malformed (too short or truncated) messages.
+ */
+char *mmx_backapi_transport_rx_msg(mmxba_transport_t *tr, unsigned int i,
+                                   size_t *len, mmxba_sockaddr_t **peer);
+
+/*
+ * Queues xml message for sending to the peer (peer is ignored for AF_UNIX
+ * transport). The message is sent with mmxba_flags header and is not
+ * copied: the buffer must be kept unchanged until the queue is flushed.
+ * The queue is flushed automatically when it is full.
+ *
+ * All send functions fail with MMXBA_NOT_ENOUGH_MEMORY if the message with
+ * the header is longer than MMXBA_MAX_MSG_SIZE.
+ */
+int mmx_backapi_transport_send(mmxba_transport_t *tr, const mmxba_sockaddr_t *peer,
+                               const char *xml_string, size_t len);
+
+/*
+ * Sends all queued messages by a minimal number of system calls
+ */
+int mmx_backapi_transport_flush(mmxba_transport_t *tr);
+
+/*
+ * Sends one message immediately, bypassing the send queue. The function
+ * does not change the transport state, so it can be called by several
+ * threads at the same time.
+ */
+int mmx_backapi_transport_send_now(mmxba_transport_t *tr, const mmxba_sockaddr_t *peer,
+                                   const char *xml_string, size_t len);
+
+/*
+ * Sends one message given as iovec array (up to MMXBA_TRANSPORT_MAX_IOV
+ * entries, see mmx-backapi-emit.h) immediately by one system call: the
+ * entries are sent after mmxba_flags header without copying
+ */
+int mmx_backapi_transport_sendv_now(mmxba_transport_t *tr, const mmxba_sockaddr_t *peer,
+                                    const struct iovec *iov, unsigned int iov_num);
+
+#endif /* MMX_BACKAPI_TRANSPORT_H_ */
@@ -0,0 +1,544 @@
+/* mmx-backapi-value.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Typed parameter values: conversion, setters and getters.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <inttypes.h>
+
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-value.h"
+
+/* "YYYY-MM-DDThh:mm:ssZ" */
+#define DATETIME_LEN    20
+
+static const char *type_strs[MMXBA_VAL_TYPE_NUM] = {
+    MMXBA_STR_TYPE_STRING,
+    MMXBA_STR_TYPE_INT,
+    MMXBA_STR_TYPE_UINT64,
+    MMXBA_STR_TYPE_BOOL,
+    MMXBA_STR_TYPE_DATETIME,
+    MMXBA_STR_TYPE_BASE64,
+    MMXBA_STR_TYPE_XFER
+};
+
+static const char b64_chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+
+/* ------------------------------------------------------------------- */
+/*  -----------  MMX typed values internal functions  -----------------*/
+/* ------------------------------------------------------------------- */
+
+static int parse_int(const char *s, int64_t *v)
+{
+    char *end;
+
+    if (s == NULL || *s == '\0')
+        return MMXBA_INVALID_FORMAT;
+
+    errno = 0;
+    *v = strtoll(s, &end, 10);
+
+    return (errno || *end) ? MMXBA_INVALID_FORMAT : MMXBA_OK;
+}
+
+static int parse_uint64(const char *s, uint64_t *v)
+{
+    char *end;
+
+    if (s == NULL || *s == '\0' || *s == '-')
+        return MMXBA_INVALID_FORMAT;
+
+    errno = 0;
+    *v = strtoull(s, &end, 10);
+
+    return (errno || *end) ? MMXBA_INVALID_FORMAT : MMXBA_OK;
+}
+
+static int parse_bool(const char *s, int64_t *v)
+{
+    if (s == NULL)
+        return MMXBA_INVALID_FORMAT;
+
+    if (!strcmp(s, "1") || !strcmp(s, "true"))
+        *v = 1;
+    else if (!strcmp(s, "0") || !strcmp(s, "false"))
+        *v = 0;
+    else
+        return MMXBA_INVALID_FORMAT;
+
+    return MMXBA_OK;
+}
+
+/* Parses UTC "YYYY-MM-DDThh:mm:ss[.fraction][Z]" */
+static int parse_datetime(const char *s, int64_t *v)
+{
+    struct tm tm;
+    int n = 0;
+
+    if (s == NULL)
+        return MMXBA_INVALID_FORMAT;
+
+    memset(&tm, 0, sizeof(tm));
+    if (sscanf(s, "%4d-%2d-%2dT%2d:%2d:%2d%n", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+               &tm.tm_hour, &tm.tm_min, &tm.tm_sec, &n) != 6 || n == 0)
+        return MMXBA_INVALID_FORMAT;
+
+    s += n;
+    if (*s == '.')
+        for (s++; *s >= '0' && *s <= '9'; s++)
+            ;
+    if (*s == 'Z')
+        s++;
+    if (*s)
+        return MMXBA_INVALID_FORMAT;
+
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+    *v = (int64_t)timegm(&tm);
+
+    return MMXBA_OK;
+}
+
+/* Writes decimal digits of v backwards from end; returns the first one */
+static char *format_uint64(uint64_t v, char *end)
+{
+    do {
+        *--end = '0' + v % 10;
+        v /= 10;
+    } while (v);
+
+    return end;
+}
+
+static void format_digits(char *to, unsigned int v, int digits)
+{
+    while (digits-- > 0)
+    {
+        to[digits] = '0' + v % 10;
+        v /= 10;
+    }
+}
+
+/* Reserves size bytes (and the null character) of the pool for the value
+   of nvPair and sets its name and type; returns the value buffer */
+static char *value_reserve(mmxba_request_t *req, nvpair_t *nvPair, const char *name,
+                           size_t size, uint8_t type, int64_t num)
+{
+    int idx;
+
+    if (req == NULL || nvPair == NULL || name == NULL || !req->mem_pool.initialized)
+        return NULL;
+
+    if (size + 1 > (size_t)(req->mem_pool.size_bytes - req->mem_pool.curr_offset))
+    {
+        ing_log(LOG_ERR, "No space in back-api req pool (val len %zu)\n", size);
+        return NULL;
+    }
+
+    nvPair->pValue = req->mem_pool.pool + req->mem_pool.curr_offset;
+    nvPair->pValue[size] = '\0';
+    req->mem_pool.curr_offset += size + 1;
+    strcpy_safe(nvPair->name, name, sizeof(nvPair->name));
+
+    if ((idx = mmx_backapi_value_index(req, nvPair)) >= 0)
+    {
+        req->valTypes[idx] = type;
+        req->valNums[idx] = num;
+    }
+
+    return nvPair->pValue;
+}
+
+static int insert_number(mmxba_request_t *req, nvpair_t *nvPair, const char *name,
+                         uint64_t abs_value, int negative, uint8_t type, int64_t num)
+{
+    char buf[24], *s = format_uint64(abs_value, buf + sizeof(buf));
+    char *value;
+
+    if (negative)
+        *--s = '-';
+
+    if ((value = value_reserve(req, nvPair, name, buf + sizeof(buf) - s, type, num)) == NULL)
+        return MMXBA_NOT_ENOUGH_MEMORY;
+
+    memcpy(value, s, buf + sizeof(buf) - s);
+
+    return MMXBA_OK;
+}
+
+/* Returns type of typed value of nvPair, or string */
+static uint8_t value_type(const mmxba_request_t *req, const nvpair_t *nvPair, int *idx)
+{
+    *idx = mmx_backapi_value_index(req, nvPair);
+
+    return (*idx >= 0) ? req->valTypes[*idx] : MMXBA_VAL_TYPE_STRING;
+}
+
+
+/* Encodes len bytes of data to base64 string of MMXBA_BASE64_LEN(len)
+   characters (not null-terminated); returns number of the characters */
+size_t mmxba_base64_encode(const void *data, size_t len, char *out)
+{
+    const unsigned char *in = (const unsigned char *)data;
+    char *s = out;
+    uint32_t v;
+    size_t i;
+
+    for (i = 0; i + 2 < len; i += 3)
+    {
+        v = (in[i] << 16) | (in[i + 1] << 8) | in[i + 2];
+        *s++ = b64_chars[(v >> 18) & 0x3f];
+        *s++ = b64_chars[(v >> 12) & 0x3f];
+        *s++ = b64_chars[(v >> 6) & 0x3f];
+        *s++ = b64_chars[v & 0x3f];
+    }
+
+    if (i < len)
+    {
+        v = (in[i] << 16) | ((i + 1 < len) ? in[i + 1] << 8 : 0);
+        *s++ = b64_chars[(v >> 18) & 0x3f];
+        *s++ = b64_chars[(v >> 12) & 0x3f];
+        *s++ = (i + 1 < len) ? b64_chars[(v >> 6) & 0x3f] : '=';
+        *s++ = '=';
+    }
+
+    return s - out;
+}
+
+/* Decodes slen characters of base64 string s (whitespaces are skipped)
+   to data of *len bytes; on success *len is set to the decoded size */
+int mmxba_base64_decode(const char *s, size_t slen, void *data, size_t *len)
+{
+    unsigned char *out = (unsigned char *)data;
+    const char *end = s + slen, *p;
+    uint32_t v = 0;
+    size_t n = 0;
+    int bits = 0;
+
+    for (; s < end && *s && *s != '='; s++)
+    {
+        if (*s == ' ' || *s == '\n' || *s == '\r' || *s == '\t')
+            continue;
+        if ((p = strchr(b64_chars, *s)) == NULL)
+            return MMXBA_INVALID_FORMAT;
+
+        v = (v << 6) | (p - b64_chars);
+        bits += 6;
+        if (bits >= 8)
+        {
+            bits -= 8;
+            if (n == *len)
+                return MMXBA_NOT_ENOUGH_MEMORY;
+            out[n++] = (v >> bits) & 0xff;
+        }
+    }
+
+    *len = n;
+
+    return MMXBA_OK;
+}
+
+
+/* ------------------------------------------------------------------- */
+/*  ----------------  MMX typed values API functions  -----------------*/
+/* ------------------------------------------------------------------- */
+const char *mmx_backapi_value_type_str(uint8_t type)
+{
+    return (type < MMXBA_VAL_TYPE_NUM) ? type_strs[type] : MMXBA_STR_TYPE_STRING;
+}
+
+void mmx_backapi_value_decode(const char *type_str, const char *value,
+                              uint8_t *type, int64_t *num)
+{
+    uint64_t u;
+    int t, res = MMXBA_OK;
+
+    *type = MMXBA_VAL_TYPE_STRING;
+    *num = 0;
+
+    if (type_str == NULL)
+        return;
+
+    for (t = 0; t < MMXBA_VAL_TYPE_NUM; t++)
+        if (!strcmp(type_str, type_strs[t]))
+            break;
+
+    switch (t)
+    {
+    case MMXBA_VAL_TYPE_INT:      res = parse_int(value, num); break;
+    case MMXBA_VAL_TYPE_BOOL:     res = parse_bool(value, num); break;
+    case MMXBA_VAL_TYPE_DATETIME: res = parse_datetime(value, num); break;
+    case MMXBA_VAL_TYPE_UINT64:
+        res = parse_uint64(value, &u);
+        *num = (int64_t)u;
+        break;
+    case MMXBA_VAL_TYPE_XFER:
+        /* The value is the handle of the transfer */
+        if ((res = parse_uint64(value, &u)) == MMXBA_OK && (u == 0 || u > UINT32_MAX))
+            res = MMXBA_INVALID_FORMAT;
+        *num = (int64_t)u;
+        break;
+    case MMXBA_VAL_TYPE_BASE64:
+        break;
+    default:
+        return;
+    }
+
+    /* Badly formatted values stay strings */
+    if (res == MMXBA_OK)
+        *type = t;
+    else
+        *num = 0;
+}
+
+int mmx_backapi_value_index(const mmxba_request_t *req, const nvpair_t *nvPair)
+{
+    const nvpair_t *base = (req->op_type == MMXBA_OP_TYPE_ADDOBJ) ?
+                            req->addObj_req.paramValues : req->paramValues.paramValues;
+
+    if (nvPair < base || nvPair >= base + MMXBA_MAX_NUMBER_OF_SET_PARAMS)
+        return -1;
+
+    return nvPair - base;
+}
+
+int mmx_backapi_msgstruct_insert_int(mmxba_request_t *req, nvpair_t *nvPair,
+                                     const char *name, int64_t value)
+{
+    uint64_t abs_value = (value < 0) ? -(uint64_t)value : (uint64_t)value;
+
+    return insert_number(req, nvPair, name, abs_value, value < 0, MMXBA_VAL_TYPE_INT, value);
+}
+
+int mmx_backapi_msgstruct_insert_uint64(mmxba_request_t *req, nvpair_t *nvPair,
+                                        const char *name, uint64_t value)
+{
+    return insert_number(req, nvPair, name, value, FALSE, MMXBA_VAL_TYPE_UINT64,
+                         (int64_t)value);
+}
+
+int mmx_backapi_msgstruct_insert_bool(mmxba_request_t *req, nvpair_t *nvPair,
+                                      const char *name, int value)
+{
+    return insert_number(req, nvPair, name, value ? 1 : 0, FALSE, MMXBA_VAL_TYPE_BOOL,
+                         value ? 1 : 0);
+}
+
+int mmx_backapi_msgstruct_insert_datetime(mmxba_request_t *req, nvpair_t *nvPair,
+                                          const char *name, time_t value)
+{
+    struct tm tm;
+    char *s;
+
+    if (gmtime_r(&value, &tm) == NULL || tm.tm_year + 1900 > 9999 || tm.tm_year + 1900 < 0)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    if ((s = value_reserve(req, nvPair, name, DATETIME_LEN, MMXBA_VAL_TYPE_DATETIME,
+                           (int64_t)value)) == NULL)
+        return MMXBA_NOT_ENOUGH_MEMORY;
+
+    format_digits(s, tm.tm_year + 1900, 4);
+    s[4] = '-';
+    format_digits(s + 5, tm.tm_mon + 1, 2);
+    s[7] = '-';
+    format_digits(s + 8, tm.tm_mday, 2);
+    s[10] = 'T';
+    format_digits(s + 11, tm.tm_hour, 2);
+    s[13] = ':';
+    format_digits(s + 14, tm.tm_min, 2);
+    s[16] = ':';
+    format_digits(s + 17, tm.tm_sec, 2);
+    s[19] = 'Z';
+
+    return MMXBA_OK;
+}
+
+int mmx_backapi_msgstruct_insert_base64(mmxba_request_t *req, nvpair_t *nvPair,
+                                        const char *name, const void *data, size_t len)
+{
+    char *s;
+
+    if (data == NULL && len)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    if ((s = value_reserve(req, nvPair, name, MMXBA_BASE64_LEN(len),
+                           MMXBA_VAL_TYPE_BASE64, 0)) == NULL)
+        return MMXBA_NOT_ENOUGH_MEMORY;
+
+    mmxba_base64_encode(data, len, s);
+
+    return MMXBA_OK;
+}
+
+int mmx_backapi_msgstruct_get_int(const mmxba_request_t *req, const nvpair_t *nvPair,
+                                  int64_t *value)
+{
+    int idx;
+
+    if (req == NULL || nvPair == NULL || value == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    switch (value_type(req, nvPair, &idx))
+    {
+    case MMXBA_VAL_TYPE_INT:
+    case MMXBA_VAL_TYPE_BOOL:
+    case MMXBA_VAL_TYPE_DATETIME:
+        *value = req->valNums[idx];
+        return MMXBA_OK;
+    case MMXBA_VAL_TYPE_UINT64:
+        if (req->valNums[idx] < 0)
+            return MMXBA_INVALID_FORMAT;
+        *value = req->valNums[idx];
+        return MMXBA_OK;
+    default:
+        return parse_int(nvPair->pValue, value);
+    }
+}
+
+int mmx_backapi_msgstruct_get_uint64(const mmxba_request_t *req, const nvpair_t *nvPair,
+                                     uint64_t *value)
+{
+    int idx;
+
+    if (req == NULL || nvPair == NULL || value == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    switch (value_type(req, nvPair, &idx))
+    {
+    case MMXBA_VAL_TYPE_UINT64:
+        *value = (uint64_t)req->valNums[idx];
+        return MMXBA_OK;
+    case MMXBA_VAL_TYPE_INT:
+    case MMXBA_VAL_TYPE_BOOL:
+        if (req->valNums[idx] < 0)
+            return MMXBA_INVALID_FORMAT;
+        *value = (uint64_t)req->valNums[idx];
+        return MMXBA_OK;
+    default:
+        return parse_uint64(nvPair->pValue, value);
+    }
+}
+
+int mmx_backapi_msgstruct_get_bool(const mmxba_request_t *req, const nvpair_t *nvPair,
+                                   int *value)
+{
+    int64_t v;
+    int idx, res = MMXBA_OK;
+
+    if (req == NULL || nvPair == NULL || value == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    if (value_type(req, nvPair, &idx) == MMXBA_VAL_TYPE_BOOL)
+        v = req->valNums[idx];
+    else
+        res = parse_bool(nvPair->pValue, &v);
+
+    if (res == MMXBA_OK)
+        *value = (int)v;
+
+    return res;
+}
+
+int mmx_backapi_msgstruct_get_datetime(const mmxba_request_t *req, const nvpair_t *nvPair,
+                                       time_t *value)
+{
+    int64_t v;
+    int idx, res = MMXBA_OK;
+
+    if (req == NULL || nvPair == NULL || value == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    if (value_type(req, nvPair, &idx) == MMXBA_VAL_TYPE_DATETIME)
+        v = req->valNums[idx];
+    else
+        res = parse_datetime(nvPair->pValue, &v);
+
+    if (res == MMXBA_OK)
+        *value = (time_t)v;
+
+    return res;
+}
+
+int mmx_backapi_msgstruct_get_base64(const mmxba_request_t *req, const nvpair_t *nvPair,
+                                     void *data, size_t *len)
+{
+    const char *s;
+
+    if (req == NULL || nvPair == NULL || data == NULL || len == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    s = nvPair->pValue ? nvPair->pValue : "";
+
+    return mmxba_base64_decode(s, strlen(s), data, len);
+}
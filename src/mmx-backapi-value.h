@@ -0,0 +1,151 @@
+/* mmx-backapi-value.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+/*
+ * Typed parameter values.
+ *
+ * A value of nvPair may be sent with type attribute (int, uint64, bool,
+ * datetime, string or base64); untyped values are strings. The parser
+ * decodes numeric typed values (int, uint64, bool and datetime) once into
+ * req->valNums, so the getters return them without string conversion.
+ * The setters format the value directly into the message memory pool and
+ * set its type, so backends do not need sprintf.
+ *
+ * Values are referenced by their nvPair in paramValues (or in
+ * addObj_req.paramValues of ADDOBJ request). The datetime values are sent
+ * as UTC "YYYY-MM-DDThh:mm:ssZ" and decoded to seconds since the Epoch.
+ */
+
+#ifndef MMX_BACKAPI_VALUE_H_
+#define MMX_BACKAPI_VALUE_H_
+
+#include <stdint.h>
+#include <time.h>
+
+#include "mmx-backapi.h"
+
+/*
+ * Returns string of the value type used in the type attribute
+ */
+const char *mmx_backapi_value_type_str(uint8_t type);
+
+/*
+ * Decodes the value of type given by type attribute (NULL - string);
+ * used by the parser
+ */
+void mmx_backapi_value_decode(const char *type_str, const char *value,
+                              uint8_t *type, int64_t *num);
+
+/*
+ * Returns index of the value in the typed values arrays of the message,
+ * or -1 if nvPair is not a param value of the message
+ */
+int mmx_backapi_value_index(const mmxba_request_t *req, const nvpair_t *nvPair);
+
+/*
+ * Typed setters: insert name and formatted value to the nvPair of the
+ * message as mmx_backapi_msgstruct_insert_nvpair() does
+ */
+int mmx_backapi_msgstruct_insert_int(mmxba_request_t *req, nvpair_t *nvPair,
+                                     const char *name, int64_t value);
+
+int mmx_backapi_msgstruct_insert_uint64(mmxba_request_t *req, nvpair_t *nvPair,
+                                        const char *name, uint64_t value);
+
+int mmx_backapi_msgstruct_insert_bool(mmxba_request_t *req, nvpair_t *nvPair,
+                                      const char *name, int value);
+
+int mmx_backapi_msgstruct_insert_datetime(mmxba_request_t *req, nvpair_t *nvPair,
+                                          const char *name, time_t value);
+
+int mmx_backapi_msgstruct_insert_base64(mmxba_request_t *req, nvpair_t *nvPair,
+                                        const char *name, const void *data, size_t len);
+
+/*
+ * Typed getters. Values sent typed are returned as decoded by the parser;
+ * untyped values are converted from the string.
+ * MMXBA_INVALID_FORMAT is returned if the value cannot be converted.
+ */
+int mmx_backapi_msgstruct_get_int(const mmxba_request_t *req, const nvpair_t *nvPair,
+                                  int64_t *value);
+
+int mmx_backapi_msgstruct_get_uint64(const mmxba_request_t *req, const nvpair_t *nvPair,
+                                     uint64_t *value);
+
+int mmx_backapi_msgstruct_get_bool(const mmxba_request_t *req, const nvpair_t *nvPair,
+                                   int *value);
+
+int mmx_backapi_msgstruct_get_datetime(const mmxba_request_t *req, const nvpair_t *nvPair,
+                                       time_t *value);
+
+/*
+ * Decodes base64 value to data of size *len; *len is set to the decoded length
+ */
+int mmx_backapi_msgstruct_get_base64(const mmxba_request_t *req, const nvpair_t *nvPair,
+                                     void *data, size_t *len);
+
+#endif /* MMX_BACKAPI_VALUE_H_ */
@@ -0,0 +1,432 @@
+/* mmx-backapi-workers.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Worker threads runtime of backend request processing.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-workers.h"
+#include "mmx-backapi-xfer.h"
+
+/* Sleeping worker checks other queues at least with such period: the
+   wake up of an idle worker by a busy worker queue is not guaranteed */
+#define WORKER_IDLE_WAIT_MS     10
+
+#define QUEUE_MASK              (MMXBA_WORKERS_QUEUE_SIZE - 1)
+
+#if (MMXBA_WORKERS_QUEUE_SIZE & QUEUE_MASK)
+#error "MMXBA_WORKERS_QUEUE_SIZE must be power of 2"
+#endif
+
+
+/* ------------------------------------------------------------------- */
+/*  -----------  MMX workers internal functions       -----------------*/
+/* ------------------------------------------------------------------- */
+
+/* Queue functions are called under the worker lock */
+static int jobq_push(mmxba_jobq_t *q, mmxba_job_t *job)
+{
+    if (q->tail - q->head > QUEUE_MASK)
+        return FALSE;
+
+    q->jobs[q->tail++ & QUEUE_MASK] = job;
+    return TRUE;
+}
+
+static mmxba_job_t *jobq_take_first(mmxba_jobq_t *q)
+{
+    if (q->head == q->tail)
+        return NULL;
+
+    return q->jobs[q->head++ & QUEUE_MASK];
+}
+
+static void job_free(mmxba_job_t *job)
+{
+    mmx_backapi_dispatch_transport_release(job->tr);
+    free(job);
+}
+
+/* Finds value of beObjName element without parsing the whole message */
+static int peek_obj_name(const char *msg, char *name, size_t size)
+{
+    static const char tag[] = "<" MMXBA_STR_BEOBJNAME ">";
+    const char *s = strstr(msg, tag);
+    size_t i;
+
+    if (s == NULL)
+        return FALSE;
+
+    s += sizeof(tag) - 1;
+    for (i = 0; i < size - 1 && s[i] && s[i] != '<'; i++)
+        name[i] = s[i];
+    name[i] = '\0';
+
+    return TRUE;
+}
+
+static mmxba_job_t *worker_steal(mmxba_workers_t *pool, mmxba_worker_t *self)
+{
+    mmxba_job_t *job = NULL;
+    mmxba_worker_t *victim;
+    unsigned int i;
+
+    for (i = 1; i < pool->num && job == NULL; i++)
+    {
+        victim = &pool->workers[(self->id + i) % pool->num];
+
+        /* The request the victim would take next is stolen */
+        pthread_mutex_lock(&victim->lock);
+        job = mmx_backapi_prioq_pop(&victim->local, mmx_backapi_time_ms());
+        pthread_mutex_unlock(&victim->lock);
+    }
+
+    if (job)
+        self->stolen++;
+
+    return job;
+}
+
+static mmxba_job_t *worker_take(mmxba_worker_t *w)
+{
+    mmxba_job_t *job = jobq_take_first(&w->pinned);
+
+    return job ? job : mmx_backapi_prioq_pop(&w->local, mmx_backapi_time_ms());
+}
+
+static void worker_process(mmxba_worker_t *w, mmxba_job_t *job)
+{
+    mmxba_dispatcher_t *d = w->pool->d;
+    mmxba_emitter_t e;
+
+    mmx_backapi_emit_init(&e, w->resp_iov, MMXBA_TRANSPORT_MAX_IOV,
+                          w->resp, MMXBA_MAX_MSG_SIZE - sizeof(mmxba_flags));
+
+    if (mmx_backapi_dispatch_handlev(d, w->req, job->msg, &e) == MMXBA_OK &&
+        mmx_backapi_transport_sendv_now(job->tr, job->has_peer ? &job->peer : NULL,
+                                        e.iov, e.iov_num) == MMXBA_OK)
+        mmx_backapi_xfer_send(w->req, job->tr, job->has_peer ? &job->peer : NULL);
+
+    w->processed++;
+    job_free(job);
+}
+
+static void *worker_main(void *arg)
+{
+    mmxba_worker_t *w = (mmxba_worker_t *)arg;
+    mmxba_workers_t *pool = w->pool;
+    mmxba_job_t *job;
+    struct timespec ts;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&w->lock);
+        while ((job = worker_take(w)) == NULL && !pool->stop)
+        {
+            pthread_mutex_unlock(&w->lock);
+            job = worker_steal(pool, w);
+            pthread_mutex_lock(&w->lock);
+
+            if (job || (job = worker_take(w)) != NULL)
+                break;
+
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_nsec += WORKER_IDLE_WAIT_MS * 1000000L;
+            if (ts.tv_nsec >= 1000000000L)
+            {
+                ts.tv_sec++;
+                ts.tv_nsec -= 1000000000L;
+            }
+
+            w->sleeping = TRUE;
+            pthread_cond_timedwait(&w->cond, &w->lock, &ts);
+            w->sleeping = FALSE;
+        }
+        pthread_mutex_unlock(&w->lock);
+
+        if (job == NULL)
+            break;
+
+        worker_process(w, job);
+    }
+
+    return NULL;
+}
+
+/* Stops the started worker threads and frees all initialized workers */
+static void workers_shutdown(mmxba_workers_t *pool, unsigned int started,
+                             unsigned int inited)
+{
+    unsigned int i;
+    mmxba_worker_t *w;
+    mmxba_job_t *job;
+
+    for (i = 0; i < started; i++)
+    {
+        w = &pool->workers[i];
+        pthread_mutex_lock(&w->lock);
+        pool->stop = TRUE;
+        pthread_cond_signal(&w->cond);
+        pthread_mutex_unlock(&w->lock);
+    }
+
+    for (i = 0; i < started; i++)
+        pthread_join(pool->workers[i].thread, NULL);
+
+    for (i = 0; i < inited; i++)
+    {
+        w = &pool->workers[i];
+        while ((job = worker_take(w)) != NULL)
+            job_free(job);
+
+        pthread_mutex_destroy(&w->lock);
+        pthread_cond_destroy(&w->cond);
+        free(w->req);
+        free(w->mem_pool);
+        free(w->resp);
+    }
+
+    free(pool->workers);
+    memset(pool, 0, sizeof(*pool));
+}
+
+
+/* ------------------------------------------------------------------- */
+/*  ----------------  MMX workers API functions       -----------------*/
+/* ------------------------------------------------------------------- */
+int mmx_backapi_workers_start(mmxba_workers_t *pool, mmxba_dispatcher_t *d,
+                              unsigned int num, int pin)
+{
+    int status = MMXBA_OK;
+    unsigned int i, started = 0, inited = 0;
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    mmxba_worker_t *w;
+    cpu_set_t cpus;
+
+    if (pool == NULL || d == NULL || d->workers != NULL || num > MMXBA_WORKERS_MAX)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    if (ncpu < 1)
+        ncpu = 1;
+    if (num == 0)
+        num = (ncpu < MMXBA_WORKERS_MAX) ? ncpu : MMXBA_WORKERS_MAX;
+
+    /* Handlers are looked up by the workers concurrently */
+    if ((status = mmx_backapi_dispatch_seal(d)) != MMXBA_OK)
+        goto ret;
+
+    memset(pool, 0, sizeof(*pool));
+    pool->d = d;
+    pool->num = num;
+    if ((pool->workers = calloc(num, sizeof(mmxba_worker_t))) == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Could not allocate workers");
+
+    for (i = 0; i < num; i++)
+    {
+        w = &pool->workers[i];
+        w->pool = pool;
+        w->id = i;
+        pthread_mutex_init(&w->lock, NULL);
+        pthread_cond_init(&w->cond, NULL);
+        mmx_backapi_prioq_init(&w->local, NULL);
+        inited++;
+
+        w->req = calloc(1, sizeof(mmxba_request_t));
+        w->mem_pool = malloc(MMXBA_DISPATCH_POOL_SIZE);
+        w->resp = malloc(MMXBA_MAX_MSG_SIZE);
+        if (!w->req || !w->mem_pool || !w->resp)
+            GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Could not allocate worker buffers");
+
+        mmx_backapi_msgstruct_init(w->req, w->mem_pool, MMXBA_DISPATCH_POOL_SIZE);
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        w = &pool->workers[i];
+        if (pthread_create(&w->thread, NULL, worker_main, w) != 0)
+            GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not create worker thread %u", i);
+        started++;
+
+        if (pin)
+        {
+            CPU_ZERO(&cpus);
+            CPU_SET(i % ncpu, &cpus);
+            if (pthread_setaffinity_np(w->thread, sizeof(cpus), &cpus) != 0)
+                ing_log(LOG_WARNING, "Could not bind worker %u to CPU %ld\n", i, i % ncpu);
+        }
+    }
+
+    d->workers = pool;
+
+ret:
+    if (status != MMXBA_OK && pool && pool->workers)
+        workers_shutdown(pool, started, inited);
+    return status;
+}
+
+int mmx_backapi_workers_stop(mmxba_workers_t *pool)
+{
+    if (pool == NULL || pool->workers == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    if (pool->d && pool->d->workers == pool)
+        pool->d->workers = NULL;
+
+    workers_shutdown(pool, pool->num, pool->num);
+
+    return MMXBA_OK;
+}
+
+int mmx_backapi_workers_submit(mmxba_workers_t *pool, mmxba_transport_t *tr,
+                               const mmxba_sockaddr_t *peer, const char *msg,
+                               size_t len)
+{
+    int status = MMXBA_OK;
+    char name[MMXBA_MAX_STR_LEN];
+    mmxba_worker_t *w;
+    mmxba_job_t *job;
+    unsigned int i;
+    int queued = FALSE, pinned = FALSE, was_sleeping = FALSE;
+    mmxba_prio_t prio = MMXBA_PRIO_NORMAL;
+    uint64_t now_ms = 0;
+
+    if ((job = malloc(sizeof(mmxba_job_t) + len + 1)) == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Could not allocate job");
+
+    job->tr = tr;
+    job->has_peer = (peer != NULL);
+    if (peer)
+        job->peer = *peer;
+    job->len = len;
+    memcpy(job->msg, msg, len);
+    job->msg[len] = '\0';
+
+    /* Requests of serial objects always go to the same worker */
+    if (pool->d->serial_num && peek_obj_name(job->msg, name, sizeof(name)) &&
+        mmx_backapi_dispatch_is_serial(pool->d, name))
+    {
+        pinned = TRUE;
+        w = &pool->workers[mmx_backapi_strhash(name, 0) % pool->num];
+    }
+    else
+        w = &pool->workers[pool->next++ % pool->num];
+
+    if (!pinned)
+    {
+        prio = mmx_backapi_message_peek_prio(job->msg);
+        now_ms = mmx_backapi_time_ms();
+    }
+
+    __atomic_add_fetch(&tr->refs, 1, __ATOMIC_ACQ_REL);
+
+    pthread_mutex_lock(&w->lock);
+    if (pinned)
+        queued = jobq_push(&w->pinned, job);
+    else
+        queued = (mmx_backapi_prioq_push(&w->local, job, prio, now_ms) == MMXBA_OK);
+    was_sleeping = w->sleeping;
+    if (queued && was_sleeping)
+        pthread_cond_signal(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+
+    if (!queued)
+    {
+        pool->dropped++;
+        job_free(job);
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Queue of worker %u is full, request dropped",
+                            w->id);
+    }
+
+    /* The worker is busy: wake up an idle one to steal the request */
+    if (!pinned && !was_sleeping)
+    {
+        for (i = 0; i < pool->num; i++)
+        {
+            mmxba_worker_t *idle = &pool->workers[i];
+
+            if (idle != w && __atomic_load_n(&idle->sleeping, __ATOMIC_RELAXED))
+            {
+                pthread_mutex_lock(&idle->lock);
+                pthread_cond_signal(&idle->cond);
+                pthread_mutex_unlock(&idle->lock);
+                break;
+            }
+        }
+    }
+
+ret:
+    return status;
+}
@@ -0,0 +1,168 @@
+/* mmx-backapi-workers.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+/*
+ * Multi-threaded runtime of backend request processing.
+ *
+ * The dispatcher loop thread receives requests and passes them to a pool
+ * of worker threads (one per core by default). Every worker has its own
+ * request queue; the requests are distributed round-robin and an idle
+ * worker steals requests from the queues of busy workers. Requests of
+ * objects marked as serial (mmx_backapi_dispatch_set_serial()) are always
+ * queued to the same worker, selected by the object name, and are never
+ * stolen, so they are processed one by one in the order of receiving.
+ * Other requests are taken from the worker queue by their priority class
+ * (see mmx-backapi-prioq.h), so interactive requests overtake bulk ones.
+ *
+ * Every worker has its own request structure, memory pool and response
+ * buffer, and sends the response it has built by itself. The response is
+ * built as iovec array (see mmx-backapi-emit.h): param values are sent
+ * from the memory pool, only the markup is written to the response buffer.
+ */
+
+#ifndef MMX_BACKAPI_WORKERS_H_
+#define MMX_BACKAPI_WORKERS_H_
+
+#include <pthread.h>
+
+#include "mmx-backapi.h"
+#include "mmx-backapi-transport.h"
+#include "mmx-backapi-dispatch.h"
+#include "mmx-backapi-prioq.h"
+
+#define MMXBA_WORKERS_MAX           64
+#define MMXBA_WORKERS_QUEUE_SIZE    256     /* jobs per worker queue */
+
+/* Received request waiting for processing */
+typedef struct mmxba_job_s {
+    mmxba_transport_t  *tr;
+    mmxba_sockaddr_t   peer;
+    int                has_peer;
+    size_t             len;
+    char               msg[0];
+} mmxba_job_t;
+
+typedef struct mmxba_jobq_s {
+    mmxba_job_t   *jobs[MMXBA_WORKERS_QUEUE_SIZE];
+    unsigned int  head;     /* next job to take */
+    unsigned int  tail;     /* next free place  */
+} mmxba_jobq_t;
+
+typedef struct mmxba_worker_s {
+    pthread_t               thread;
+    struct mmxba_workers_s  *pool;
+    unsigned int            id;
+
+    pthread_mutex_t         lock;
+    pthread_cond_t          cond;
+    int                     sleeping;
+    mmxba_prioq_t           local;    /* may be stolen by other workers */
+    mmxba_jobq_t            pinned;   /* requests of serial objects     */
+
+    mmxba_request_t         *req;
+    char                    *mem_pool;
+    char                    *resp;    /* scratch buffer of the emitter */
+    struct iovec            resp_iov[MMXBA_TRANSPORT_MAX_IOV];
+
+    unsigned long           processed;
+    unsigned long           stolen;
+} mmxba_worker_t;
+
+typedef struct mmxba_workers_s {
+    mmxba_dispatcher_t  *d;
+    unsigned int        num;
+    unsigned int        next;     /* round-robin position */
+    int                 stop;
+    mmxba_worker_t      *workers;
+
+    unsigned long       dropped;  /* requests dropped on full queues */
+} mmxba_workers_t;
+
+
+/*
+ * Starts num worker threads (0 - one per online CPU) processing requests
+ * received by the dispatcher loop. If pin is TRUE, every worker is bound
+ * to its own CPU. All handlers must be registered before the start.
+ */
+int mmx_backapi_workers_start(mmxba_workers_t *pool, mmxba_dispatcher_t *d,
+                              unsigned int num, int pin);
+
+/*
+ * Stops and joins the worker threads; requests which are still queued
+ * are dropped. Must be called before the dispatcher is destroyed.
+ */
+int mmx_backapi_workers_stop(mmxba_workers_t *pool);
+
+/*
+ * Queues request received from the transport (called by the dispatcher
+ * loop thread). The message is copied to the job.
+ */
+int mmx_backapi_workers_submit(mmxba_workers_t *pool, mmxba_transport_t *tr,
+                               const mmxba_sockaddr_t *peer, const char *msg,
+                               size_t len);
+
+#endif /* MMX_BACKAPI_WORKERS_H_ */
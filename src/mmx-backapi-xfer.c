@@ -0,0 +1,411 @@
+/* mmx-backapi-xfer.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Out-of-band chunked transfer of large param values.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-xfer.h"
+#include "mmx-backapi-value.h"
+
+#define CHUNK_START     "<" MMXBA_STR_XFER_CHUNK
+#define CHUNK_END       "</" MMXBA_STR_XFER_CHUNK ">"
+
+/* Handle of the last transfer of the process */
+static uint32_t xfer_handle = 0;
+
+
+/* ------------------------------------------------------------------- */
+/* -----------  MMX chunked transfer internal functions  --------------*/
+/* ------------------------------------------------------------------- */
+
+static int xfer_done(const mmxba_xfer_out_t *x)
+{
+    return (x->offset == x->size && x->chunks > 0);
+}
+
+/* Removes the first transfer of the message and releases its data */
+static void xfer_drop_first(mmxba_request_t *req)
+{
+    mmxba_xfer_out_t *x = req->xferOut;
+
+    req->xferOut = x->next;
+    if (x->release)
+        x->release(x->data, x->ctx);
+}
+
+/* Returns the start of the chunk message, or NULL */
+static const char *chunk_start(const char *xml_string)
+{
+    const char *s = xml_string;
+
+    if (s == NULL)
+        return NULL;
+
+    while (*s == ' ' || *s == '\n' || *s == '\r' || *s == '\t')
+        s++;
+
+    if (strncmp(s, CHUNK_START, sizeof(CHUNK_START) - 1))
+        return NULL;
+    if (s[sizeof(CHUNK_START) - 1] != ' ' && s[sizeof(CHUNK_START) - 1] != '>')
+        return NULL;
+
+    return s;
+}
+
+/* Reads numeric attribute of the start tag [tag, tag_end) */
+static int chunk_attr(const char *tag, const char *tag_end, const char *name,
+                      uint64_t *value)
+{
+    size_t len = strlen(name);
+    const char *s;
+    char *end;
+
+    for (s = tag; (s = strstr(s, name)) != NULL && s < tag_end; s += len)
+    {
+        if (s[-1] != ' ' || s[len] != '=' || s[len + 1] != '"')
+            continue;
+
+        s += len + 2;
+        if (*s < '0' || *s > '9')
+            return MMXBA_INVALID_FORMAT;
+
+        *value = strtoull(s, &end, 10);
+
+        return (*end == '"') ? MMXBA_OK : MMXBA_INVALID_FORMAT;
+    }
+
+    return MMXBA_INVALID_FORMAT;
+}
+
+
+/* ------------------------------------------------------------------- */
+/*  ----------------  MMX chunked transfer API functions  -------------*/
+/* ------------------------------------------------------------------- */
+int mmx_backapi_msgstruct_insert_xfer(mmxba_request_t *req, nvpair_t *nvPair,
+                                      const char *name, const void *data, size_t size,
+                                      mmxba_xfer_release_t release, void *ctx)
+{
+    int status = MMXBA_OK;
+    mmxba_xfer_out_t *x, **last;
+    unsigned short offset;
+    uint32_t handle;
+    int idx;
+
+    if (req == NULL || nvPair == NULL || name == NULL || !req->mem_pool.initialized ||
+        (data == NULL && size))
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    /* The type of values out of the message arrays is not kept */
+    if ((idx = mmx_backapi_value_index(req, nvPair)) < 0)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: nvPair is not a message value",
+                            __func__);
+
+    offset = req->mem_pool.curr_offset;
+    if ((x = mmxba_pool_alloc(req, sizeof(*x))) == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "No space in back-api req pool (xfer)");
+
+    do
+        handle = __atomic_add_fetch(&xfer_handle, 1, __ATOMIC_RELAXED);
+    while (handle == 0);
+
+    if ((status = mmx_backapi_msgstruct_insert_uint64(req, nvPair, name, handle)) != MMXBA_OK)
+    {
+        req->mem_pool.curr_offset = offset;
+        goto ret;
+    }
+    req->valTypes[idx] = MMXBA_VAL_TYPE_XFER;
+
+    memset(x, 0, sizeof(*x));
+    x->handle = handle;
+    x->data = data;
+    x->size = size;
+    x->release = release;
+    x->ctx = ctx;
+
+    /* Chunks are sent in order of the values */
+    for (last = &req->xferOut; *last; last = &(*last)->next)
+        ;
+    *last = x;
+
+ret:
+    return status;
+}
+
+int mmx_backapi_xfer_chunk_build(mmxba_xfer_out_t *x, char *buf, size_t size,
+                                 size_t *len)
+{
+    size_t hdr_len, avail, n;
+    char *s;
+
+    if (x == NULL || buf == NULL || len == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    *len = 0;
+    if (xfer_done(x))
+        return MMXBA_OK;
+
+    hdr_len = snprintf(buf, size, CHUNK_START " " MMXBA_STR_ATTR_HANDLE "=\"%" PRIu32 "\" "
+                       MMXBA_STR_ATTR_OFFSET "=\"%zu\" " MMXBA_STR_ATTR_TOTAL "=\"%zu\">",
+                       x->handle, x->offset, x->size);
+
+    /* Data of the chunk are base64 encoded, so no escaping is needed */
+    if (hdr_len + sizeof(CHUNK_END) >= size)
+        return MMXBA_NOT_ENOUGH_MEMORY;
+
+    avail = (size - hdr_len - sizeof(CHUNK_END)) / 4 * 3;
+    n = x->size - x->offset;
+    if (n > avail)
+        n = avail;
+    if (n > MMXBA_XFER_CHUNK_SIZE)
+        n = MMXBA_XFER_CHUNK_SIZE;
+    if (n == 0 && x->size > x->offset)
+        return MMXBA_NOT_ENOUGH_MEMORY;
+
+    s = buf + hdr_len;
+    s += mmxba_base64_encode((const char *)x->data + x->offset, n, s);
+    memcpy(s, CHUNK_END, sizeof(CHUNK_END));
+
+    x->offset += n;
+    x->chunks++;
+    *len = s + sizeof(CHUNK_END) - 1 - buf;
+
+    return MMXBA_OK;
+}
+
+int mmx_backapi_xfer_send(mmxba_request_t *req, mmxba_transport_t *tr,
+                          const mmxba_sockaddr_t *peer)
+{
+    int status = MMXBA_OK;
+    char buf[MMXBA_MAX_MSG_SIZE - sizeof(mmxba_flags)];
+    size_t len;
+
+    if (req == NULL || tr == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    while (req->xferOut && status == MMXBA_OK)
+    {
+        while ((status = mmx_backapi_xfer_chunk_build(req->xferOut, buf, sizeof(buf),
+                                                      &len)) == MMXBA_OK && len)
+        {
+            if ((status = mmx_backapi_transport_send_now(tr, peer, buf, len)) != MMXBA_OK)
+                break;
+        }
+
+        if (status != MMXBA_OK)
+            ing_log(LOG_ERR, "Could not send chunks of transfer %u\n", req->xferOut->handle);
+
+        xfer_drop_first(req);
+    }
+
+    /* The rest cannot be sent after the failure */
+    mmx_backapi_xfer_release(req);
+
+    return status;
+}
+
+int mmx_backapi_xfer_send_ring(mmxba_request_t *req, mmxba_shmring_t *ring)
+{
+    int status = MMXBA_OK;
+    size_t size, len;
+    char *buf;
+    int res;
+
+    if (req == NULL || ring == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    while (req->xferOut)
+    {
+        if (xfer_done(req->xferOut))
+        {
+            xfer_drop_first(req);
+            continue;
+        }
+
+        /* The transfer keeps its offset until the ring has free slots */
+        if ((buf = mmx_backapi_shmring_reserve(ring, &size)) == NULL)
+            return MMXBA_NOT_ENOUGH_MEMORY;
+
+        if ((res = mmx_backapi_xfer_chunk_build(req->xferOut, buf, size, &len)) != MMXBA_OK ||
+            (res = mmx_backapi_shmring_commit(ring, len)) != MMXBA_OK)
+        {
+            status = res;
+            ing_log(LOG_ERR, "Could not send chunks of transfer %u\n", req->xferOut->handle);
+            xfer_drop_first(req);
+        }
+    }
+
+    return status;
+}
+
+void mmx_backapi_xfer_release(mmxba_request_t *req)
+{
+    while (req && req->xferOut)
+        xfer_drop_first(req);
+}
+
+int mmx_backapi_msgstruct_get_xfer(const mmxba_request_t *req, const nvpair_t *nvPair,
+                                   uint32_t *handle)
+{
+    int idx;
+
+    if (req == NULL || nvPair == NULL || handle == NULL)
+        return MMXBA_BAD_INPUT_PARAMS;
+
+    if ((idx = mmx_backapi_value_index(req, nvPair)) < 0 ||
+        req->valTypes[idx] != MMXBA_VAL_TYPE_XFER)
+        return MMXBA_INVALID_FORMAT;
+
+    *handle = (uint32_t)req->valNums[idx];
+
+    return MMXBA_OK;
+}
+
+void mmx_backapi_xfer_in_init(mmxba_xfer_in_t *x, uint32_t handle,
+                              mmxba_xfer_sink_t sink, void *ctx)
+{
+    memset(x, 0, sizeof(*x));
+    x->handle = handle;
+    x->sink = sink;
+    x->ctx = ctx;
+}
+
+int mmx_backapi_xfer_is_chunk(const char *xml_string)
+{
+    return (chunk_start(xml_string) != NULL);
+}
+
+uint32_t mmx_backapi_xfer_chunk_peek_handle(const char *xml_string)
+{
+    const char *s = chunk_start(xml_string), *tag_end;
+    uint64_t handle;
+
+    if (s == NULL || (tag_end = strchr(s, '>')) == NULL ||
+        chunk_attr(s, tag_end, MMXBA_STR_ATTR_HANDLE, &handle) != MMXBA_OK ||
+        handle > UINT32_MAX)
+        return 0;
+
+    return (uint32_t)handle;
+}
+
+int mmx_backapi_xfer_chunk_parse(mmxba_xfer_in_t *x, const char *xml_string)
+{
+    int status = MMXBA_OK;
+    unsigned char data[MMXBA_XFER_CHUNK_SIZE];
+    const char *s, *tag_end, *end;
+    uint64_t handle, offset, total;
+    size_t len = sizeof(data);
+
+    if (x == NULL || x->sink == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    if ((s = chunk_start(xml_string)) == NULL || (tag_end = strchr(s, '>')) == NULL ||
+        (end = strstr(tag_end, CHUNK_END)) == NULL)
+        GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Bad format of transfer chunk");
+
+    if (chunk_attr(s, tag_end, MMXBA_STR_ATTR_HANDLE, &handle) != MMXBA_OK ||
+        chunk_attr(s, tag_end, MMXBA_STR_ATTR_OFFSET, &offset) != MMXBA_OK ||
+        chunk_attr(s, tag_end, MMXBA_STR_ATTR_TOTAL, &total) != MMXBA_OK)
+        GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Bad attributes of transfer chunk");
+
+    if (handle != x->handle)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "Chunk of transfer %" PRIu64
+                            " is not of transfer %u", handle, x->handle);
+
+    /* Chunks are sent in order: a gap means a lost chunk */
+    if (offset != x->received || (x->chunks && total != x->total))
+        GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Unexpected chunk of transfer %u "
+                            "(offset %" PRIu64 ", received %" PRIu64 ")",
+                            x->handle, offset, x->received);
+
+    if ((status = mmxba_base64_decode(tag_end + 1, end - tag_end - 1, data, &len)) != MMXBA_OK)
+        GOTO_RET_WITH_ERROR(status, "Bad data of chunk of transfer %u", x->handle);
+
+    if (offset + len > total)
+        GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Chunk exceeds size of transfer %u",
+                            x->handle);
+
+    x->total = total;
+    if ((status = x->sink(x->ctx, (size_t)offset, data, len)) != MMXBA_OK)
+        goto ret;
+
+    x->received += len;
+    x->chunks++;
+
+ret:
+    return status;
+}
+
+int mmx_backapi_xfer_in_complete(const mmxba_xfer_in_t *x)
+{
+    return (x->chunks > 0 && x->received == x->total);
+}
@@ -0,0 +1,211 @@
+/* mmx-backapi-xfer.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Out-of-band chunked transfer of large param values.
+ *
+ * A value which does not fit into one message (firmware images, logs,
+ * configuration files) is not inlined: the nvPair carries the handle of
+ * the transfer as the value of "xfer" type and the data follow the
+ * message as a sequence of chunk messages of bounded size:
+ *
+ *     <mmxXferChunk handle="H" offset="O" total="T">base64</mmxXferChunk>
+ *
+ * The sender inserts the value by mmx_backapi_msgstruct_insert_xfer(),
+ * which only keeps the reference to the data, sends the message and then
+ * sends the chunks by mmx_backapi_xfer_send() (or writes them to a
+ * shared-memory ring by mmx_backapi_xfer_send_ring()). The dispatcher and
+ * the workers send the chunks of the response themselves.
+ *
+ * The receiver gets the handle of the value by mmx_backapi_msgstruct_get_xfer(),
+ * recognizes chunk messages by mmx_backapi_xfer_is_chunk() and routes them
+ * by mmx_backapi_xfer_chunk_peek_handle() (handles are unique per sender
+ * process). The chunks of one transfer are sent in order, at least one
+ * chunk per transfer; every chunk is decoded to the sink callback, so the
+ * whole value is never kept in a message buffer.
+ */
+
+#ifndef MMX_BACKAPI_XFER_H_
+#define MMX_BACKAPI_XFER_H_
+
+#include <stdint.h>
+
+#include "mmx-backapi.h"
+#include "mmx-backapi-transport.h"
+#include "mmx-backapi-shmring.h"
+
+#define MMXBA_STR_XFER_CHUNK        "mmxXferChunk"
+#define MMXBA_STR_ATTR_HANDLE       "handle"
+#define MMXBA_STR_ATTR_OFFSET       "offset"
+#define MMXBA_STR_ATTR_TOTAL        "total"
+
+/* Max data bytes per chunk; smaller chunks are built if the buffer of
+   the chunk message is smaller */
+#define MMXBA_XFER_CHUNK_SIZE       (16 * 1024)
+
+/* Called when the data of the transfer are not needed anymore */
+typedef void (*mmxba_xfer_release_t)(const void *data, void *ctx);
+
+/* Outgoing transfer, allocated in the memory pool of the message */
+typedef struct mmxba_xfer_out_s {
+    uint32_t                 handle;
+    const void               *data;
+    size_t                   size;
+    size_t                   offset;    /* bytes sent  */
+    uint32_t                 chunks;    /* chunks sent */
+    mmxba_xfer_release_t     release;   /* or NULL    */
+    void                     *ctx;
+    struct mmxba_xfer_out_s  *next;
+} mmxba_xfer_out_t;
+
+/* Called for every decoded piece of the incoming transfer */
+typedef int (*mmxba_xfer_sink_t)(void *ctx, size_t offset, const void *data, size_t len);
+
+/* Incoming transfer */
+typedef struct mmxba_xfer_in_s {
+    uint32_t            handle;
+    uint64_t            total;      /* 0 - not known yet */
+    uint64_t            received;
+    uint32_t            chunks;     /* parsed chunks     */
+    mmxba_xfer_sink_t   sink;
+    void                *ctx;
+} mmxba_xfer_in_t;
+
+
+/*
+ * Sender: inserts value of size bytes of data as handle of a new
+ * transfer. The data are not copied and must be kept until release is
+ * called (after the last chunk is sent or the transfer is dropped).
+ */
+int mmx_backapi_msgstruct_insert_xfer(mmxba_request_t *req, nvpair_t *nvPair,
+                                      const char *name, const void *data, size_t size,
+                                      mmxba_xfer_release_t release, void *ctx);
+
+/*
+ * Sender: builds the next chunk message of the transfer into buf of
+ * size bytes; the message length is returned in *len and 0 when all
+ * the data are sent
+ */
+int mmx_backapi_xfer_chunk_build(mmxba_xfer_out_t *x, char *buf, size_t size,
+                                 size_t *len);
+
+/*
+ * Sender: sends the chunks of all transfers of the message immediately
+ * (after the message itself is sent) and releases the transfers
+ */
+int mmx_backapi_xfer_send(mmxba_request_t *req, mmxba_transport_t *tr,
+                          const mmxba_sockaddr_t *peer);
+
+/*
+ * Sender: writes the chunks of all transfers of the message to the ring
+ * slots. If the ring is full MMXBA_NOT_ENOUGH_MEMORY is returned and the
+ * call must be repeated when the consumer releases the slots.
+ */
+int mmx_backapi_xfer_send_ring(mmxba_request_t *req, mmxba_shmring_t *ring);
+
+/*
+ * Sender: drops transfers of the message which are not sent
+ */
+void mmx_backapi_xfer_release(mmxba_request_t *req);
+
+/*
+ * Receiver: returns handle of the transfer of nvPair of "xfer" type
+ */
+int mmx_backapi_msgstruct_get_xfer(const mmxba_request_t *req, const nvpair_t *nvPair,
+                                   uint32_t *handle);
+
+/*
+ * Receiver: prepares receiving of the transfer, sink is called for
+ * every piece of the data in order
+ */
+void mmx_backapi_xfer_in_init(mmxba_xfer_in_t *x, uint32_t handle,
+                              mmxba_xfer_sink_t sink, void *ctx);
+
+/*
+ * Receiver: returns TRUE if the message is a chunk message
+ */
+int mmx_backapi_xfer_is_chunk(const char *xml_string);
+
+/*
+ * Receiver: returns handle of the transfer of the chunk message, 0 if
+ * the message is not a chunk
+ */
+uint32_t mmx_backapi_xfer_chunk_peek_handle(const char *xml_string);
+
+/*
+ * Receiver: decodes the chunk message of the transfer to its sink. The
+ * chunk must continue the data received before.
+ */
+int mmx_backapi_xfer_chunk_parse(mmxba_xfer_in_t *x, const char *xml_string);
+
+/*
+ * Receiver: returns TRUE if all the data of the transfer are received
+ */
+int mmx_backapi_xfer_in_complete(const mmxba_xfer_in_t *x);
+
+#endif /* MMX_BACKAPI_XFER_H_ */
@@ -75,7 +75,15 @@
  * "backend'style" methods.
  */
 
-#include "mmx-backapi.h"
+#include <inttypes.h>
+#include <time.h>
+
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-cache.h"
+#include "mmx-backapi-value.h"
+#include "mmx-backapi-dict.h"
+#include "mmx-backapi-index.h"
+#include "mmx-backapi-emit.h"
 
 
 /* MMX backend flags */
@@ -86,13 +94,6 @@ char mmxba_flags[] = {'1', 0, 0, 0, 0, 0, 0, 0};
 /*  MMX Backend internal macros for working with XML string            */
 /* ------------------------------------------------------------------- */
 
-#define GOTO_RET_WITH_ERROR(err_num, msg, ...)     do { \
-    ing_log(LOG_ERR, msg"\n", ##__VA_ARGS__); \
-    status = err_num; \
-    goto ret; \
-} while (0)
-
-
 #define XML_GET_INT(node, tree, name, to)     do { \
     mxml_node_t *n = mxmlFindElement(node, tree, name, NULL, NULL, MXML_DESCEND); \
     if (n == NULL) \
@@ -133,7 +134,7 @@ char mmxba_flags[] = {'1', 0, 0, 0, 0, 0, 0, 0};
         GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not write `%s'", name); \
 } while (0)
 
-#define XML_PARSE_GET_VALUES(req, node, tree, max_elem_num, elem_num, elem_array)  do { \
+#define XML_PARSE_GET_VALUES(req, node, tree, max_elem_num, elem_num, elem_array, typed, names, ids)  do { \
     const char *arraySizeStr = mxmlElementGetAttrValue(node, MMXBA_STR_ATTR_ARRAYSIZE); \
     if (arraySizeStr == NULL) \
         GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Attribute `%s' in not set", \
@@ -154,7 +155,8 @@ char mmxba_flags[] = {'1', 0, 0, 0, 0, 0, 0, 0};
         if (!subnode) \
             GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Incorrect syntax: pair name missing"); \
         \
-        sname = mxmlGetOpaque(subnode); \
+        if (read_name(subnode, names, &sname, &(ids)[i]) != MMXBA_OK) \
+            GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Unknown id of param name"); \
         subnode = mxmlFindElement(n, tree, MMXBA_STR_VALUE, NULL, NULL, MXML_DESCEND); \
         if (!subnode) \
             GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Incorrect syntax: pair value missing"); \
@@ -162,12 +164,15 @@ char mmxba_flags[] = {'1', 0, 0, 0, 0, 0, 0, 0};
         if (mmx_backapi_msgstruct_insert_nvpair(req, &(elem_array[i]), \
                                                (char *)sname, (char *)svalue) != MMXBA_OK )\
             GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Not enough memory in the pool for param\n"); \
+        if (typed) \
+            mmx_backapi_value_decode(mxmlElementGetAttrValue(subnode, MMXBA_STR_ATTR_TYPE), \
+                                     svalue, &req->valTypes[i], &req->valNums[i]); \
     } \
     if (i != arraySize) \
         GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Number of parameters does not match arraySize attribute"); \
 } while(0)
 
-#define XML_PARSE_GET_NAMES(node, tree, name_tag, max_elem_num, elem_num, elem_array)  do { \
+#define XML_PARSE_GET_NAMES(node, tree, name_tag, max_elem_num, elem_num, elem_array, names, ids)  do { \
     const char *arraySizeStr = mxmlElementGetAttrValue(node, MMXBA_STR_ATTR_ARRAYSIZE); \
     if (arraySizeStr == NULL) \
         GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Attribute `%s' in not set", \
@@ -178,11 +183,16 @@ char mmxba_flags[] = {'1', 0, 0, 0, 0, 0, 0, 0};
                    "Incorrect value of attribute `%s'", MMXBA_STR_ATTR_ARRAYSIZE); \
     elem_num = arraySize; \
     int i = 0; \
+    uint16_t id; \
     for (mxml_node_t *n = mxmlFindElement(node, tree, name_tag, NULL, NULL, MXML_DESCEND); \
             n != NULL && i < arraySize; \
             n = mxmlFindElement(n, tree, name_tag, NULL, NULL, MXML_DESCEND), i++) \
     { \
-        const char *s = mxmlGetOpaque(n); \
+        const char *s; \
+        if (read_name(n, names, &s, &id) != MMXBA_OK) \
+            GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Unknown id of param name"); \
+        if (ids) \
+            ((uint16_t *)(ids))[i] = id; \
         strncpy(elem_array[i], s ? s : "", MMXBA_MAX_STR_LEN-1); \
     } \
     if (i != arraySize) \
@@ -192,40 +202,964 @@ char mmxba_flags[] = {'1', 0, 0, 0, 0, 0, 0, 0};
 /* ------------------------------------------------------------------- */
 /*  -----------  MMX Backend internal functions       -----------------*/
 /* ------------------------------------------------------------------- */
-static mmxba_op_type_t optype2num(const char *str)
+/* Message schema of the operations (see mmx-backapi-internal.h) */
+static const mmxba_schema_t schema[MMXBA_OP_TYPE_NUM] = {
+#define SCHEMA_ENTRY(op, reqSections, respSections) \
+    [MMXBA_OP_TYPE_##op] = { MMXBA_STR_OPER_##op, { respSections, reqSections } },
+    MMXBA_SCHEMA(SCHEMA_ENTRY)
+#undef SCHEMA_ENTRY
+};
+
+mmxba_op_type_t mmxba_optype2num(const char *str)
 {
-    if (!strcmp(str, MMXBA_STR_OPER_GET))           return MMXBA_OP_TYPE_GET;
-    else if (!strcmp(str, MMXBA_STR_OPER_SET))      return MMXBA_OP_TYPE_SET;
-    else if (!strcmp(str, MMXBA_STR_OPER_GETALL))   return MMXBA_OP_TYPE_GETALL;
-    else if (!strcmp(str, MMXBA_STR_OPER_ADDOBJ))   return MMXBA_OP_TYPE_ADDOBJ;
-    else if (!strcmp(str, MMXBA_STR_OPER_DELOBJ))   return MMXBA_OP_TYPE_DELOBJ;
+    int op;
+
+    for (op = 0; op < MMXBA_OP_TYPE_NUM; op++)
+        if (!strcmp(str, schema[op].opName))
+            return op;
 
     return MMXBA_OP_TYPE_ERROR;
 }
 
+uint32_t mmxba_schema_sections(int op_type, int isRequest)
+{
+    if (op_type < 0 || op_type >= MMXBA_OP_TYPE_NUM)
+        return 0;
+
+    return schema[op_type].sections[isRequest ? 1 : 0];
+}
+
 static int verify_optype(int optype)
 {
     if ((optype == MMXBA_OP_TYPE_GET) || (optype == MMXBA_OP_TYPE_SET) ||
         (optype == MMXBA_OP_TYPE_ADDOBJ) || (optype == MMXBA_OP_TYPE_DELOBJ) ||
-        (optype == MMXBA_OP_TYPE_GETALL))
+        (optype == MMXBA_OP_TYPE_GETALL) || (optype == MMXBA_OP_TYPE_SUBSCRIBE) ||
+        (optype == MMXBA_OP_TYPE_UNSUBSCRIBE))
         return TRUE;
     else
         return FALSE;
 }
 
+/* Returns length of the prefix shared by the object with the previous
+   one; the prefix never ends inside of UTF-8 character */
+static int front_prefix_len(const char *prev, const char *obj)
+{
+    int len = 0;
+
+    while (prev[len] && prev[len] == obj[len])
+        len++;
+    while (len > 0 && ((unsigned char)obj[len] & 0xC0) == 0x80)
+        len--;
+
+    return len;
+}
+
+/* Expands front coded object: obj keeps the suffix on input */
+int mmxba_front_expand(char *obj, const char *prev, const char *prefix_str)
+{
+    long prefix = prefix_str ? strtol(prefix_str, NULL, 10) : 0;
+    size_t suffix_len = strlen(obj);
+
+    if (prefix < 0 || prefix > strlen(prev) || prefix + suffix_len >= MMXBA_MAX_STR_LEN)
+        return MMXBA_INVALID_FORMAT;
+
+    memmove(obj + prefix, obj, suffix_len + 1);
+    memcpy(obj, prev, prefix);
+
+    return MMXBA_OK;
+}
+
+/* Sets type attribute of typed values; strings are sent untyped */
+static void write_value_type(mxml_node_t *value_node, uint8_t type)
+{
+    if (type != MMXBA_VAL_TYPE_STRING)
+        mxmlElementSetAttr(value_node, MMXBA_STR_ATTR_TYPE, mmx_backapi_value_type_str(type));
+}
+
+/* Resolves param name and its dictionary id: ids sent in the message are
+   used if it is built with the same dictionary, otherwise ids are looked
+   up by the names. Fails if the name is sent as unknown id */
+int mmxba_resolve_name(const msg_names_t *names, const char *idStr,
+                       const char **name, uint16_t *id)
+{
+    const char *dictName;
+
+    *id = MMXBA_DICT_NO_ID;
+
+    if (names && names->dict)
+    {
+        if (names->sameDict && idStr &&
+            (dictName = mmx_backapi_dict_name(names->dict, atoi(idStr))) != NULL)
+        {
+            *id = atoi(idStr);
+            if (*name == NULL)
+                *name = dictName;
+        }
+        else if (*name)
+            *id = mmx_backapi_dict_id(names->dict, *name);
+    }
+
+    return (*name == NULL && idStr) ? MMXBA_INVALID_FORMAT : MMXBA_OK;
+}
+
+/* Gets param name of the name element and its dictionary id */
+static int read_name(mxml_node_t *node, const msg_names_t *names,
+                     const char **name, uint16_t *id)
+{
+    *name = mxmlGetOpaque(node);
+
+    return mmxba_resolve_name(names, mxmlElementGetAttrValue(node, MMXBA_STR_ATTR_ID),
+                              name, id);
+}
+
+/* Param names may be sent as ids of the attached dictionary: they are
+   used if the dict attribute of the message matches its checksum */
+void mmxba_names_init(msg_names_t *names, const char *dictAttr)
+{
+    names->dict = mmx_backapi_dict_attached(NULL);
+    names->sameDict = (names->dict && dictAttr &&
+                       strtoul(dictAttr, NULL, 16) == names->dict->checksum);
+}
+
+/* Adds param name element with id of the name in the attached dictionary;
+   the name text is omitted in the compact mode */
+static void write_name(mxml_node_t *parent, const char *name)
+{
+    int compact;
+    const mmxba_dict_t *dict = mmx_backapi_dict_attached(&compact);
+    uint16_t id = mmx_backapi_dict_id(dict, name);
+    mxml_node_t *node = mxmlNewElement(parent, MMXBA_STR_NAME);
+    char buf[8];
+
+    if (id != MMXBA_DICT_NO_ID)
+    {
+        sprintf(buf, "%u", id);
+        mxmlElementSetAttr(node, MMXBA_STR_ATTR_ID, buf);
+        if (compact)
+            return;
+    }
+
+    mxmlNewText(node, 0, name);
+}
+
+/* Marks the message by checksum of the attached dictionary */
+static void write_dict_attr(mxml_node_t *tree)
+{
+    const mmxba_dict_t *dict = mmx_backapi_dict_attached(NULL);
+    char buf[16];
+
+    if (dict)
+    {
+        sprintf(buf, "%08x", dict->checksum);
+        mxmlElementSetAttr(tree, MMXBA_STR_ATTR_DICT, buf);
+    }
+}
+
+/* Emitter variant of write_name() */
+static void emit_name(mmxba_emitter_t *e, const char *name)
+{
+    int compact;
+    const mmxba_dict_t *dict = mmx_backapi_dict_attached(&compact);
+    uint16_t id = mmx_backapi_dict_id(dict, name);
+
+    mmx_backapi_emit_start(e, MMXBA_STR_NAME);
+    if (id != MMXBA_DICT_NO_ID)
+    {
+        mmx_backapi_emit_attr_uint(e, MMXBA_STR_ATTR_ID, id);
+        if (compact)
+        {
+            mmx_backapi_emit_raw(e, "/>", 2);
+            return;
+        }
+    }
+    mmx_backapi_emit_start_end(e);
+    mmx_backapi_emit_text(e, name);
+    mmx_backapi_emit_close(e, MMXBA_STR_NAME);
+}
+
+/* Emitter variant of write_dict_attr(): starts the root element */
+static void emit_root(mmxba_emitter_t *e, const char *tag)
+{
+    const mmxba_dict_t *dict = mmx_backapi_dict_attached(NULL);
+    char buf[16];
+
+    mmx_backapi_emit_start(e, tag);
+    if (dict)
+    {
+        sprintf(buf, "%08x", dict->checksum);
+        mmx_backapi_emit_attr(e, MMXBA_STR_ATTR_DICT, buf);
+    }
+    mmx_backapi_emit_start_end(e);
+}
+
+/* Adds array element of param names */
+static void emit_names(mmxba_emitter_t *e, const char *tag,
+                       const char (*names)[MMXBA_MAX_STR_LEN], uint32_t num)
+{
+    uint32_t i;
+
+    mmx_backapi_emit_start(e, tag);
+    mmx_backapi_emit_attr_uint(e, MMXBA_STR_ATTR_ARRAYSIZE, num);
+    mmx_backapi_emit_start_end(e);
+    for (i = 0; i < num; i++)
+        emit_name(e, names[i]);
+    mmx_backapi_emit_close(e, tag);
+}
+
+/* Adds array element of name-value pairs; types are NULL for untyped
+   values. The values are referenced by the emitter, not copied */
+static void emit_nvpairs(mmxba_emitter_t *e, const char *tag, const nvpair_t *pnv,
+                         uint32_t num, const uint8_t *types)
+{
+    uint32_t i;
+
+    mmx_backapi_emit_start(e, tag);
+    mmx_backapi_emit_attr_uint(e, MMXBA_STR_ATTR_ARRAYSIZE, num);
+    mmx_backapi_emit_start_end(e);
+    for (i = 0; i < num; i++)
+    {
+        mmx_backapi_emit_open(e, MMXBA_STR_NAMEVALUEPAIR);
+        emit_name(e, pnv[i].name);
+        mmx_backapi_emit_start(e, MMXBA_STR_VALUE);
+        if (types && types[i] != MMXBA_VAL_TYPE_STRING)
+            mmx_backapi_emit_attr(e, MMXBA_STR_ATTR_TYPE, mmx_backapi_value_type_str(types[i]));
+        mmx_backapi_emit_start_end(e);
+        mmx_backapi_emit_text(e, pnv[i].pValue);
+        mmx_backapi_emit_close(e, MMXBA_STR_VALUE);
+        mmx_backapi_emit_close(e, MMXBA_STR_NAMEVALUEPAIR);
+    }
+    mmx_backapi_emit_close(e, tag);
+}
+
+/* Splits objKeyValues string into key values separated by "," (groups
+   of values are separated by ";") */
+void mmxba_object_split_keys(const char *obj, mmxba_key_ref_t *refs, uint32_t keyNum)
+{
+    uint32_t k, pos = 0, start;
+
+    for (k = 0; k < keyNum; k++)
+    {
+        start = pos;
+        while (obj[pos] && obj[pos] != ',' && obj[pos] != ';')
+            pos++;
+        refs[k].off = start;
+        refs[k].len = pos - start;
+        if (obj[pos])
+            pos++;
+    }
+}
+
+/* Allocates memory aligned to 8 bytes in the message pool */
+void *mmxba_pool_alloc(mmxba_request_t *req, size_t size)
+{
+    char *p = req->mem_pool.pool + req->mem_pool.curr_offset;
+    size_t off = req->mem_pool.curr_offset + (-(uintptr_t)p & 7);
+
+    if (off + size > req->mem_pool.size_bytes)
+        return NULL;
+
+    req->mem_pool.curr_offset = off + size;
+
+    return req->mem_pool.pool + off;
+}
+
+/* The last step of parsing of the message: indexes param names for the
+   handlers if requested and fills or invalidates the EP cache */
+void mmxba_message_finish(mmxba_request_t *req, int isRequest)
+{
+    uint32_t secs = mmxba_schema_sections(req->op_type, isRequest);
+
+    /* Index param names for the handlers if requested */
+    if (req->parseFlags & MMXBA_PARSE_FLAG_INDEX)
+    {
+        if (secs & (MMXBA_SEC_PARAMNAMES | MMXBA_SEC_NAMEFILTER))
+            mmx_backapi_msgstruct_index(req, TRUE);
+        else if (secs & (MMXBA_SEC_PARAMVALUES | MMXBA_SEC_CHANGES | MMXBA_SEC_NEWVALUES))
+            mmx_backapi_msgstruct_index(req, FALSE);
+    }
+
+    /* Fill or invalidate the EP cache of GET responses */
+    mmx_backapi_cache_observe(req, isRequest);
+}
+
 static const char *optype2str(mmxba_op_type_t op_type)
 {
-    switch(op_type)
+    if (op_type < 0 || op_type >= MMXBA_OP_TYPE_NUM)
+        return "UNKNOWN";
+
+    return schema[op_type].opName;
+}
+
+/* Returns beKeyNames of GETALL or ADDOBJ message and their number */
+static uint32_t *key_names(mmxba_request_t *req, int isRequest,
+                           char (**names)[MMXBA_MAX_STR_LEN])
+{
+    if (req->op_type == MMXBA_OP_TYPE_GETALL)
+    {
+        *names = req->getAll.beKeyNames;
+        return &req->getAll.beKeyNamesNum;
+    }
+    if (isRequest)
+    {
+        *names = req->addObj_req.beKeyNames;
+        return &req->addObj_req.beKeyNamesNum;
+    }
+
+    *names = req->addObj_resp.beKeyNames;
+    return &req->addObj_resp.beKeyNamesNum;
+}
+
+/* Adds array element of param names to the tree */
+static void tree_add_names(mxml_node_t *tree, const char *tag,
+                           const char (*names)[MMXBA_MAX_STR_LEN], uint32_t num)
+{
+    mxml_node_t *node = mxmlNewElement(tree, tag);
+    char buf[MMXBA_MAX_NUMBER_OF_ANY_OP_PARAMS];
+    uint32_t i;
+
+    sprintf(buf, "%u", num);
+    mxmlElementSetAttr(node, MMXBA_STR_ATTR_ARRAYSIZE, buf);
+
+    for (i = 0; i < num; i++)
+        write_name(node, names[i]);
+}
+
+/* Adds array element of name-value pairs to the tree; types are NULL
+   for untyped values */
+static void tree_add_nvpairs(mxml_node_t *tree, const char *tag, const nvpair_t *pnv,
+                             uint32_t num, const uint8_t *types)
+{
+    mxml_node_t *node = mxmlNewElement(tree, tag);
+    mxml_node_t *subnode1, *subnode2;
+    char buf[MMXBA_MAX_NUMBER_OF_ANY_OP_PARAMS];
+    uint32_t i;
+
+    sprintf(buf, "%u", num);
+    mxmlElementSetAttr(node, MMXBA_STR_ATTR_ARRAYSIZE, buf);
+
+    for (i = 0; i < num; i++)
+    {
+        subnode1 = mxmlNewElement(node, MMXBA_STR_NAMEVALUEPAIR);
+        write_name(subnode1, pnv[i].name);
+        subnode2 = mxmlNewElement(subnode1, MMXBA_STR_VALUE);
+        mxmlNewText(subnode2, 0, pnv[i].pValue);
+        if (types)
+            write_value_type(subnode2, types[i]);
+    }
+}
+
+/* Adds objects of GETALL or ADDOBJ response to the tree */
+static int tree_add_objects(mxml_node_t *tree, mmxba_request_t *req)
+{
+    int status = MMXBA_OK;
+    int getAll = (req->op_type == MMXBA_OP_TYPE_GETALL);
+    uint32_t i, num = getAll ? req->getAll.objNum : req->addObj_resp.objNum;
+    char buf[MMXBA_MAX_NUMBER_OF_ANY_OP_PARAMS];
+    mxml_node_t *node, *subnode;
+    int frontCoding, prefixLen;
+    const char *obj;
+
+    node = mxmlNewElement(tree, MMXBA_STR_OBJECTS);
+    sprintf(buf, "%u", num);
+    mxmlElementSetAttr(node, MMXBA_STR_ATTR_ARRAYSIZE, buf);
+
+    if (getAll && req->getAll.isDelta)
+        mxmlElementSetAttr(node, MMXBA_STR_ATTR_DELTA, "1");
+
+    /* Front coding is used only if the EP accepts it */
+    frontCoding = (getAll && req->getAll.objEnc == MMXBA_OBJ_ENC_FRONT);
+    if (frontCoding)
+        mxmlElementSetAttr(node, MMXBA_STR_ATTR_ENC, MMXBA_STR_ENC_FRONT);
+
+    for (i = 0; i < num; i++)
+    {
+        obj = getAll ? req->getAll.objects[i] : req->addObj_resp.objects[i];
+        subnode = mxmlNewElement(node, MMXBA_STR_OBJKEYVALUES);
+        if (frontCoding && i > 0 &&
+            (prefixLen = front_prefix_len(req->getAll.objects[i - 1], obj)) > 0)
+        {
+            sprintf(buf, "%d", prefixLen);
+            mxmlElementSetAttr(subnode, MMXBA_STR_ATTR_PREFIX, buf);
+            obj += prefixLen;
+        }
+        mxmlNewText(subnode, 0, obj);
+        if (getAll && req->getAll.isDelta && req->getAll.objRemoved[i])
+            mxmlElementSetAttr(subnode, MMXBA_STR_ATTR_REMOVED, "1");
+    }
+
+    if (getAll && req->getAll.generation)
+    {
+        sprintf(buf, "%u", req->getAll.generation);
+        XML_WRITE_TEXT(node, tree, MMXBA_STR_GENERATION, buf);
+    }
+
+ret:
+    return status;
+}
+
+/* Adds the sections of the message body to the tree in their order */
+static int tree_add_sections(mxml_node_t *tree, mmxba_request_t *req, int isRequest)
+{
+    int status = MMXBA_OK;
+    uint32_t secs = mmxba_schema_sections(req->op_type, isRequest);
+    char buf[MMXBA_MAX_NUMBER_OF_ANY_OP_PARAMS];
+    char (*names)[MMXBA_MAX_STR_LEN];
+    mxml_node_t *node = NULL;
+    uint32_t *num;
+
+    for (; secs && status == MMXBA_OK; secs &= secs - 1)
+    {
+        switch (secs & -secs)
+        {
+        case MMXBA_SEC_MMXINSTANCE:
+            XML_WRITE_TEXT(node, tree, MMXBA_STR_MMXINSTANCE, req->mmxInstances);
+            break;
+
+        case MMXBA_SEC_SUBSCRID:
+            sprintf(buf, "%u", req->subscrId);
+            XML_WRITE_TEXT(node, tree, MMXBA_STR_SUBSCRID, buf);
+            break;
+
+        case MMXBA_SEC_KEYFILTER:
+            if (req->beKeyParamsNum == 0)
+                break;
+            /* fall through */
+        case MMXBA_SEC_BEKEYPARAMS:
+            tree_add_nvpairs(tree, MMXBA_STR_BEKEYPARAMS, req->beKeyParams,
+                             req->beKeyParamsNum, NULL);
+            break;
+
+        case MMXBA_SEC_NAMEFILTER:
+            if (req->paramNames.arraySize == 0)
+                break;
+            /* fall through */
+        case MMXBA_SEC_PARAMNAMES:
+            tree_add_names(tree, MMXBA_STR_PARAMNAMES, req->paramNames.paramNames,
+                           req->paramNames.arraySize);
+            break;
+
+        case MMXBA_SEC_PARAMVALUES:
+        case MMXBA_SEC_CHANGES:
+            tree_add_nvpairs(tree, MMXBA_STR_PARAMVALUES, req->paramValues.paramValues,
+                             req->paramValues.arraySize, req->valTypes);
+            break;
+
+        case MMXBA_SEC_NEWVALUES:
+            tree_add_nvpairs(tree, MMXBA_STR_PARAMVALUES, req->addObj_req.paramValues,
+                             req->addObj_req.paramNum, req->valTypes);
+            break;
+
+        case MMXBA_SEC_BEKEYNAMES:
+            num = key_names(req, isRequest, &names);
+            tree_add_names(tree, MMXBA_STR_BEKEYNAMES, names, *num);
+            break;
+
+        case MMXBA_SEC_QUERY:
+            if (req->getAll.generation)
+            {
+                sprintf(buf, "%u", req->getAll.generation);
+                XML_WRITE_TEXT(node, tree, MMXBA_STR_GENERATION, buf);
+            }
+            if (req->getAll.objEnc == MMXBA_OBJ_ENC_FRONT)
+                XML_WRITE_TEXT(node, tree, MMXBA_STR_OBJENC, MMXBA_STR_ENC_FRONT);
+            break;
+
+        case MMXBA_SEC_OBJECTS:
+            status = tree_add_objects(tree, req);
+            break;
+        }
+    }
+
+ret:
+    return status;
+}
+
+/* Adds objects of GETALL or ADDOBJ response */
+static void emit_objects(mmxba_emitter_t *e, const mmxba_request_t *req)
+{
+    int getAll = (req->op_type == MMXBA_OP_TYPE_GETALL);
+    uint32_t i, num = getAll ? req->getAll.objNum : req->addObj_resp.objNum;
+    int frontCoding, prefixLen;
+    const char *obj;
+
+    /* Front coding is used only if the EP accepts it */
+    frontCoding = (getAll && req->getAll.objEnc == MMXBA_OBJ_ENC_FRONT);
+
+    mmx_backapi_emit_start(e, MMXBA_STR_OBJECTS);
+    mmx_backapi_emit_attr_uint(e, MMXBA_STR_ATTR_ARRAYSIZE, num);
+    if (getAll && req->getAll.isDelta)
+        mmx_backapi_emit_attr(e, MMXBA_STR_ATTR_DELTA, "1");
+    if (frontCoding)
+        mmx_backapi_emit_attr(e, MMXBA_STR_ATTR_ENC, MMXBA_STR_ENC_FRONT);
+    mmx_backapi_emit_start_end(e);
+
+    for (i = 0; i < num; i++)
+    {
+        obj = getAll ? req->getAll.objects[i] : req->addObj_resp.objects[i];
+        mmx_backapi_emit_start(e, MMXBA_STR_OBJKEYVALUES);
+        if (frontCoding && i > 0 &&
+            (prefixLen = front_prefix_len(req->getAll.objects[i - 1], obj)) > 0)
+        {
+            mmx_backapi_emit_attr_uint(e, MMXBA_STR_ATTR_PREFIX, prefixLen);
+            obj += prefixLen;
+        }
+        if (getAll && req->getAll.isDelta && req->getAll.objRemoved[i])
+            mmx_backapi_emit_attr(e, MMXBA_STR_ATTR_REMOVED, "1");
+        mmx_backapi_emit_start_end(e);
+        mmx_backapi_emit_text(e, obj);
+        mmx_backapi_emit_close(e, MMXBA_STR_OBJKEYVALUES);
+    }
+    mmx_backapi_emit_close(e, MMXBA_STR_OBJECTS);
+
+    if (getAll && req->getAll.generation)
+        mmx_backapi_emit_elem_uint(e, MMXBA_STR_GENERATION, req->getAll.generation);
+}
+
+/* Emitter variant of tree_add_sections() */
+static void emit_sections(mmxba_emitter_t *e, mmxba_request_t *req, int isRequest)
+{
+    uint32_t secs = mmxba_schema_sections(req->op_type, isRequest);
+    char (*names)[MMXBA_MAX_STR_LEN];
+    uint32_t *num;
+
+    for (; secs; secs &= secs - 1)
+    {
+        switch (secs & -secs)
+        {
+        case MMXBA_SEC_MMXINSTANCE:
+            mmx_backapi_emit_elem_text(e, MMXBA_STR_MMXINSTANCE, req->mmxInstances);
+            break;
+
+        case MMXBA_SEC_SUBSCRID:
+            mmx_backapi_emit_elem_uint(e, MMXBA_STR_SUBSCRID, req->subscrId);
+            break;
+
+        case MMXBA_SEC_KEYFILTER:
+            if (req->beKeyParamsNum == 0)
+                break;
+            /* fall through */
+        case MMXBA_SEC_BEKEYPARAMS:
+            emit_nvpairs(e, MMXBA_STR_BEKEYPARAMS, req->beKeyParams, req->beKeyParamsNum, NULL);
+            break;
+
+        case MMXBA_SEC_NAMEFILTER:
+            if (req->paramNames.arraySize == 0)
+                break;
+            /* fall through */
+        case MMXBA_SEC_PARAMNAMES:
+            emit_names(e, MMXBA_STR_PARAMNAMES, req->paramNames.paramNames,
+                       req->paramNames.arraySize);
+            break;
+
+        case MMXBA_SEC_PARAMVALUES:
+        case MMXBA_SEC_CHANGES:
+            emit_nvpairs(e, MMXBA_STR_PARAMVALUES, req->paramValues.paramValues,
+                         req->paramValues.arraySize, req->valTypes);
+            break;
+
+        case MMXBA_SEC_NEWVALUES:
+            emit_nvpairs(e, MMXBA_STR_PARAMVALUES, req->addObj_req.paramValues,
+                         req->addObj_req.paramNum, req->valTypes);
+            break;
+
+        case MMXBA_SEC_BEKEYNAMES:
+            num = key_names(req, isRequest, &names);
+            emit_names(e, MMXBA_STR_BEKEYNAMES, names, *num);
+            break;
+
+        case MMXBA_SEC_QUERY:
+            if (req->getAll.generation)
+                mmx_backapi_emit_elem_uint(e, MMXBA_STR_GENERATION, req->getAll.generation);
+            if (req->getAll.objEnc == MMXBA_OBJ_ENC_FRONT)
+                mmx_backapi_emit_elem_text(e, MMXBA_STR_OBJENC, MMXBA_STR_ENC_FRONT);
+            break;
+
+        case MMXBA_SEC_OBJECTS:
+            emit_objects(e, req);
+            break;
+        }
+    }
+}
+
+/* Emits the request; the scatter-gather, size and buffer builders share it.
+   The same elements in the same order as mmx_backapi_request_build() */
+static int emit_request(mmxba_request_t *req, mmxba_emitter_t *e)
+{
+    int status = MMXBA_OK;
+    int op = req->op_type;
+
+    if (!verify_optype(op))
+        GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "%s: Unknown operation type %d", 
+                            __func__, op);
+
+    emit_root(e, MMXBA_STR_REQUEST);
+    mmx_backapi_emit_elem_text(e, MMXBA_STR_OPNAME, optype2str(op));
+    mmx_backapi_emit_elem_int(e, MMXBA_STR_SEQNUM, req->opSeqNum);
+    if (req->prio != MMXBA_PRIO_NORMAL)
+        mmx_backapi_emit_elem_uint(e, MMXBA_STR_PRIO, req->prio);
+    if (req->deadline)
+        mmx_backapi_emit_elem_uint(e, MMXBA_STR_DEADLINE, req->deadline);
+    mmx_backapi_emit_elem_text(e, MMXBA_STR_BEOBJNAME, req->beObjName);
+
+    emit_sections(e, req, TRUE);
+    mmx_backapi_emit_close(e, MMXBA_STR_REQUEST);
+
+    if (e->status != MMXBA_OK)
+        GOTO_RET_WITH_ERROR(e->status, "Could not emit request: message is too large");
+
+ret:
+    return status;
+}
+
+/* The same elements in the same order as mmx_backapi_response_build() */
+static int emit_response(mmxba_request_t *req, mmxba_emitter_t *e)
+{
+    int status = MMXBA_OK;
+    int op = req->op_type;
+
+    if (!verify_optype(op))
+        GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "%s: Unknown operation type %d", 
+                            __func__, op);
+
+    emit_root(e, MMXBA_STR_RESPONSE);
+    mmx_backapi_emit_elem_text(e, MMXBA_STR_OPNAME, optype2str(op));
+    mmx_backapi_emit_elem_int(e, MMXBA_STR_SEQNUM, req->opSeqNum);
+    mmx_backapi_emit_elem_int(e, MMXBA_STR_OPRESCODE, req->opResCode);
+    mmx_backapi_emit_elem_int(e, MMXBA_STR_OPEXTCODE, req->opExtErrCode);
+    mmx_backapi_emit_elem_text(e, MMXBA_STR_ERRMSG, req->errMsg);
+    mmx_backapi_emit_elem_int(e, MMX_STR_POSTOPSTATUS, req->postOpStatus);
+    mmx_backapi_emit_elem_text(e, MMXBA_STR_BEOBJNAME, req->beObjName);
+
+    emit_sections(e, req, FALSE);
+    mmx_backapi_emit_close(e, MMXBA_STR_RESPONSE);
+
+    if (e->status != MMXBA_OK)
+        GOTO_RET_WITH_ERROR(e->status, "Could not emit response: message is too large");
+
+ret:
+    return status;
+}
+
+static int emit_notify(mmxba_request_t *req, mmxba_emitter_t *e)
+{
+    int status = MMXBA_OK;
+
+    if (req->op_type != MMXBA_OP_TYPE_NOTIFY)
+        GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "%s: Bad operation type %d",
+                            __func__, req->op_type);
+
+    emit_root(e, MMXBA_STR_NOTIFY);
+    mmx_backapi_emit_elem_text(e, MMXBA_STR_OPNAME, optype2str(req->op_type));
+    mmx_backapi_emit_elem_int(e, MMXBA_STR_SEQNUM, req->opSeqNum);
+    mmx_backapi_emit_elem_text(e, MMXBA_STR_BEOBJNAME, req->beObjName);
+    emit_sections(e, req, TRUE);
+    mmx_backapi_emit_close(e, MMXBA_STR_NOTIFY);
+
+    if (e->status != MMXBA_OK)
+        GOTO_RET_WITH_ERROR(e->status, "Could not emit notification: message is too large");
+
+ret:
+    return status;
+}
+
+typedef int (*emit_message_t)(mmxba_request_t *req, mmxba_emitter_t *e);
+
+/* Measures the message by the counting emitter */
+static int message_size(mmxba_request_t *req, emit_message_t emit, size_t *size)
+{
+    mmxba_emitter_t e;
+    int status;
+
+    mmx_backapi_emit_init(&e, NULL, 0, NULL, 0);
+    if ((status = emit(req, &e)) == MMXBA_OK)
+        *size = e.total;
+
+    return status;
+}
+
+/* Measures the message, grows the buffer to the exact size if needed and
+   emits the message into it contiguously */
+static int message_build_buf(mmxba_request_t *req, emit_message_t emit,
+                             mmxba_outbuf_t *buf)
+{
+    int status = MMXBA_OK;
+    mmxba_emitter_t e;
+    struct iovec iov;
+    size_t len = 0;
+    char *data;
+
+    if ((status = message_size(req, emit, &len)) != MMXBA_OK)
+        goto ret;
+
+    if (len + 1 > buf->size)
+    {
+        data = buf->grow ? buf->grow(buf->arg, buf->data, len + 1)
+                         : realloc(buf->data, len + 1);
+        if (data == NULL)
+            GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY,
+                                "Could not grow output buffer to %zu bytes", len + 1);
+        buf->data = data;
+        buf->size = len + 1;
+    }
+
+    /* One iovec entry makes the emitter copy everything to the buffer */
+    mmx_backapi_emit_init(&e, &iov, 1, buf->data, buf->size);
+    if ((status = emit(req, &e)) != MMXBA_OK)
+        goto ret;
+
+    buf->data[e.total] = '\0';
+    buf->len = e.total;
+
+ret:
+    return status;
+}
+
+/* Parses priority and deadline of the request header; both are optional:
+   requests of the normal priority and callers without deadline do not
+   send them, responses never have them */
+static void tree_get_qos(mxml_node_t *tree, mmxba_request_t *req, int isRequest)
+{
+    mxml_node_t *node;
+    const char *s;
+    int prio;
+
+    req->prio = MMXBA_PRIO_NORMAL;
+    req->deadline = 0;
+    if (!isRequest)
+        return;
+
+    if ((node = mxmlFindElement(tree, tree, MMXBA_STR_PRIO, NULL, NULL, MXML_DESCEND)) != NULL)
+    {
+        s = mxmlGetOpaque(node);
+        prio = atoi(s ? s : "0");
+        if (prio >= 0 && prio < MMXBA_PRIO_NUM)
+            req->prio = prio;
+    }
+
+    if ((node = mxmlFindElement(tree, tree, MMXBA_STR_DEADLINE, NULL, NULL, MXML_DESCEND)) != NULL)
+    {
+        s = mxmlGetOpaque(node);
+        req->deadline = strtoull(s ? s : "0", NULL, 10);
+    }
+}
+
+/* Finds the start tag of the header element: prio and deadline are
+   written before beObjName, so the search stops there and the body of
+   the messages without them is not scanned */
+static const char *header_find(const char *xml_string, const char *tag)
+{
+    const char *end = strstr(xml_string, "<" MMXBA_STR_BEOBJNAME ">");
+    size_t len = strlen(tag);
+    const char *s;
+
+    for (s = xml_string; (s = strchr(s, '<')) != NULL && (end == NULL || s < end); s++)
     {
-    case MMXBA_OP_TYPE_GET: return MMXBA_STR_OPER_GET; break;
-    case MMXBA_OP_TYPE_SET: return MMXBA_STR_OPER_SET; break;
-    case MMXBA_OP_TYPE_GETALL: return MMXBA_STR_OPER_GETALL; break;
-    case MMXBA_OP_TYPE_ADDOBJ: return MMXBA_STR_OPER_ADDOBJ; break;
-    case MMXBA_OP_TYPE_DELOBJ: return MMXBA_STR_OPER_DELOBJ; break;
-    default: return "UNKNOWN";
+        if (!strncmp(s, tag, len))
+            return s;
     }
+
+    return NULL;
 }
 
+/* Parses objects of GETALL or ADDOBJ response */
+static int tree_get_objects(mxml_node_t *tree, mmxba_request_t *req)
+{
+    int status = MMXBA_OK;
+    mxml_node_t *node;
+    uint32_t i;
+
+    if (req->op_type == MMXBA_OP_TYPE_ADDOBJ)
+    {
+        if ((node = mxmlFindElement(tree, tree, MMXBA_STR_OBJECTS,
+                                    NULL, NULL, MXML_DESCEND)) != NULL)
+        {
+            XML_PARSE_GET_NAMES(node, tree, MMXBA_STR_OBJKEYVALUES, 1,
+                                req->addObj_resp.objNum, req->addObj_resp.objects, NULL, NULL);
+
+            for (i = 0; i < req->addObj_resp.objNum; i++)
+                mmxba_object_split_keys(req->addObj_resp.objects[i], req->addObj_resp.objKeys[i],
+                                        req->addObj_resp.beKeyNamesNum);
+        }
+        goto ret;
+    }
+
+    /* Generation is optional: peers not supporting it do not send it */
+    req->getAll.generation = 0;
+    req->getAll.isDelta = FALSE;
+    req->getAll.objEnc = MMXBA_OBJ_ENC_PLAIN;
+    if ((node = mxmlFindElement(tree, tree, MMXBA_STR_GENERATION,
+                                NULL, NULL, MXML_DESCEND)) != NULL)
+    {
+        const char *gen = mxmlGetOpaque(node);
+        req->getAll.generation = strtoul(gen ? gen : "0", NULL, 10);
+    }
+
+    if ((node = mxmlFindElement(tree, tree, MMXBA_STR_OBJECTS,
+                                NULL, NULL, MXML_DESCEND)) == NULL)
+        goto ret;
+
+    XML_PARSE_GET_NAMES(node, tree, MMXBA_STR_OBJKEYVALUES,
+        MMXBA_MAX_NUMBER_OF_GETALL_PARAMS, req->getAll.objNum, req->getAll.objects, NULL, NULL);
+
+    /* Delta response: objects added or removed since the requested
+       generation; front coded objects are expanded in place */
+    const char *delta = mxmlElementGetAttrValue(node, MMXBA_STR_ATTR_DELTA);
+    const char *enc = mxmlElementGetAttrValue(node, MMXBA_STR_ATTR_ENC);
+    req->getAll.isDelta = (delta && atoi(delta)) ? TRUE : FALSE;
+    req->getAll.objEnc = (enc && !strcmp(enc, MMXBA_STR_ENC_FRONT)) ?
+                          MMXBA_OBJ_ENC_FRONT : MMXBA_OBJ_ENC_PLAIN;
+    if (req->getAll.isDelta || req->getAll.objEnc == MMXBA_OBJ_ENC_FRONT)
+    {
+        i = 0;
+        for (mxml_node_t *n = mxmlFindElement(node, tree, MMXBA_STR_OBJKEYVALUES,
+                                              NULL, NULL, MXML_DESCEND);
+             n != NULL && i < req->getAll.objNum;
+             n = mxmlFindElement(n, tree, MMXBA_STR_OBJKEYVALUES,
+                                 NULL, NULL, MXML_DESCEND), i++)
+        {
+            const char *removed = mxmlElementGetAttrValue(n, MMXBA_STR_ATTR_REMOVED);
+            req->getAll.objRemoved[i] = (removed && atoi(removed)) ? TRUE : FALSE;
+
+            if (i > 0 && req->getAll.objEnc == MMXBA_OBJ_ENC_FRONT &&
+                mmxba_front_expand(req->getAll.objects[i], req->getAll.objects[i - 1],
+                                   mxmlElementGetAttrValue(n, MMXBA_STR_ATTR_PREFIX)) != MMXBA_OK)
+                GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Bad front coded object %u", i);
+        }
+    }
+
+    for (i = 0; i < req->getAll.objNum; i++)
+        mmxba_object_split_keys(req->getAll.objects[i], req->getAll.objKeys[i],
+                                req->getAll.beKeyNamesNum);
+
+ret:
+    return status;
+}
+
+/* Returns tag of the section element, NULL for sections of several elements */
+static const char *section_tag(uint32_t sec)
+{
+    switch (sec)
+    {
+    case MMXBA_SEC_MMXINSTANCE:     return MMXBA_STR_MMXINSTANCE;
+    case MMXBA_SEC_SUBSCRID:        return MMXBA_STR_SUBSCRID;
+    case MMXBA_SEC_BEKEYPARAMS:
+    case MMXBA_SEC_KEYFILTER:       return MMXBA_STR_BEKEYPARAMS;
+    case MMXBA_SEC_NAMEFILTER:
+    case MMXBA_SEC_PARAMNAMES:      return MMXBA_STR_PARAMNAMES;
+    case MMXBA_SEC_PARAMVALUES:
+    case MMXBA_SEC_CHANGES:
+    case MMXBA_SEC_NEWVALUES:       return MMXBA_STR_PARAMVALUES;
+    case MMXBA_SEC_BEKEYNAMES:      return MMXBA_STR_BEKEYNAMES;
+    default:                        return NULL;
+    }
+}
+
+/* Parses the sections of the message body; missing optional sections
+   leave their arrays empty */
+static int tree_get_sections(mxml_node_t *tree, mmxba_request_t *req, int isRequest,
+                             const msg_names_t *names)
+{
+    int status = MMXBA_OK;
+    uint32_t secs = mmxba_schema_sections(req->op_type, isRequest);
+    char (*keyNames)[MMXBA_MAX_STR_LEN];
+    mxml_node_t *node = NULL;
+    const char *tag, *s;
+    uint32_t *num, sec;
+
+    /* Objects are split by the key names, so they are parsed last */
+    for (; secs && status == MMXBA_OK; secs &= secs - 1)
+    {
+        sec = secs & -secs;
+
+        if ((tag = section_tag(sec)) != NULL &&
+            (node = mxmlFindElement(tree, tree, tag, NULL, NULL, MXML_DESCEND)) == NULL &&
+            (sec & MMXBA_SEC_REQUIRED))
+            GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Could not find tag `%s'", tag);
+
+        switch (sec)
+        {
+        case MMXBA_SEC_MMXINSTANCE:
+            s = mxmlGetOpaque(node);
+            strncpy(req->mmxInstances, s ? s : "", sizeof(req->mmxInstances));
+            break;
+
+        case MMXBA_SEC_SUBSCRID:
+            s = mxmlGetOpaque(node);
+            req->subscrId = strtoul(s ? s : "0", NULL, 10);
+            break;
+
+        case MMXBA_SEC_BEKEYPARAMS:
+        case MMXBA_SEC_KEYFILTER:
+            req->beKeyParamsNum = 0;
+            if (node)
+                XML_PARSE_GET_VALUES(req, node, tree, MMXBA_MAX_NUMBER_OF_KEY_PARAMS,
+                                     req->beKeyParamsNum, req->beKeyParams, FALSE,
+                                     names, req->beKeyIds);
+            break;
+
+        case MMXBA_SEC_PARAMNAMES:
+        case MMXBA_SEC_NAMEFILTER:
+            req->paramNames.arraySize = 0;
+            if (node)
+                XML_PARSE_GET_NAMES(node, tree, MMXBA_STR_NAME, MMXBA_MAX_NUMBER_OF_GET_PARAMS,
+                                    req->paramNames.arraySize, req->paramNames.paramNames,
+                                    names, req->nameIds);
+            else if (sec == MMXBA_SEC_PARAMNAMES)  /* print for debugging only */
+                ing_log(LOG_DEBUG,"%s: request does not contain param names\n", __func__);
+            break;
+
+        case MMXBA_SEC_PARAMVALUES:
+        case MMXBA_SEC_CHANGES:
+            req->paramValues.arraySize = 0;
+            if (node)
+                XML_PARSE_GET_VALUES(req, node, tree, MMXBA_MAX_NUMBER_OF_SET_PARAMS,
+                                     req->paramValues.arraySize, req->paramValues.paramValues,
+                                     TRUE, names, req->nameIds);
+            break;
+
+        case MMXBA_SEC_NEWVALUES:
+            req->addObj_req.paramNum = 0;
+            if (node)
+                XML_PARSE_GET_VALUES(req, node, tree, MMXBA_MAX_NUMBER_OF_SET_PARAMS,
+                                     req->addObj_req.paramNum, req->addObj_req.paramValues,
+                                     TRUE, names, req->nameIds);
+            break;
+
+        case MMXBA_SEC_BEKEYNAMES:
+            num = key_names(req, isRequest, &keyNames);
+            XML_PARSE_GET_NAMES(node, tree, MMXBA_STR_NAME, MMXBA_MAX_NUMBER_OF_KEY_PARAMS,
+                                *num, keyNames, names, NULL);
+            break;
+
+        case MMXBA_SEC_QUERY:
+            /* Both are optional: peers not supporting them do not send them */
+            req->getAll.generation = 0;
+            req->getAll.isDelta = FALSE;
+            req->getAll.objEnc = MMXBA_OBJ_ENC_PLAIN;
+            if ((node = mxmlFindElement(tree, tree, MMXBA_STR_GENERATION,
+                                        NULL, NULL, MXML_DESCEND)) != NULL)
+            {
+                s = mxmlGetOpaque(node);
+                req->getAll.generation = strtoul(s ? s : "0", NULL, 10);
+            }
+            if ((node = mxmlFindElement(tree, tree, MMXBA_STR_OBJENC,
+                                        NULL, NULL, MXML_DESCEND)) != NULL)
+            {
+                s = mxmlGetOpaque(node);
+                if (s && !strcmp(s, MMXBA_STR_ENC_FRONT))
+                    req->getAll.objEnc = MMXBA_OBJ_ENC_FRONT;
+            }
+            break;
+
+        case MMXBA_SEC_OBJECTS:
+            status = tree_get_objects(tree, req);
+            break;
+        }
+    }
+
+ret:
+    return status;
+}
 
 /* ------------------------------------------------------------------- */
 /*  ----------------    MMX Backend API functions  --------------------*/
@@ -247,20 +1181,24 @@ int mmx_backapi_message_hdr_parse( const char *xml_string,
     
     //ing_log(LOG_INFO,"%s: rootName = %s\n", __func__, rootName);
     
-    if (strcmp(rootName, MMXBA_STR_REQUEST) && strcmp(rootName, MMXBA_STR_RESPONSE))
+    if (strcmp(rootName, MMXBA_STR_REQUEST) && strcmp(rootName, MMXBA_STR_RESPONSE) &&
+        strcmp(rootName, MMXBA_STR_NOTIFY))
         GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Bad type of management message\n");
     
-    if (!strcmp(rootName, MMXBA_STR_REQUEST))
+    /* Notifications have no result code, as requests */
+    if (strcmp(rootName, MMXBA_STR_RESPONSE))
         isRequest = TRUE;
 
     /* Parse the common fields used both in request and in response*/
     XML_GET_TEXT(tree, tree, MMXBA_STR_OPNAME, buf, sizeof(buf));
-    req->op_type = optype2num(buf);
+    req->op_type = mmxba_optype2num(buf);
     if (!verify_optype(req->op_type))
         ing_log(LOG_DEBUG,"%s: Unknown operation type %d\n", __func__, req->op_type);
 
     XML_GET_INT(tree, tree, MMXBA_STR_SEQNUM, req->opSeqNum);
 
+    tree_get_qos(tree, req, isRequest);
+
     XML_GET_TEXT(tree, tree, MMXBA_STR_BEOBJNAME, req->beObjName, sizeof(req->beObjName));
     
     /* Parse result code and error elements - used in responses only */
@@ -310,6 +1248,7 @@ int mmx_backapi_message_parse(const char *xml_string, mmxba_request_t *req)
     char *s;
     char *rootName = NULL;
     int isRequest = FALSE; 
+    msg_names_t names;
 
     mxml_node_t *node = NULL;
     mxml_node_t *tree = mxmlLoadString(NULL, xml_string, MXML_OPAQUE_CALLBACK);
@@ -323,20 +1262,32 @@ int mmx_backapi_message_parse(const char *xml_string, mmxba_request_t *req)
     
     /*ing_log(LOG_INFO,"%s: rootName = %s\n", __func__, rootName);*/
     
-    if (strcmp(rootName, MMXBA_STR_REQUEST) && strcmp(rootName, MMXBA_STR_RESPONSE))
+    if (strcmp(rootName, MMXBA_STR_REQUEST) && strcmp(rootName, MMXBA_STR_RESPONSE) &&
+        strcmp(rootName, MMXBA_STR_NOTIFY))
         GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "Bad type of management message");
     
-    if (!strcmp(rootName, MMXBA_STR_REQUEST))
+    /* Notifications have no result code, as requests */
+    if (strcmp(rootName, MMXBA_STR_RESPONSE))
         isRequest = TRUE;
 
+    /* Values of the previous message must not keep their types and ids */
+    memset(req->valTypes, 0, sizeof(req->valTypes));
+    memset(req->beKeyIds, 0, sizeof(req->beKeyIds));
+    memset(req->nameIds, 0, sizeof(req->nameIds));
+    req->nameIndex = NULL;
+
+    mmxba_names_init(&names, mxmlElementGetAttrValue(tree, MMXBA_STR_ATTR_DICT));
+
     /* Parse the common fields used both in request and in response*/
     XML_GET_TEXT(tree, tree, MMXBA_STR_OPNAME, buf, sizeof(buf));
-    req->op_type = optype2num(buf);
+    req->op_type = mmxba_optype2num(buf);
     if (!verify_optype(req->op_type))
         ing_log(LOG_DEBUG,"%s: Unknown operation type %d\n", __func__, req->op_type);
 
     XML_GET_INT(tree, tree, MMXBA_STR_SEQNUM, req->opSeqNum);
 
+    tree_get_qos(tree, req, isRequest);
+
     XML_GET_TEXT(tree, tree, MMXBA_STR_BEOBJNAME, req->beObjName, sizeof(req->beObjName));
     
     /* Parse result code and error elements - used in responses only */
@@ -370,104 +1321,15 @@ int mmx_backapi_message_parse(const char *xml_string, mmxba_request_t *req)
         }
     }
     
-    /* Parse  MMX instance element */
-    if (req->op_type == MMXBA_OP_TYPE_GET || req->op_type == MMXBA_OP_TYPE_SET ||
-        req->op_type == MMXBA_OP_TYPE_ADDOBJ || req->op_type == MMXBA_OP_TYPE_DELOBJ)
-    {
-        XML_GET_TEXT(tree, tree, MMXBA_STR_MMXINSTANCE, req->mmxInstances,
-                     sizeof(req->mmxInstances));
-    }
-    
-    /* Parse backend key parameters - used for GET/SET/DELOBJ operations*/
-    if (req->op_type == MMXBA_OP_TYPE_GET || req->op_type == MMXBA_OP_TYPE_SET ||
-        req->op_type == MMXBA_OP_TYPE_ADDOBJ || req->op_type == MMXBA_OP_TYPE_DELOBJ)
-    {
-        XML_GET_NODE(tree, tree, MMXBA_STR_BEKEYPARAMS, node);
-        XML_PARSE_GET_VALUES(req, node, tree, MMXBA_MAX_NUMBER_OF_KEY_PARAMS, 
-                             req->beKeyParamsNum, req->beKeyParams);
-    }
-
-    /* Parse param names - used only in GET request */
-    if (isRequest && req->op_type == MMXBA_OP_TYPE_GET)
-    { 
-        if ((node = mxmlFindElement(tree, tree, MMXBA_STR_PARAMNAMES, NULL, NULL, MXML_DESCEND)) != NULL)
-        {
-            XML_PARSE_GET_NAMES(node, tree, MMXBA_STR_NAME, MMXBA_MAX_NUMBER_OF_GET_PARAMS, 
-                                req->paramNames.arraySize, req->paramNames.paramNames);
-        }
-        else  /* print for debugging only */
-            ing_log(LOG_DEBUG,"%s:GET request does not contain param names\n", __func__);
-    }
-    
-    /* Parse param-name value pairs: used in GET response and SET request*/
-    if ((!isRequest && req->op_type == MMXBA_OP_TYPE_GET) || 
-         (isRequest && req->op_type == MMXBA_OP_TYPE_SET))
-    {
-        if ((node = mxmlFindElement(tree, tree, MMXBA_STR_PARAMVALUES, 
-                                    NULL, NULL, MXML_DESCEND)) != NULL)
-        {
-            XML_PARSE_GET_VALUES(req, node, tree, MMXBA_MAX_NUMBER_OF_SET_PARAMS, 
-                                 req->paramValues.arraySize, req->paramValues.paramValues);
-        }
-    }
-    
-    /* Parse BE key param names in GETALL request and response*/
-    if (req->op_type == MMXBA_OP_TYPE_GETALL)
-    {
-       if ((node = mxmlFindElement(tree, tree, MMXBA_STR_BEKEYNAMES, 
-                                         NULL, NULL, MXML_DESCEND)) == NULL)
-            GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, MMXBA_STR_BEKEYNAMES" tag not found");
-
-        XML_PARSE_GET_NAMES(node, tree, MMXBA_STR_NAME, MMXBA_MAX_NUMBER_OF_KEY_PARAMS,
-                            req->getAll.beKeyNamesNum, req->getAll.beKeyNames); 
-        
-    }
-    
-    /* Parse BE key param names in ADDOBJ request and response*/
-    if (req->op_type == MMXBA_OP_TYPE_ADDOBJ)
-    {
-        if ((node = mxmlFindElement(tree, tree, MMXBA_STR_BEKEYNAMES, 
-                                           NULL, NULL, MXML_DESCEND)) == NULL)
-            GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, MMXBA_STR_BEKEYNAMES" tag not found");
+    /* Parse the sections of the operation */
+    if ((status = tree_get_sections(tree, req, isRequest, &names)) != MMXBA_OK)
+        goto ret;
 
-        XML_PARSE_GET_NAMES(node, tree, MMXBA_STR_NAME, MMXBA_MAX_NUMBER_OF_KEY_PARAMS, 
-                            req->addObj_resp.beKeyNamesNum, req->addObj_resp.beKeyNames);
-    }
-    
-    /* Parse param-name value pairs used in ADDOBJ request*/
-    if (isRequest && req->op_type == MMXBA_OP_TYPE_ADDOBJ)
-    {
-        if ((node = mxmlFindElement(tree, tree, MMXBA_STR_PARAMVALUES, 
-                                    NULL, NULL, MXML_DESCEND)) != NULL)
-        {
-            XML_PARSE_GET_VALUES(req, node, tree, MMXBA_MAX_NUMBER_OF_SET_PARAMS, 
-                    req->addObj_req.paramNum, req->addObj_req.paramValues);
-        }
-    }
-    
-    /* Parse BE key param names and key values ("BE object instance")
-       in GETALL and ADDOBJ responses                                */
-    if (!isRequest && req->op_type == MMXBA_OP_TYPE_GETALL)
-    {
-        if ((node = mxmlFindElement(tree, tree, MMXBA_STR_OBJECTS, 
-                                         NULL, NULL, MXML_DESCEND)) != NULL)
-        {
-            XML_PARSE_GET_NAMES(node, tree, MMXBA_STR_OBJKEYVALUES, 
-                MMXBA_MAX_NUMBER_OF_GETALL_PARAMS, req->getAll.objNum, req->getAll.objects);
-        }
-    }
+    /* Notifications have no result code */
+    if (req->op_type == MMXBA_OP_TYPE_NOTIFY)
+        req->opResCode = 0;
 
-    if (!isRequest && req->op_type == MMXBA_OP_TYPE_ADDOBJ)
-    {
-        /* Parse addStatus in ADOBG response */
-        
-        if ((node = mxmlFindElement(tree, tree, MMXBA_STR_OBJECTS, 
-                                    NULL, NULL, MXML_DESCEND)) != NULL)
-        {
-            XML_PARSE_GET_NAMES(node, tree, MMXBA_STR_OBJKEYVALUES, 1,
-                                req->addObj_resp.objNum, req->addObj_resp.objects);
-        }
-    }
+    mmxba_message_finish(req, isRequest);
 
 ret:
     mxmlDelete(tree);
@@ -477,14 +1339,9 @@ ret:
 int mmx_backapi_request_build(mmxba_request_t *req, char *xml_string, size_t xml_string_size)
 {
     int status = MMXBA_OK;
-    int i = 0;
-    int arraySize = 0;
-    char buf[MMXBA_MAX_NUMBER_OF_ANY_OP_PARAMS];
-    nvpair_t  *pnv = NULL;  /* param name-value pairs*/
-    char *beKeyName;
+    char deadlineStr[24];
 
     mxml_node_t *tree = NULL, *node = NULL;
-    mxml_node_t *subnode1 = NULL, *subnode2 = NULL;
 
     if (!verify_optype(req->op_type))
         GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "%s: Unknown operation type %d", 
@@ -493,104 +1350,30 @@ int mmx_backapi_request_build(mmxba_request_t *req, char *xml_string, size_t xml
     tree = mxmlNewElement(MXML_NO_PARENT, MMXBA_STR_REQUEST);
     if (!tree)
         GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not create root element");
+    write_dict_attr(tree);
 
     /* ---- Add common header nodes that used by all requests -----*/
     XML_WRITE_TEXT(node, tree, MMXBA_STR_OPNAME, optype2str(req->op_type));
     XML_WRITE_INT( node, tree, MMXBA_STR_SEQNUM, req->opSeqNum);
-    XML_WRITE_TEXT(node, tree, MMXBA_STR_BEOBJNAME, req->beObjName);
-    
-    /* ---- Add different nodes for different request types ----- */
-    
-    /* MMX instance is known and so should be added to the request 
-       for GET, SET, ADDOBJ, DELOBJ requests */
-    if (req->op_type == MMXBA_OP_TYPE_GET || req->op_type == MMXBA_OP_TYPE_SET ||
-        req->op_type == MMXBA_OP_TYPE_ADDOBJ || req->op_type == MMXBA_OP_TYPE_DELOBJ)
-    {
-        XML_WRITE_TEXT(node, tree, MMXBA_STR_MMXINSTANCE, req->mmxInstances);
-    }
-
-    /* Values of backend key parameters are used for GET, SET, ADD/DELOBJ */
-    if (req->op_type == MMXBA_OP_TYPE_GET || req->op_type == MMXBA_OP_TYPE_SET ||
-        req->op_type == MMXBA_OP_TYPE_DELOBJ || req->op_type == MMXBA_OP_TYPE_ADDOBJ)
+    if (req->prio != MMXBA_PRIO_NORMAL)
+        XML_WRITE_INT(node, tree, MMXBA_STR_PRIO, req->prio);
+    if (req->deadline)
     {
-        node = mxmlNewElement(tree, MMXBA_STR_BEKEYPARAMS);
-        sprintf(buf, "%d", req->beKeyParamsNum);
-        mxmlElementSetAttr(node, MMXBA_STR_ATTR_ARRAYSIZE, buf);
-
-        for (i = 0; i < req->beKeyParamsNum; i++)
-        {
-            subnode1 = mxmlNewElement(node, MMXBA_STR_NAMEVALUEPAIR);
-            subnode2 = mxmlNewElement(subnode1, MMXBA_STR_NAME);
-            mxmlNewText(subnode2, 0, req->beKeyParams[i].name);
-            subnode2 = mxmlNewElement(subnode1, MMXBA_STR_VALUE);
-            mxmlNewText(subnode2, 0, req->beKeyParams[i].pValue);
-        }
-    }
-    
-    /* Names of backend key params are used for GETALL and ADDOBJ requests */
-    if (req->op_type == MMXBA_OP_TYPE_GETALL || req->op_type == MMXBA_OP_TYPE_ADDOBJ )
-    {
-        arraySize = (req->op_type == MMXBA_OP_TYPE_GETALL) ? 
-                req->getAll.beKeyNamesNum : req->addObj_req.beKeyNamesNum;
-        
-        sprintf(buf, "%d", arraySize);
-        node = mxmlNewElement(tree, MMXBA_STR_BEKEYNAMES);
-        mxmlElementSetAttr(node, MMXBA_STR_ATTR_ARRAYSIZE, buf);
-
-        for (i = 0; i < arraySize; i++)
-        {
-            beKeyName = (req->op_type == MMXBA_OP_TYPE_GETALL) ? 
-                    (char*)req->getAll.beKeyNames[i] : (char*)req->addObj_req.beKeyNames[i];
-            subnode1 = mxmlNewElement(node, MMXBA_STR_NAME);
-            mxmlNewText(subnode1, 0, beKeyName);
-        }
+        /* Written before beObjName: peek looks for it in the header only */
+        sprintf(deadlineStr, "%" PRIu64, req->deadline);
+        XML_WRITE_TEXT(node, tree, MMXBA_STR_DEADLINE, deadlineStr);
     }
+    XML_WRITE_TEXT(node, tree, MMXBA_STR_BEOBJNAME, req->beObjName);
     
-    /* Param names array is used for GET request */
-    if (req->op_type == MMXBA_OP_TYPE_GET)
-    {
-        node = mxmlNewElement(tree, MMXBA_STR_PARAMNAMES);
-        sprintf(buf, "%d", req->paramNames.arraySize);
-        mxmlElementSetAttr(node, MMXBA_STR_ATTR_ARRAYSIZE, buf);
-
-        for (i = 0; i < req->paramNames.arraySize; i++)
-        {
-            subnode1 = mxmlNewElement(node, MMXBA_STR_NAME);
-            mxmlNewText(subnode1, 0, req->paramNames.paramNames[i]);
-        }
-    }
-
-    /* Param values array is used for SET and ADDOBJ request */
-    if (req->op_type == MMXBA_OP_TYPE_SET || req->op_type == MMXBA_OP_TYPE_ADDOBJ)
-    {
-        if (req->op_type == MMXBA_OP_TYPE_SET)
-        {
-            arraySize = req->paramValues.arraySize;
-            pnv = (nvpair_t *)&req->paramValues.paramValues;
-        }
-        else 
-        {
-            arraySize = req->addObj_req.paramNum;
-            pnv = (nvpair_t *)&req->addObj_req.paramValues;
-        }
-        
-        node = mxmlNewElement(tree, MMXBA_STR_PARAMVALUES);
-        sprintf(buf, "%d", arraySize);
-        mxmlElementSetAttr(node, MMXBA_STR_ATTR_ARRAYSIZE, buf);
+    /* ---- Add the sections of the request type ----- */
+    if ((status = tree_add_sections(tree, req, TRUE)) != MMXBA_OK)
+        goto ret;
 
-        for (i = 0; i < arraySize; i++)
-        {
-            subnode1 = mxmlNewElement(node, MMXBA_STR_NAMEVALUEPAIR);
-            subnode2 = mxmlNewElement(subnode1, MMXBA_STR_NAME);
-            mxmlNewText(subnode2, 0, pnv[i].name);
-            subnode2 = mxmlNewElement(subnode1, MMXBA_STR_VALUE);
-            mxmlNewText(subnode2, 0, pnv[i].pValue);
-        }
-    }
-    
     if (mxmlSaveString(tree, xml_string, xml_string_size, MXML_NO_CALLBACK) <= 0)
         GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not save request to string");
 
+    mmx_backapi_cache_observe(req, TRUE);
+
 ret:
     if (tree)
         mxmlDelete(tree);
@@ -601,13 +1384,8 @@ ret:
 int mmx_backapi_response_build(mmxba_request_t *req, char *xml_string, size_t xml_string_size)
 {
     int status = MMXBA_OK;
-    int i = 0;
-    char buf[MMXBA_MAX_NUMBER_OF_ANY_OP_PARAMS];
-    int arraySize = 0;
-    char * tempStr;
 
     mxml_node_t *tree = NULL, *node = NULL;
-    mxml_node_t *subnode1 = NULL, *subnode2 = NULL;
 
     if (!verify_optype(req->op_type))
         GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "%s: Unknown operation type %d", 
@@ -617,6 +1395,7 @@ int mmx_backapi_response_build(mmxba_request_t *req, char *xml_string, size_t xm
     tree = mxmlNewElement(MXML_NO_PARENT, MMXBA_STR_RESPONSE);
     if (!tree)
         GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not create root element");
+    write_dict_attr(tree);
 
    /* ---- Add common header nodes that used by all responses -----*/
     XML_WRITE_TEXT(node, tree, MMXBA_STR_OPNAME, optype2str(req->op_type));
@@ -627,96 +1406,120 @@ int mmx_backapi_response_build(mmxba_request_t *req, char *xml_string, size_t xm
     XML_WRITE_INT(node, tree, MMX_STR_POSTOPSTATUS, req->postOpStatus);
     XML_WRITE_TEXT(node, tree, MMXBA_STR_BEOBJNAME, req->beObjName);
 
-    /* MMX instance should be added to the response of 
-       GET, SET, ADDOBJ, DELOBJ operations */
-    if (req->op_type == MMXBA_OP_TYPE_GET || req->op_type == MMXBA_OP_TYPE_SET ||
-         req->op_type == MMXBA_OP_TYPE_ADDOBJ || req->op_type == MMXBA_OP_TYPE_DELOBJ)
-    {
-        XML_WRITE_TEXT(node, tree, MMXBA_STR_MMXINSTANCE, req->mmxInstances);
-    }
+    /* ---- Add the sections of the response type ----- */
+    if ((status = tree_add_sections(tree, req, FALSE)) != MMXBA_OK)
+        goto ret;
 
-    /* Add BE key params for GET/SET/DELOBJ response: the same as in requests*/
-    if (req->op_type == MMXBA_OP_TYPE_GET || req->op_type == MMXBA_OP_TYPE_SET ||
-        req->op_type == MMXBA_OP_TYPE_ADDOBJ || req->op_type == MMXBA_OP_TYPE_DELOBJ )
-    {
-        node = mxmlNewElement(tree, MMXBA_STR_BEKEYPARAMS);
-        sprintf(buf, "%d", req->beKeyParamsNum);
-        mxmlElementSetAttr(node, MMXBA_STR_ATTR_ARRAYSIZE, buf);
+    if (mxmlSaveString(tree, xml_string, xml_string_size, MXML_NO_CALLBACK) <= 0)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not save request to string");
 
-        for (i = 0; i < req->beKeyParamsNum; i++)
-        {
-            subnode1 = mxmlNewElement(node, MMXBA_STR_NAMEVALUEPAIR);
-            subnode2 = mxmlNewElement(subnode1, MMXBA_STR_NAME);
-            mxmlNewText(subnode2, 0, req->beKeyParams[i].name);
-            subnode2 = mxmlNewElement(subnode1, MMXBA_STR_VALUE);
-            mxmlNewText(subnode2, 0, req->beKeyParams[i].pValue);
-        }
-    }
+    mmx_backapi_cache_observe(req, FALSE);
 
-    /* Add resulting name-value parameters for GET response */
-    if (req->op_type == MMXBA_OP_TYPE_GET) 
-    {
-        node = mxmlNewElement(tree, MMXBA_STR_PARAMVALUES);
-        sprintf(buf, "%d", req->paramValues.arraySize);
-        mxmlElementSetAttr(node, MMXBA_STR_ATTR_ARRAYSIZE, buf);
+ret:
+    if (tree)
+        mxmlDelete(tree);
+    
+    return status;
+}
 
-        for (i = 0; i < req->paramValues.arraySize; i++)
-        {
-            subnode1 = mxmlNewElement(node, MMXBA_STR_NAMEVALUEPAIR);
-            subnode2 = mxmlNewElement(subnode1, MMXBA_STR_NAME);
-            mxmlNewText(subnode2, 0, req->paramValues.paramValues[i].name);
-            subnode2 = mxmlNewElement(subnode1, MMXBA_STR_VALUE);
-            mxmlNewText(subnode2, 0, req->paramValues.paramValues[i].pValue);
-        }
-    }
+int mmx_backapi_notify_build(mmxba_request_t *req, char *xml_string, size_t xml_string_size)
+{
+    int status = MMXBA_OK;
 
-    /* Add BE key param names and BE instance for GETALL and ADDOBJ responses*/
-    if (req->op_type == MMXBA_OP_TYPE_GETALL || 
-        req->op_type == MMXBA_OP_TYPE_ADDOBJ)
-    {
-        /* Process BE key names array */
-        arraySize = (req->op_type == MMXBA_OP_TYPE_GETALL) ? 
-                     req->getAll.beKeyNamesNum : req->addObj_resp.beKeyNamesNum;
-        node = mxmlNewElement(tree, MMXBA_STR_BEKEYNAMES);
-        sprintf(buf, "%d", arraySize);
-        mxmlElementSetAttr(node, MMXBA_STR_ATTR_ARRAYSIZE, buf);
+    mxml_node_t *tree = NULL, *node = NULL;
 
-        for (i = 0; i < arraySize; i++)
-        {
-            tempStr = (req->op_type == MMXBA_OP_TYPE_GETALL) ? 
-                    (char*)req->getAll.beKeyNames[i] : 
-                    (char*)req->addObj_resp.beKeyNames[i];
-            subnode1 = mxmlNewElement(node, MMXBA_STR_NAME);
-            mxmlNewText(subnode1, 0, tempStr);
-        }
+    if (req->op_type != MMXBA_OP_TYPE_NOTIFY)
+        GOTO_RET_WITH_ERROR(MMXBA_INVALID_FORMAT, "%s: Bad operation type %d",
+                            __func__, req->op_type);
 
-        /* Process BE objects array */
-        arraySize = (req->op_type == MMXBA_OP_TYPE_GETALL) ? 
-                          req->getAll.objNum : req->addObj_resp.objNum;
-        node = mxmlNewElement(tree, MMXBA_STR_OBJECTS);
-        sprintf(buf, "%d", arraySize);
-        mxmlElementSetAttr(node, MMXBA_STR_ATTR_ARRAYSIZE, buf);
+    tree = mxmlNewElement(MXML_NO_PARENT, MMXBA_STR_NOTIFY);
+    if (!tree)
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not create root element");
+    write_dict_attr(tree);
 
-        for (i = 0; i < arraySize; i++)
-        {
-            tempStr = (req->op_type == MMXBA_OP_TYPE_GETALL) ? 
-                             (char*)req->getAll.objects[i] :
-                             (char*)req->addObj_resp.objects[i];
-            subnode1 = mxmlNewElement(node, MMXBA_STR_OBJKEYVALUES);
-            mxmlNewText(subnode1, 0, tempStr);
-        }
-    }
+    XML_WRITE_TEXT(node, tree, MMXBA_STR_OPNAME, optype2str(req->op_type));
+    XML_WRITE_INT(node, tree, MMXBA_STR_SEQNUM, req->opSeqNum);
+    XML_WRITE_TEXT(node, tree, MMXBA_STR_BEOBJNAME, req->beObjName);
+
+    /* Subscription id, backend object instance and changed values */
+    if ((status = tree_add_sections(tree, req, TRUE)) != MMXBA_OK)
+        goto ret;
 
     if (mxmlSaveString(tree, xml_string, xml_string_size, MXML_NO_CALLBACK) <= 0)
-        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not save request to string");
+        GOTO_RET_WITH_ERROR(MMXBA_SYSTEM_ERROR, "Could not save notification to string");
 
 ret:
     if (tree)
         mxmlDelete(tree);
-    
+
+    return status;
+}
+
+int mmx_backapi_request_buildv(mmxba_request_t *req, mmxba_emitter_t *e)
+{
+    int status = emit_request(req, e);
+
+    if (status == MMXBA_OK)
+        mmx_backapi_cache_observe(req, TRUE);
+
+    return status;
+}
+
+int mmx_backapi_response_buildv(mmxba_request_t *req, mmxba_emitter_t *e)
+{
+    int status = emit_response(req, e);
+
+    if (status == MMXBA_OK)
+        mmx_backapi_cache_observe(req, FALSE);
+
+    return status;
+}
+
+int mmx_backapi_notify_buildv(mmxba_request_t *req, mmxba_emitter_t *e)
+{
+    return emit_notify(req, e);
+}
+
+int mmx_backapi_request_size(mmxba_request_t *req, size_t *size)
+{
+    return message_size(req, emit_request, size);
+}
+
+int mmx_backapi_response_size(mmxba_request_t *req, size_t *size)
+{
+    return message_size(req, emit_response, size);
+}
+
+int mmx_backapi_notify_size(mmxba_request_t *req, size_t *size)
+{
+    return message_size(req, emit_notify, size);
+}
+
+int mmx_backapi_request_build_buf(mmxba_request_t *req, mmxba_outbuf_t *buf)
+{
+    int status = message_build_buf(req, emit_request, buf);
+
+    if (status == MMXBA_OK)
+        mmx_backapi_cache_observe(req, TRUE);
+
+    return status;
+}
+
+int mmx_backapi_response_build_buf(mmxba_request_t *req, mmxba_outbuf_t *buf)
+{
+    int status = message_build_buf(req, emit_response, buf);
+
+    if (status == MMXBA_OK)
+        mmx_backapi_cache_observe(req, FALSE);
+
     return status;
 }
 
+int mmx_backapi_notify_build_buf(mmxba_request_t *req, mmxba_outbuf_t *buf)
+{
+    return message_build_buf(req, emit_notify, buf);
+}
+
 
 /* --------------------------------------------------------------------
  *    Helper functions for work with message memory pool used 
@@ -749,6 +1552,15 @@ int mmx_backapi_msgstruct_init (mmxba_request_t *req, char *mem_buff,
     req->mem_pool.curr_offset = 0;
     req->mem_pool.initialized = 1;
 
+    memset(req->valTypes, 0, sizeof(req->valTypes));
+    memset(req->beKeyIds, 0, sizeof(req->beKeyIds));
+    memset(req->nameIds, 0, sizeof(req->nameIds));
+    req->parseFlags = 0;
+    req->nameIndex = NULL;
+    req->xferOut = NULL;
+    req->prio = MMXBA_PRIO_NORMAL;
+    req->deadline = 0;
+
 ret:
     return status;
 }
@@ -765,6 +1577,8 @@ int mmx_backapi_msgstruct_release (mmxba_request_t *req)
     req->mem_pool.curr_offset = 0;
 
     req->mem_pool.initialized = 0;
+    req->nameIndex = NULL;
+    req->xferOut = NULL;
 
     return 0;
 }
@@ -829,6 +1643,7 @@ int mmx_backapi_msgstruct_insert_nvpair(mmxba_request_t *req, nvpair_t *nvPair,
     int    status = 0;
     int    val_len = 0;
     size_t perm_len = 0;
+    int    idx;
 
    /* Verify input parameters */
    if ((req == NULL) || (name == NULL))
@@ -863,6 +1678,10 @@ int mmx_backapi_msgstruct_insert_nvpair(mmxba_request_t *req, nvpair_t *nvPair,
                             name, sizeof(nvPair->name));
 
     strcpy_safe(nvPair->name, name, sizeof(nvPair->name));
+
+    /* The value is untyped until a typed setter or the parser sets its type */
+    if ((idx = mmx_backapi_value_index(req, nvPair)) >= 0)
+        req->valTypes[idx] = MMXBA_VAL_TYPE_STRING;
     
     /*ing_log(LOG_DEBUG,"Backend api msg pool: curr offset %d, value %s\n",
                req->mem_pool.curr_offset,nvPair->pValue); */
@@ -870,3 +1689,157 @@ int mmx_backapi_msgstruct_insert_nvpair(mmxba_request_t *req, nvpair_t *nvPair,
 ret:
     return status;
 }
+
+int mmx_backapi_msgstruct_add_object(mmxba_request_t *req, const char *keys[],
+                                     uint32_t keyNum)
+{
+    int status = MMXBA_OK;
+    uint32_t *objNum, maxObjNum, k, len, pos = 0;
+    mmxba_key_ref_t *refs;
+    char *obj;
+
+    if (req == NULL || keys == NULL || keyNum == 0 || keyNum > MMXBA_MAX_NUMBER_OF_KEY_PARAMS)
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad input parameters", __func__);
+
+    if (req->op_type == MMXBA_OP_TYPE_GETALL)
+    {
+        objNum = &req->getAll.objNum;
+        maxObjNum = MMXBA_MAX_NUMBER_OF_GETALL_PARAMS;
+    }
+    else if (req->op_type == MMXBA_OP_TYPE_ADDOBJ)
+    {
+        objNum = &req->addObj_resp.objNum;
+        maxObjNum = MMXBA_MAX_NUMBER_OF_ADDED_INSTANCES;
+    }
+    else
+        GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "%s: Bad operation type %d",
+                            __func__, req->op_type);
+
+    if (*objNum >= maxObjNum)
+        GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Too many objects in the response");
+
+    if (req->op_type == MMXBA_OP_TYPE_GETALL)
+    {
+        obj = req->getAll.objects[*objNum];
+        refs = req->getAll.objKeys[*objNum];
+        req->getAll.objRemoved[*objNum] = FALSE;
+    }
+    else
+    {
+        obj = req->addObj_resp.objects[*objNum];
+        refs = req->addObj_resp.objKeys[*objNum];
+    }
+
+    /* The separators can not be escaped in the objKeyValues string */
+    for (k = 0; k < keyNum; k++)
+        if (keys[k] && strpbrk(keys[k], ",;"))
+            GOTO_RET_WITH_ERROR(MMXBA_BAD_INPUT_PARAMS, "Object key value \"%s\" contains "
+                                "a separator", keys[k]);
+
+    for (k = 0; k < keyNum; k++)
+    {
+        len = keys[k] ? strlen(keys[k]) : 0;
+        if (pos + len + 1 >= MMXBA_MAX_STR_LEN)
+            GOTO_RET_WITH_ERROR(MMXBA_NOT_ENOUGH_MEMORY, "Object key values are too long");
+
+        if (k)
+            obj[pos++] = ',';
+        memcpy(obj + pos, keys[k] ? keys[k] : "", len);
+        refs[k].off = pos;
+        refs[k].len = len;
+        pos += len;
+    }
+    obj[pos] = '\0';
+
+    (*objNum)++;
+
+ret:
+    return status;
+}
+
+const char *mmx_backapi_msgstruct_object_key(const mmxba_request_t *req, uint32_t obj,
+                                             uint32_t key, uint32_t *len)
+{
+    const mmxba_key_ref_t *ref;
+    const char *str;
+
+    if (req == NULL || key >= MMXBA_MAX_NUMBER_OF_KEY_PARAMS)
+        return NULL;
+
+    if (req->op_type == MMXBA_OP_TYPE_GETALL)
+    {
+        if (obj >= req->getAll.objNum || key >= req->getAll.beKeyNamesNum)
+            return NULL;
+        ref = &req->getAll.objKeys[obj][key];
+        str = req->getAll.objects[obj];
+    }
+    else if (req->op_type == MMXBA_OP_TYPE_ADDOBJ)
+    {
+        if (obj >= req->addObj_resp.objNum || key >= req->addObj_resp.beKeyNamesNum)
+            return NULL;
+        ref = &req->addObj_resp.objKeys[obj][key];
+        str = req->addObj_resp.objects[obj];
+    }
+    else
+        return NULL;
+
+    if (len)
+        *len = ref->len;
+
+    return str + ref->off;
+}
+
+
+uint64_t mmx_backapi_time_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+void mmx_backapi_request_set_budget(mmxba_request_t *req, uint32_t budget_ms)
+{
+    req->deadline = mmx_backapi_time_ms() + budget_ms;
+}
+
+uint64_t mmx_backapi_message_peek_deadline(const char *xml_string)
+{
+    static const char tag[] = "<" MMXBA_STR_DEADLINE ">";
+    const char *s = header_find(xml_string, tag);
+
+    return s ? strtoull(s + sizeof(tag) - 1, NULL, 10) : 0;
+}
+
+mmxba_prio_t mmx_backapi_message_peek_prio(const char *xml_string)
+{
+    static const char tag[] = "<" MMXBA_STR_PRIO ">";
+    const char *s = header_find(xml_string, tag);
+    int prio = s ? atoi(s + sizeof(tag) - 1) : MMXBA_PRIO_NORMAL;
+
+    return (prio >= 0 && prio < MMXBA_PRIO_NUM) ? prio : MMXBA_PRIO_NORMAL;
+}
+
+int mmx_backapi_deadline_expired(uint64_t deadline)
+{
+    return (deadline != 0 && mmx_backapi_time_ms() >= deadline);
+}
+
+uint32_t mmx_backapi_strhash(const char *str, uint32_t seed)
+{
+    uint32_t hash = 2166136261U ^ seed;
+
+    while (*str)
+    {
+        hash ^= (unsigned char)*str++;
+        hash *= 16777619U;
+    }
+
+    /* Final avalanche: the low bits are used as table index */
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bU;
+    hash ^= hash >> 13;
+
+    return hash;
+}
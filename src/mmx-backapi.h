@@ -95,6 +95,8 @@
 #define MMXBA_BAD_INPUT_PARAMS    4
 #define MMXBA_NOT_ENOUGH_MEMORY   5
 #define MMXBA_NOT_INITIALIZED     6
+#define MMXBA_TIMEOUT             7
+#define MMXBA_SHED                8   /* not processed: deadline expired */
 
 
 #define MMXBA_MAX_STR_OPNAME_LEN 16
@@ -111,9 +113,12 @@ extern char mmxba_flags[8];
 /* Message tags */
 #define MMXBA_STR_REQUEST        "mmxReqRequest"
 #define MMXBA_STR_RESPONSE       "mmxReqResponse"
+#define MMXBA_STR_NOTIFY         "mmxReqNotify"
 #define MMXBA_STR_OPNAME         "opName"
 #define MMXBA_STR_SEQNUM         "reqSeqNum"
 #define MMXBA_STR_BEOBJNAME      "beObjName"
+#define MMXBA_STR_DEADLINE       "deadline"
+#define MMXBA_STR_PRIO           "prio"
 #define MMXBA_STR_MMXINSTANCE    "mmxInstance"
 #define MMXBA_STR_BEKEYPARAMS    "beKeyParams"
 #define MMXBA_STR_BEKEYNAMES     "beKeyNames"
@@ -127,8 +132,29 @@ extern char mmxba_flags[8];
 
 #define MMXBA_STR_OBJECTS        "objects"
 #define MMXBA_STR_OBJKEYVALUES   "objKeyValues"
+#define MMXBA_STR_GENERATION     "generation"
+#define MMXBA_STR_SUBSCRID       "subscrId"
+#define MMXBA_STR_OBJENC         "objEnc"
 
 #define MMXBA_STR_ATTR_ARRAYSIZE  "arraySize"
+#define MMXBA_STR_ATTR_DELTA      "delta"
+#define MMXBA_STR_ATTR_REMOVED    "removed"
+#define MMXBA_STR_ATTR_ENC        "enc"
+#define MMXBA_STR_ATTR_PREFIX     "p"
+#define MMXBA_STR_ATTR_DICT       "dict"
+#define MMXBA_STR_ATTR_ID         "id"
+
+#define MMXBA_STR_ENC_FRONT       "fc"
+
+#define MMXBA_STR_ATTR_TYPE       "type"
+
+#define MMXBA_STR_TYPE_STRING     "string"
+#define MMXBA_STR_TYPE_INT        "int"
+#define MMXBA_STR_TYPE_UINT64     "uint64"
+#define MMXBA_STR_TYPE_BOOL       "bool"
+#define MMXBA_STR_TYPE_DATETIME   "datetime"
+#define MMXBA_STR_TYPE_BASE64     "base64"
+#define MMXBA_STR_TYPE_XFER       "xfer"
 
 /* #define MMXBA_STR_NAMEVALUEPAIR   "nameValuePair" */
 #define MMXBA_STR_NAMEVALUEPAIR   "nvPair"
@@ -140,6 +166,37 @@ extern char mmxba_flags[8];
 #define MMXBA_STR_OPER_GETALL     "GETALL"
 #define MMXBA_STR_OPER_ADDOBJ     "ADDOBJ"
 #define MMXBA_STR_OPER_DELOBJ     "DELOBJ"
+#define MMXBA_STR_OPER_SUBSCRIBE  "SUBSCRIBE"
+#define MMXBA_STR_OPER_UNSUBSCRIBE "UNSUBSCRIBE"
+#define MMXBA_STR_OPER_NOTIFY     "NOTIFY"
+
+/* Encodings of objKeyValues in GETALL response */
+#define MMXBA_OBJ_ENC_PLAIN       0
+#define MMXBA_OBJ_ENC_FRONT       1   /* front coding: each object is sent as */
+                                      /* length of the prefix shared with the */
+                                      /* previous object and the suffix       */
+
+/* Types of parameter values; untyped values are strings */
+typedef enum mmxba_val_type_e {
+    MMXBA_VAL_TYPE_STRING = 0,
+    MMXBA_VAL_TYPE_INT,
+    MMXBA_VAL_TYPE_UINT64,
+    MMXBA_VAL_TYPE_BOOL,
+    MMXBA_VAL_TYPE_DATETIME,
+    MMXBA_VAL_TYPE_BASE64,
+    MMXBA_VAL_TYPE_XFER,        /* handle of out-of-band transfer of the value */
+
+    MMXBA_VAL_TYPE_NUM
+} mmxba_val_type_t;
+
+/* Priority classes of requests */
+typedef enum mmxba_prio_e {
+    MMXBA_PRIO_NORMAL = 0,      /* default, not sent                 */
+    MMXBA_PRIO_INTERACTIVE,     /* web and CLI requests              */
+    MMXBA_PRIO_BULK,            /* GETALL sweeps, provisioning, etc. */
+
+    MMXBA_PRIO_NUM
+} mmxba_prio_t;
 
 typedef enum mmxba_op_type_e {
     MMXBA_OP_TYPE_ERROR = -1,
@@ -147,11 +204,33 @@ typedef enum mmxba_op_type_e {
     MMXBA_OP_TYPE_SET,
     MMXBA_OP_TYPE_GETALL,
     MMXBA_OP_TYPE_ADDOBJ,
-    MMXBA_OP_TYPE_DELOBJ
+    MMXBA_OP_TYPE_DELOBJ,
+    MMXBA_OP_TYPE_SUBSCRIBE,
+    MMXBA_OP_TYPE_UNSUBSCRIBE,
+    MMXBA_OP_TYPE_NOTIFY,   /* unsolicited message from Backend */
+
+    MMXBA_OP_TYPE_NUM       /* number of operation types */
 } mmxba_op_type_t;
 
 
 
+/* Flags of parsing set by the caller after mmx_backapi_msgstruct_init() */
+#define MMXBA_PARSE_FLAG_INDEX    0x01    /* build index of param names */
+                                          /* (see mmx-backapi-index.h)  */
+
+/* Size of nameIds: ids of paramNames or of paramValues */
+#if MMXBA_MAX_NUMBER_OF_GET_PARAMS > MMXBA_MAX_NUMBER_OF_SET_PARAMS
+#define MMXBA_MAX_NUMBER_OF_NAME_IDS  MMXBA_MAX_NUMBER_OF_GET_PARAMS
+#else
+#define MMXBA_MAX_NUMBER_OF_NAME_IDS  MMXBA_MAX_NUMBER_OF_SET_PARAMS
+#endif
+
+/* Key value of an object: substring of objKeyValues string of the object */
+typedef struct mmxba_key_ref_s {
+    uint16_t off;
+    uint16_t len;
+} mmxba_key_ref_t;
+
 typedef struct mmxba_req_mempool_s {
     int             initialized; 
     unsigned short  size_bytes;
@@ -167,6 +246,10 @@ typedef struct mmxba_req_mempool_s {
 typedef struct mmxba_request_s {
     mmxba_op_type_t op_type;            /* used in all messages */
     int opSeqNum;                       /* used in all messages */
+    uint64_t deadline;      /* used in requests: mmx_backapi_time_ms() time */
+                            /* after which the caller does not wait for the */
+                            /* response (0 - no deadline)                   */
+    uint8_t prio;           /* used in requests: priority class (mmxba_prio_t) */
     char beObjName[MMXBA_MAX_STR_LEN];  /* used in all messages */
 
     int opResCode;              /* result code, err code and err msg  */
@@ -179,20 +262,25 @@ typedef struct mmxba_request_s {
 
     char mmxInstances[32];  /* exactly specifies object in MMX EP; used in */
                             /* req and resp for GET/SET/ADDOBJ/DELOBJ oper */
+
+    uint32_t subscrId;      /* subscription id chosen by EP: used in    */
+                            /* SUBSCRIBE/UNSUBSCRIBE req, resp & NOTIFY */
     
     uint32_t beKeyParamsNum;  /* exactly specifies object in backend - */
-                              /* used for GET/SET/DELOBJ requests,     */
-                              /* or partially specifies in ADDOBJ req  */
+                              /* used for GET/SET/DELOBJ requests and  */
+                              /* NOTIFY, or partially specifies in     */
+                              /* ADDOBJ req and SUBSCRIBE req (filter) */
     nvpair_t beKeyParams[MMXBA_MAX_NUMBER_OF_KEY_PARAMS];
 
     union {
-        /* paramNames - used in GET request message */
+        /* paramNames - used in GET and SUBSCRIBE (filter) requests */
         struct {
             uint32_t arraySize;
             char paramNames[MMXBA_MAX_NUMBER_OF_GET_PARAMS][MMXBA_MAX_STR_LEN];
         } paramNames;
 
-        /* paramValues - used in SET or ADDOBJ requests and in GET response */
+        /* paramValues - used in SET or ADDOBJ requests, in GET response
+           and in NOTIFY message (changed values) */
         struct {
             uint32_t arraySize;
             nvpair_t paramValues[MMXBA_MAX_NUMBER_OF_SET_PARAMS];
@@ -205,6 +293,26 @@ typedef struct mmxba_request_s {
 
             uint32_t objNum;
             char objects[MMXBA_MAX_NUMBER_OF_GETALL_PARAMS][MMXBA_MAX_STR_LEN];
+
+            /* Generation of the backend objects table: in the request it
+               is the last generation seen by the caller (0 - none), in the
+               response it is the current one (0 - not supported)        */
+            uint32_t generation;
+            /* Set in the response if objects contain only the objects
+               added or removed since the requested generation; otherwise
+               the response is a full snapshot and objRemoved is not used */
+            uint8_t isDelta;
+            uint8_t objRemoved[MMXBA_MAX_NUMBER_OF_GETALL_PARAMS];
+
+            /* Encoding of objects: in the request it is the encoding
+               accepted by the caller, in the response - the used one.
+               The parser always expands objects to plain strings    */
+            uint8_t objEnc;
+
+            /* Structured view of objects: key values of each object
+               aligned with beKeyNames (filled by the parser and by
+               mmx_backapi_msgstruct_add_object())                   */
+            mmxba_key_ref_t objKeys[MMXBA_MAX_NUMBER_OF_GETALL_PARAMS][MMXBA_MAX_NUMBER_OF_KEY_PARAMS];
         } getAll;
  
         /* ADDOBJ request parameters */
@@ -232,9 +340,32 @@ typedef struct mmxba_request_s {
             uint32_t objNum;
             char objects[MMXBA_MAX_NUMBER_OF_ADDED_INSTANCES][MMXBA_MAX_STR_LEN];
 
+            /* Structured view of objects, as in getAll */
+            mmxba_key_ref_t objKeys[MMXBA_MAX_NUMBER_OF_ADDED_INSTANCES][MMXBA_MAX_NUMBER_OF_KEY_PARAMS];
         } addObj_resp;
     };
 
+    /* Types of param values (of paramValues, or of addObj_req.paramValues
+       in ADDOBJ request) and numeric values of typed int, uint64, bool
+       and datetime values decoded by the parser (see mmx-backapi-value.h) */
+    uint8_t valTypes[MMXBA_MAX_NUMBER_OF_SET_PARAMS];
+    int64_t valNums[MMXBA_MAX_NUMBER_OF_SET_PARAMS];
+
+    /* Dictionary ids of names of beKeyParams and of param names (of
+       paramNames, paramValues or addObj_req.paramValues) resolved by
+       the parser; 0 - no id (see mmx-backapi-dict.h)                */
+    uint16_t beKeyIds[MMXBA_MAX_NUMBER_OF_KEY_PARAMS];
+    uint16_t nameIds[MMXBA_MAX_NUMBER_OF_NAME_IDS];
+
+    /* Flags of parsing (MMXBA_PARSE_FLAG_xxx) and the hash index of
+       param names built by the parser in the memory pool (or NULL) */
+    uint32_t parseFlags;
+    struct mmxba_name_index_s *nameIndex;
+
+    /* Out-of-band transfers of values of xfer type inserted to the message
+       and not sent yet, allocated in the memory pool (see mmx-backapi-xfer.h) */
+    struct mmxba_xfer_out_s *xferOut;
+
     mmxba_req_mempool_t   mem_pool;
 } mmxba_request_t;
 
@@ -263,6 +394,60 @@ int mmx_backapi_request_build(mmxba_request_t *req, char *xml_string,
 int mmx_backapi_response_build(mmxba_request_t *req, char *xml_string, 
                                size_t xml_string_size);
 
+/*
+ * Writes unsolicited xml NOTIFY message from Backend to Entry point.
+ * opSeqNum of the notification is the sequence number of the notifying
+ * backend, it does not match any request.
+ */
+int mmx_backapi_notify_build(mmxba_request_t *req, char *xml_string,
+                             size_t xml_string_size);
+
+/*
+ * Scatter-gather variants of the builders: the message is added to the
+ * emitter as iovec entries (see mmx-backapi-emit.h) which refer to the
+ * param values of the request, so the request and its memory pool must
+ * be kept unchanged until the message is sent.
+ */
+struct mmxba_emitter_s;
+int mmx_backapi_request_buildv(mmxba_request_t *req, struct mmxba_emitter_s *e);
+int mmx_backapi_response_buildv(mmxba_request_t *req, struct mmxba_emitter_s *e);
+int mmx_backapi_notify_buildv(mmxba_request_t *req, struct mmxba_emitter_s *e);
+
+/*
+ * Exact length (without the terminating zero) of the message written by
+ * the scatter-gather and growable buffer builders. The message is only
+ * measured, nothing is copied or allocated.
+ */
+int mmx_backapi_request_size(mmxba_request_t *req, size_t *size);
+int mmx_backapi_response_size(mmxba_request_t *req, size_t *size);
+int mmx_backapi_notify_size(mmxba_request_t *req, size_t *size);
+
+/*
+ * Output buffer of the builders grown on demand to the exact message size.
+ * Memory is taken by grow(arg, data, size) which must behave as realloc;
+ * realloc itself is used if grow is NULL. The buffer is owned by the
+ * caller and may be reused for many messages: it is grown only when the
+ * message does not fit.
+ */
+typedef void *(*mmxba_outbuf_grow_t)(void *arg, void *data, size_t size);
+
+typedef struct mmxba_outbuf_s {
+    char                *data;
+    size_t              size;   /* allocated bytes */
+    size_t              len;    /* length of the last built message */
+
+    mmxba_outbuf_grow_t grow;
+    void                *arg;
+} mmxba_outbuf_t;
+
+/*
+ * Write zero-terminated xml message to the growable buffer, the message
+ * length is returned in buf->len. On failure the buffer is left valid.
+ */
+int mmx_backapi_request_build_buf(mmxba_request_t *req, mmxba_outbuf_t *buf);
+int mmx_backapi_response_build_buf(mmxba_request_t *req, mmxba_outbuf_t *buf);
+int mmx_backapi_notify_build_buf(mmxba_request_t *req, mmxba_outbuf_t *buf);
+
 
 
 /* --------------------------------------------------------------------
@@ -307,5 +492,58 @@ int mmx_backapi_msgstruct_insert_value (mmxba_request_t *req,
 int mmx_backapi_msgstruct_insert_nvpair(mmxba_request_t *req, nvpair_t *nvPair,
                                          char *name, char *value);
 
+/*
+ * Appends object of GETALL or ADDOBJ response given by its key values
+ * aligned with beKeyNames; the objKeyValues string is joined once here.
+ * The key values are joined by "," (objects by ";") without escaping:
+ * values containing either separator are rejected with
+ * MMXBA_BAD_INPUT_PARAMS.
+ */
+int mmx_backapi_msgstruct_add_object(mmxba_request_t *req, const char *keys[],
+                                     uint32_t keyNum);
+
+/*
+ * Returns key value (not null-terminated) of the object of GETALL or
+ * ADDOBJ response and its length, or NULL if there is no such key
+ */
+const char *mmx_backapi_msgstruct_object_key(const mmxba_request_t *req, uint32_t obj,
+                                             uint32_t key, uint32_t *len);
+
+
+/*
+ * Returns current time of the monotonic clock in milliseconds.
+ * The clock is common for all processes of the host, so its values
+ * can be compared by the Entry point and backends.
+ */
+uint64_t mmx_backapi_time_ms(void);
+
+/*
+ * Returns FNV-1a hash of the null-terminated string mixed with the seed
+ */
+uint32_t mmx_backapi_strhash(const char *str, uint32_t seed);
+
+/*
+ * Sets deadline of the request to budget_ms milliseconds from now
+ */
+void mmx_backapi_request_set_budget(mmxba_request_t *req, uint32_t budget_ms);
+
+/*
+ * Returns deadline of the request message without parsing it, 0 if it is
+ * not set. Only the header (before beObjName) is searched: the deadline
+ * is sent there after the sequence number and the priority.
+ */
+uint64_t mmx_backapi_message_peek_deadline(const char *xml_string);
+
+/*
+ * Returns priority class of the request message without parsing it; as
+ * the deadline it is searched in the header only
+ */
+mmxba_prio_t mmx_backapi_message_peek_prio(const char *xml_string);
+
+/*
+ * Returns TRUE if the deadline is set and expired
+ */
+int mmx_backapi_deadline_expired(uint64_t deadline);
+
 
 #endif /* MMX_BACKAPI_H_ */
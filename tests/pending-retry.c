@@ -0,0 +1,181 @@
+/* pending-retry.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Regression test of the pending table: requests retried from the timeout
+ * callbacks must not take the entries of the expired requests whose
+ * callbacks are not called yet.
+ *
+ * The table is linked without the rest of the library: the test clock and
+ * the log function are defined here.
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+
+#include "mmx-backapi-pending.h"
+
+#define TABLE_SIZE   4
+#define TICK_MS      10
+#define MAX_SEQ      (4 * TABLE_SIZE)
+
+static uint64_t now_ms = 1000;
+
+static mmxba_pending_t tbl;
+static int timeouts[MAX_SEQ];
+static int retried[TABLE_SIZE];
+static int failures;
+
+uint64_t mmx_backapi_time_ms(void)
+{
+    return now_ms;
+}
+
+void ing_log(int level, const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+}
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+/* Retries every expired request once with a long timeout */
+static void timeout_cb(void *ctx, int opSeqNum, mmxba_request_t *resp, int status)
+{
+    int seq;
+
+    CHECK(status == MMXBA_TIMEOUT && resp == NULL);
+    CHECK(opSeqNum >= 0 && opSeqNum < MAX_SEQ);
+    if (opSeqNum < 0 || opSeqNum >= MAX_SEQ)
+        return;
+
+    timeouts[opSeqNum]++;
+    if (opSeqNum >= TABLE_SIZE)
+        return;
+
+    seq = mmx_backapi_pending_next_seq(&tbl);
+    CHECK(seq >= TABLE_SIZE && seq < MAX_SEQ);
+    CHECK(mmx_backapi_pending_add(&tbl, seq, 100000, timeout_cb, NULL) == MMXBA_OK);
+    retried[opSeqNum] = seq;
+}
+
+int main(void)
+{
+    int i, seq;
+
+    CHECK(mmx_backapi_pending_init(&tbl, TABLE_SIZE, TICK_MS) == MMXBA_OK);
+
+    /* The first request expires a tick earlier, so its callback is called
+       last and its entry is the first one offered to the retries */
+    for (i = 0; i < TABLE_SIZE; i++)
+    {
+        seq = mmx_backapi_pending_next_seq(&tbl);
+        CHECK(seq == i);
+        CHECK(mmx_backapi_pending_add(&tbl, seq, i ? 50 : 40, timeout_cb, NULL) == MMXBA_OK);
+    }
+
+    /* All requests expire by one call, each callback retries its request */
+    now_ms += 100;
+    CHECK(mmx_backapi_pending_expire(&tbl, now_ms) == TABLE_SIZE);
+    for (i = 0; i < TABLE_SIZE; i++)
+    {
+        CHECK(timeouts[i] == 1);
+        CHECK(timeouts[retried[i]] == 0);
+    }
+    CHECK(tbl.inflight == TABLE_SIZE);
+
+    /* The retries are not expired before their own timeout */
+    now_ms += 1000;
+    CHECK(mmx_backapi_pending_expire(&tbl, now_ms) == 0);
+    CHECK(mmx_backapi_pending_next_timeout(&tbl, now_ms) > 1000);
+
+    now_ms += 100000;
+    CHECK(mmx_backapi_pending_expire(&tbl, now_ms) == TABLE_SIZE);
+    for (i = 0; i < TABLE_SIZE; i++)
+    {
+        CHECK(timeouts[i] == 1);
+        CHECK(timeouts[retried[i]] == 1);
+    }
+    CHECK(tbl.inflight == 0);
+    CHECK(mmx_backapi_pending_next_timeout(&tbl, now_ms) == -1);
+
+    mmx_backapi_pending_destroy(&tbl);
+
+    printf("%s: %s\n", __FILE__, failures ? "FAILED" : "OK");
+
+    return failures ? 1 : 0;
+}
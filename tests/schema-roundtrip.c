@@ -0,0 +1,349 @@
+/* schema-roundtrip.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Round trip of the messages of every operation of the message schema
+ * (MMXBA_SCHEMA): the request (or the notification) and the response are
+ * built with all sections filled and with the optional sections absent,
+ * parsed by mmx_backapi_message_parse() and by the push parser and built
+ * again. The message built from the parsed structure must be the same,
+ * and the size returned by mmx_backapi_*_size() must be its length.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mmx-backapi.h"
+#include "mmx-backapi-internal.h"
+#include "mmx-backapi-stream.h"
+
+#define POOL_SIZE   4096
+
+static const struct {
+    int        op;
+    const char *name;
+} ops[] = {
+#define OP_ENTRY(op, reqSections, respSections) { MMXBA_OP_TYPE_##op, #op },
+    MMXBA_SCHEMA(OP_ENTRY)
+#undef OP_ENTRY
+};
+
+static mmxba_request_t msg, parsed;
+static char msg_pool[POOL_SIZE], parsed_pool[POOL_SIZE];
+
+static char text[MMXBA_MAX_MSG_SIZE], parsed_text[MMXBA_MAX_MSG_SIZE];
+static int failures;
+
+void ing_log(int level, const char *fmt, ...)
+{
+}
+
+char *strcpy_safe(char *dst, const char *src, size_t size)
+{
+    if (size)
+    {
+        strncpy(dst, src, size - 1);
+        dst[size - 1] = '\0';
+    }
+    return dst;
+}
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static void msg_reset(mmxba_request_t *req, char *pool)
+{
+    memset(req, 0, sizeof(*req));
+    mmx_backapi_msgstruct_init(req, pool, POOL_SIZE);
+}
+
+/* The notification is the request of NOTIFY */
+static int msg_build(mmxba_request_t *req, int isRequest, char *buf, size_t *len)
+{
+    mmxba_outbuf_t out = { NULL, 0, 0, NULL, NULL };
+    int status;
+
+    if (!isRequest)
+        status = mmx_backapi_response_build_buf(req, &out);
+    else if (req->op_type == MMXBA_OP_TYPE_NOTIFY)
+        status = mmx_backapi_notify_build_buf(req, &out);
+    else
+        status = mmx_backapi_request_build_buf(req, &out);
+
+    if (status == MMXBA_OK && out.len >= MMXBA_MAX_MSG_SIZE)
+        status = MMXBA_NOT_ENOUGH_MEMORY;
+    if (status == MMXBA_OK)
+    {
+        memcpy(buf, out.data, out.len + 1);
+        *len = out.len;
+    }
+
+    free(out.data);
+    return status;
+}
+
+static int msg_size(mmxba_request_t *req, int isRequest, size_t *size)
+{
+    if (!isRequest)
+        return mmx_backapi_response_size(req, size);
+    if (req->op_type == MMXBA_OP_TYPE_NOTIFY)
+        return mmx_backapi_notify_size(req, size);
+    return mmx_backapi_request_size(req, size);
+}
+
+static void add_values(nvpair_t *pairs, uint32_t *num)
+{
+    mmx_backapi_msgstruct_insert_nvpair(&msg, &pairs[0], "Alias", "lan <&> \"wan\"");
+    mmx_backapi_msgstruct_insert_nvpair(&msg, &pairs[1], "MTU", "-1500");
+    msg.valTypes[1] = MMXBA_VAL_TYPE_INT;
+    mmx_backapi_msgstruct_insert_nvpair(&msg, &pairs[2], "Enable", "false");
+    msg.valTypes[2] = MMXBA_VAL_TYPE_BOOL;
+    mmx_backapi_msgstruct_insert_nvpair(&msg, &pairs[3], "Descr", "");
+    *num = 4;
+}
+
+static void add_key_names(char (*names)[MMXBA_MAX_STR_LEN], uint32_t *num)
+{
+    strcpy(names[0], "Name");
+    strcpy(names[1], "Index");
+    *num = 2;
+}
+
+/*
+ * Fills msg with the sections of the operation message; optional - the
+ * optional sections (and the optional header elements) are filled too
+ */
+static void msg_fill(int op, int isRequest, int optional)
+{
+    uint32_t secs = mmxba_schema_sections(op, isRequest);
+    int getAll = (op == MMXBA_OP_TYPE_GETALL);
+
+    msg_reset(&msg, msg_pool);
+    msg.op_type = op;
+    msg.opSeqNum = 1000 + op;
+    strcpy(msg.beObjName, "Device.IP.Interface");
+
+    if (isRequest && optional)
+    {
+        msg.prio = MMXBA_PRIO_BULK;
+        msg.deadline = 1234567890123ULL;
+    }
+    if (!isRequest)
+    {
+        msg.opResCode = optional ? 2 : 0;
+        msg.opExtErrCode = optional ? -7 : 0;
+        strcpy(msg.errMsg, optional ? "error: 'a' < \"b\" & c" : "");
+        msg.postOpStatus = optional;
+    }
+
+    if (secs & MMXBA_SEC_MMXINSTANCE)
+        strcpy(msg.mmxInstances, "3,1");
+
+    if (secs & MMXBA_SEC_SUBSCRID)
+        msg.subscrId = 77;
+
+    if ((secs & MMXBA_SEC_BEKEYPARAMS) || ((secs & MMXBA_SEC_KEYFILTER) && optional))
+    {
+        mmx_backapi_msgstruct_insert_nvpair(&msg, &msg.beKeyParams[0], "Name", "eth0");
+        mmx_backapi_msgstruct_insert_nvpair(&msg, &msg.beKeyParams[1], "Index", "1");
+        msg.beKeyParamsNum = 2;
+    }
+
+    if ((secs & (MMXBA_SEC_PARAMNAMES | MMXBA_SEC_NAMEFILTER)) && optional)
+    {
+        strcpy(msg.paramNames.paramNames[0], "Enable");
+        strcpy(msg.paramNames.paramNames[1], "Status");
+        msg.paramNames.arraySize = 2;
+    }
+
+    if ((secs & MMXBA_SEC_CHANGES) || ((secs & MMXBA_SEC_PARAMVALUES) && optional))
+        add_values(msg.paramValues.paramValues, &msg.paramValues.arraySize);
+
+    if ((secs & MMXBA_SEC_NEWVALUES) && optional)
+        add_values(msg.addObj_req.paramValues, &msg.addObj_req.paramNum);
+
+    if (secs & MMXBA_SEC_BEKEYNAMES)
+    {
+        if (getAll)
+            add_key_names(msg.getAll.beKeyNames, &msg.getAll.beKeyNamesNum);
+        else if (isRequest)
+            add_key_names(msg.addObj_req.beKeyNames, &msg.addObj_req.beKeyNamesNum);
+        else
+            add_key_names(msg.addObj_resp.beKeyNames, &msg.addObj_resp.beKeyNamesNum);
+    }
+
+    if ((secs & MMXBA_SEC_QUERY) && optional)
+    {
+        msg.getAll.generation = 41;
+        msg.getAll.objEnc = MMXBA_OBJ_ENC_FRONT;
+    }
+
+    if ((secs & MMXBA_SEC_OBJECTS) && optional && getAll)
+    {
+        strcpy(msg.getAll.objects[0], "eth0,1");
+        strcpy(msg.getAll.objects[1], "eth0,2");
+        strcpy(msg.getAll.objects[2], "eth1,1");
+        msg.getAll.objNum = 3;
+        msg.getAll.objRemoved[1] = TRUE;
+        msg.getAll.isDelta = TRUE;
+        msg.getAll.objEnc = MMXBA_OBJ_ENC_FRONT;
+        msg.getAll.generation = 42;
+    }
+    else if ((secs & MMXBA_SEC_OBJECTS) && optional)
+    {
+        strcpy(msg.addObj_resp.objects[0], "eth2,5");
+        msg.addObj_resp.objNum = 1;
+    }
+}
+
+/* Parses the message by the push parser fed with the whole message */
+static int stream_parse(const char *buf, size_t len, mmxba_request_t *req)
+{
+    mmxba_stream_t s;
+    size_t used;
+    int status;
+
+    mmx_backapi_stream_init(&s, req, FALSE);
+    if ((status = mmx_backapi_stream_feed(&s, buf, len, &used)) != MMXBA_OK)
+        return status;
+
+    return (mmx_backapi_stream_complete(&s) && used == len) ? MMXBA_OK : MMXBA_INVALID_FORMAT;
+}
+
+static void test_roundtrip(int idx, int isRequest, int optional)
+{
+    size_t len, size, parsed_len;
+    int parser, status;
+
+    msg_fill(ops[idx].op, isRequest, optional);
+
+    if (msg_build(&msg, isRequest, text, &len) != MMXBA_OK)
+    {
+        fprintf(stderr, "%s %s: could not build the message\n", ops[idx].name,
+                isRequest ? "request" : "response");
+        failures++;
+        return;
+    }
+
+    CHECK(msg_size(&msg, isRequest, &size) == MMXBA_OK);
+    if (size != len)
+    {
+        fprintf(stderr, "%s %s: size %zu, built %zu bytes\n", ops[idx].name,
+                isRequest ? "request" : "response", size, len);
+        failures++;
+    }
+
+    for (parser = 0; parser < 2; parser++)
+    {
+        msg_reset(&parsed, parsed_pool);
+        if (parser == 0)
+            status = mmx_backapi_message_parse(text, &parsed);
+        else
+            status = stream_parse(text, len, &parsed);
+
+        if (status != MMXBA_OK ||
+            msg_build(&parsed, isRequest, parsed_text, &parsed_len) != MMXBA_OK ||
+            parsed_len != len || memcmp(parsed_text, text, len))
+        {
+            fprintf(stderr, "%s %s (%s sections, %s parser): status %d\n  sent:   %s\n"
+                    "  parsed: %s\n", ops[idx].name, isRequest ? "request" : "response",
+                    optional ? "all" : "required", parser ? "push" : "DOM", status,
+                    text, status == MMXBA_OK ? parsed_text : "");
+            failures++;
+        }
+    }
+}
+
+int main(void)
+{
+    unsigned int i;
+    int isRequest, optional;
+
+    for (i = 0; i < sizeof(ops) / sizeof(ops[0]); i++)
+    {
+        for (isRequest = 0; isRequest < 2; isRequest++)
+        {
+            /* Notifications are not responded */
+            if (ops[i].op == MMXBA_OP_TYPE_NOTIFY && !isRequest)
+                continue;
+
+            for (optional = 0; optional < 2; optional++)
+                test_roundtrip(i, isRequest, optional);
+        }
+    }
+
+    printf("%s: %s\n", __FILE__, failures ? "FAILED" : "OK");
+
+    return failures ? 1 : 0;
+}
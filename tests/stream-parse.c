@@ -0,0 +1,448 @@
+/* stream-parse.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ */
+
+
+/*
+ * Test of the push parser against mmx_backapi_message_parse(): requests
+ * and responses built by the library are fed to the push parser split at
+ * every byte boundary and byte by byte, framed and unframed, and the
+ * parsed structures must be the same as the ones of the DOM parser. The
+ * structures are compared by the messages built from them again.
+ *
+ * Failures are checked as well: the full memory pool (the status of both
+ * parsers must be the same), the oversized frame and the frame shorter
+ * than its message.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mmx-backapi.h"
+#include "mmx-backapi-stream.h"
+
+#define POOL_SIZE   4096
+
+enum { KIND_REQUEST, KIND_RESPONSE, KIND_NOTIFY };
+
+typedef struct test_msg_s {
+    const char *title;
+    int        kind;
+    char       text[MMXBA_MAX_MSG_SIZE];
+    size_t     len;
+} test_msg_t;
+
+static mmxba_request_t msg;
+static char msg_pool[POOL_SIZE];
+
+static mmxba_request_t expected, parsed;
+static char expected_pool[POOL_SIZE], parsed_pool[POOL_SIZE];
+
+static char data[2 * (MMXBA_STREAM_FRAME_HDR_SIZE + MMXBA_MAX_MSG_SIZE)];
+static int failures;
+
+/* Failures of the parsers are expected by the test */
+void ing_log(int level, const char *fmt, ...)
+{
+}
+
+char *strcpy_safe(char *dst, const char *src, size_t size)
+{
+    if (size)
+    {
+        strncpy(dst, src, size - 1);
+        dst[size - 1] = '\0';
+    }
+    return dst;
+}
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static void msg_reset(mmxba_request_t *req, char *pool, unsigned short pool_size)
+{
+    memset(req, 0, sizeof(*req));
+    mmx_backapi_msgstruct_init(req, pool, pool_size);
+}
+
+static int msg_build(mmxba_request_t *req, int kind, char *buf, size_t size, size_t *len)
+{
+    mmxba_outbuf_t out = { NULL, 0, 0, NULL, NULL };
+    int status;
+
+    if (kind == KIND_REQUEST)
+        status = mmx_backapi_request_build_buf(req, &out);
+    else if (kind == KIND_RESPONSE)
+        status = mmx_backapi_response_build_buf(req, &out);
+    else
+        status = mmx_backapi_notify_build_buf(req, &out);
+
+    if (status == MMXBA_OK && out.len >= size)
+        status = MMXBA_NOT_ENOUGH_MEMORY;
+    if (status == MMXBA_OK)
+    {
+        memcpy(buf, out.data, out.len + 1);
+        *len = out.len;
+    }
+
+    free(out.data);
+    return status;
+}
+
+/* Keeps the message built from msg */
+static void msg_save(test_msg_t *m, const char *title, int kind)
+{
+    m->title = title;
+    m->kind = kind;
+    CHECK(msg_build(&msg, kind, m->text, sizeof(m->text), &m->len) == MMXBA_OK);
+}
+
+/* Returns TRUE if both structures are built to the same message */
+static int msg_same(mmxba_request_t *a, mmxba_request_t *b, int kind)
+{
+    static char text_a[MMXBA_MAX_MSG_SIZE], text_b[MMXBA_MAX_MSG_SIZE];
+    size_t len_a, len_b;
+
+    return msg_build(a, kind, text_a, sizeof(text_a), &len_a) == MMXBA_OK &&
+           msg_build(b, kind, text_b, sizeof(text_b), &len_b) == MMXBA_OK &&
+           len_a == len_b && !memcmp(text_a, text_b, len_a);
+}
+
+/* Puts the message to data (after the frame header); returns its length */
+static size_t data_put(const test_msg_t *m, int framed, size_t off)
+{
+    if (!framed)
+    {
+        memcpy(data + off, m->text, m->len);
+        return m->len;
+    }
+
+    mmx_backapi_stream_frame_hdr(m->len, data + off);
+    memcpy(data + off + MMXBA_STREAM_FRAME_HDR_SIZE, m->text, m->len);
+    return MMXBA_STREAM_FRAME_HDR_SIZE + m->len;
+}
+
+/*
+ * Feeds len bytes of data by chunks ending at split and then every step
+ * bytes (0 - the rest at once). Returns the status of the parser; *used
+ * is the number of bytes parsed till the end of the message.
+ */
+static int stream_parse(mmxba_stream_t *s, size_t len, size_t split, size_t step,
+                        size_t *used)
+{
+    size_t off = 0, n, chunk_used;
+    int status = MMXBA_OK;
+
+    while (off < len && status == MMXBA_OK && !mmx_backapi_stream_complete(s))
+    {
+        if (off < split)
+            n = split - off;
+        else
+            n = (step && step < len - off) ? step : len - off;
+
+        status = mmx_backapi_stream_feed(s, data + off, n, &chunk_used);
+        CHECK(chunk_used <= n);
+        off += chunk_used;
+    }
+
+    *used = off;
+    return status;
+}
+
+/* The message split at every byte boundary and fed byte by byte */
+static void test_splits(const test_msg_t *m, int framed, unsigned short pool_size)
+{
+    mmxba_stream_t s;
+    size_t len, split, used;
+    int status, expected_status, bad = 0;
+
+    msg_reset(&expected, expected_pool, pool_size);
+    expected_status = mmx_backapi_message_parse(m->text, &expected);
+
+    len = data_put(m, framed, 0);
+    for (split = 0; split <= len + 1 && bad < 3; split++)
+    {
+        msg_reset(&parsed, parsed_pool, pool_size);
+        mmx_backapi_stream_init(&s, &parsed, framed);
+
+        /* The last pass feeds the message byte by byte */
+        if (split <= len)
+            status = stream_parse(&s, len, split, 0, &used);
+        else
+            status = stream_parse(&s, len, 0, 1, &used);
+
+        if (status != expected_status ||
+            (status == MMXBA_OK && (!mmx_backapi_stream_complete(&s) || used != len ||
+                                    !msg_same(&parsed, &expected, m->kind))))
+        {
+            fprintf(stderr, "%s (%s): split at %zu: status %d, expected %d\n", m->title,
+                    framed ? "framed" : "unframed", split, status, expected_status);
+            bad++;
+        }
+    }
+    failures += bad;
+}
+
+/* Several framed messages in one chunk are parsed one by one */
+static void test_batch(const test_msg_t *m1, const test_msg_t *m2)
+{
+    mmxba_stream_t s;
+    size_t len1, len2, used;
+
+    len1 = data_put(m1, TRUE, 0);
+    len2 = data_put(m2, TRUE, len1);
+
+    msg_reset(&parsed, parsed_pool, POOL_SIZE);
+    mmx_backapi_stream_init(&s, &parsed, TRUE);
+    CHECK(mmx_backapi_stream_feed(&s, data, len1 + len2, &used) == MMXBA_OK);
+    CHECK(used == len1 && mmx_backapi_stream_complete(&s));
+
+    msg_reset(&expected, expected_pool, POOL_SIZE);
+    CHECK(mmx_backapi_message_parse(m1->text, &expected) == MMXBA_OK);
+    CHECK(msg_same(&parsed, &expected, m1->kind));
+
+    CHECK(mmx_backapi_stream_next(&s) == MMXBA_OK);
+    msg_reset(&parsed, parsed_pool, POOL_SIZE);
+    CHECK(mmx_backapi_stream_feed(&s, data + len1, len2, &used) == MMXBA_OK);
+    CHECK(used == len2 && mmx_backapi_stream_complete(&s));
+
+    msg_reset(&expected, expected_pool, POOL_SIZE);
+    CHECK(mmx_backapi_message_parse(m2->text, &expected) == MMXBA_OK);
+    CHECK(msg_same(&parsed, &expected, m2->kind));
+}
+
+/* The broken frames: the stream is resynchronized after the short frame
+   and cannot be after the frame of bad length */
+static void test_bad_frames(const test_msg_t *m)
+{
+    mmxba_stream_t s;
+    size_t len, short_len = m->len / 2, used;
+
+    /* The frame ends in the middle of its message */
+    mmx_backapi_stream_frame_hdr(short_len, data);
+    memcpy(data + MMXBA_STREAM_FRAME_HDR_SIZE, m->text, short_len);
+    len = MMXBA_STREAM_FRAME_HDR_SIZE + short_len;
+    len += data_put(m, TRUE, len);
+
+    msg_reset(&parsed, parsed_pool, POOL_SIZE);
+    mmx_backapi_stream_init(&s, &parsed, TRUE);
+    CHECK(mmx_backapi_stream_feed(&s, data, len, &used) == MMXBA_INVALID_FORMAT);
+    CHECK(used == MMXBA_STREAM_FRAME_HDR_SIZE + short_len);
+    CHECK(mmx_backapi_stream_next(&s) == MMXBA_OK);
+
+    msg_reset(&parsed, parsed_pool, POOL_SIZE);
+    CHECK(mmx_backapi_stream_feed(&s, data + used, len - used, &used) == MMXBA_OK);
+    CHECK(mmx_backapi_stream_complete(&s));
+
+    msg_reset(&expected, expected_pool, POOL_SIZE);
+    CHECK(mmx_backapi_message_parse(m->text, &expected) == MMXBA_OK);
+    CHECK(msg_same(&parsed, &expected, m->kind));
+
+    /* The frame is longer than any message */
+    len = data_put(m, TRUE, 0);
+    mmx_backapi_stream_frame_hdr(MMXBA_MAX_MSG_SIZE + 1, data);
+
+    msg_reset(&parsed, parsed_pool, POOL_SIZE);
+    mmx_backapi_stream_init(&s, &parsed, TRUE);
+    CHECK(mmx_backapi_stream_feed(&s, data, len, &used) == MMXBA_INVALID_FORMAT);
+    CHECK(used == MMXBA_STREAM_FRAME_HDR_SIZE);
+    CHECK(mmx_backapi_stream_next(&s) != MMXBA_OK);
+}
+
+int main(void)
+{
+    static test_msg_t get_req, get_resp, set_req, getall_resp, addobj_req, notify;
+    static char value[200];
+    unsigned short pool_size;
+
+    /* GET request of the interactive priority with the deadline */
+    msg_reset(&msg, msg_pool, POOL_SIZE);
+    msg.op_type = MMXBA_OP_TYPE_GET;
+    msg.opSeqNum = 17;
+    msg.prio = MMXBA_PRIO_INTERACTIVE;
+    msg.deadline = 1234567890123ULL;
+    strcpy(msg.beObjName, "Device.IP.Interface");
+    strcpy(msg.mmxInstances, "2");
+    mmx_backapi_msgstruct_insert_nvpair(&msg, &msg.beKeyParams[0], "Name", "eth0");
+    msg.beKeyParamsNum = 1;
+    strcpy(msg.paramNames.paramNames[0], "Enable");
+    strcpy(msg.paramNames.paramNames[1], "Status");
+    msg.paramNames.arraySize = 2;
+    msg_save(&get_req, "GET request", KIND_REQUEST);
+
+    /* GET response with the entities and typed values */
+    msg_reset(&msg, msg_pool, POOL_SIZE);
+    msg.op_type = MMXBA_OP_TYPE_GET;
+    msg.opSeqNum = 17;
+    msg.opResCode = 1;
+    msg.opExtErrCode = -5;
+    strcpy(msg.errMsg, "a < b && \"c\" > 'd'");
+    strcpy(msg.beObjName, "Device.IP.Interface");
+    strcpy(msg.mmxInstances, "2");
+    mmx_backapi_msgstruct_insert_nvpair(&msg, &msg.beKeyParams[0], "Name", "eth0");
+    msg.beKeyParamsNum = 1;
+    memset(value, 'v', sizeof(value) - 1);
+    memcpy(value + 50, "<&>", 3);
+    mmx_backapi_msgstruct_insert_nvpair(&msg, &msg.paramValues.paramValues[0], "Alias", value);
+    mmx_backapi_msgstruct_insert_nvpair(&msg, &msg.paramValues.paramValues[1], "MTU", "-1500");
+    msg.valTypes[1] = MMXBA_VAL_TYPE_INT;
+    mmx_backapi_msgstruct_insert_nvpair(&msg, &msg.paramValues.paramValues[2], "Enable", "true");
+    msg.valTypes[2] = MMXBA_VAL_TYPE_BOOL;
+    mmx_backapi_msgstruct_insert_nvpair(&msg, &msg.paramValues.paramValues[3], "Descr", "");
+    msg.paramValues.arraySize = 4;
+    msg_save(&get_resp, "GET response", KIND_RESPONSE);
+
+    /* SET request of the bulk priority */
+    msg_reset(&msg, msg_pool, POOL_SIZE);
+    msg.op_type = MMXBA_OP_TYPE_SET;
+    msg.opSeqNum = 18;
+    msg.prio = MMXBA_PRIO_BULK;
+    strcpy(msg.beObjName, "Device.IP.Interface");
+    strcpy(msg.mmxInstances, "2");
+    mmx_backapi_msgstruct_insert_nvpair(&msg, &msg.beKeyParams[0], "Name", "eth0");
+    msg.beKeyParamsNum = 1;
+    mmx_backapi_msgstruct_insert_nvpair(&msg, &msg.paramValues.paramValues[0], "Alias", "lan&wan");
+    msg.paramValues.arraySize = 1;
+    msg_save(&set_req, "SET request", KIND_REQUEST);
+
+    /* GETALL delta response, front coded */
+    msg_reset(&msg, msg_pool, POOL_SIZE);
+    msg.op_type = MMXBA_OP_TYPE_GETALL;
+    msg.opSeqNum = 19;
+    strcpy(msg.beObjName, "Device.Ethernet.Link");
+    msg.getAll.beKeyNamesNum = 2;
+    strcpy(msg.getAll.beKeyNames[0], "Name");
+    strcpy(msg.getAll.beKeyNames[1], "Index");
+    msg.getAll.objNum = 3;
+    strcpy(msg.getAll.objects[0], "eth0,1");
+    strcpy(msg.getAll.objects[1], "eth0,2");
+    strcpy(msg.getAll.objects[2], "eth1,1");
+    msg.getAll.objRemoved[1] = TRUE;
+    msg.getAll.isDelta = TRUE;
+    msg.getAll.objEnc = MMXBA_OBJ_ENC_FRONT;
+    msg.getAll.generation = 7;
+    msg_save(&getall_resp, "GETALL response", KIND_RESPONSE);
+
+    /* ADDOBJ request */
+    msg_reset(&msg, msg_pool, POOL_SIZE);
+    msg.op_type = MMXBA_OP_TYPE_ADDOBJ;
+    msg.opSeqNum = 20;
+    strcpy(msg.beObjName, "Device.NAT.PortMapping");
+    strcpy(msg.mmxInstances, "1");
+    msg.addObj_req.beKeyNamesNum = 1;
+    strcpy(msg.addObj_req.beKeyNames[0], "Id");
+    mmx_backapi_msgstruct_insert_nvpair(&msg, &msg.addObj_req.paramValues[0], "Port", "8080");
+    msg.valTypes[0] = MMXBA_VAL_TYPE_UINT64;
+    msg.addObj_req.paramNum = 1;
+    msg_save(&addobj_req, "ADDOBJ request", KIND_REQUEST);
+
+    /* Notification */
+    msg_reset(&msg, msg_pool, POOL_SIZE);
+    msg.op_type = MMXBA_OP_TYPE_NOTIFY;
+    msg.opSeqNum = 3;
+    msg.subscrId = 11;
+    strcpy(msg.beObjName, "Device.IP.Interface");
+    mmx_backapi_msgstruct_insert_nvpair(&msg, &msg.beKeyParams[0], "Name", "eth0");
+    msg.beKeyParamsNum = 1;
+    mmx_backapi_msgstruct_insert_nvpair(&msg, &msg.paramValues.paramValues[0], "Status", "Up");
+    msg.paramValues.arraySize = 1;
+    msg_save(&notify, "NOTIFY", KIND_NOTIFY);
+
+    test_splits(&get_req, FALSE, POOL_SIZE);
+    test_splits(&get_req, TRUE, POOL_SIZE);
+    test_splits(&get_resp, FALSE, POOL_SIZE);
+    test_splits(&get_resp, TRUE, POOL_SIZE);
+    test_splits(&set_req, FALSE, POOL_SIZE);
+    test_splits(&set_req, TRUE, POOL_SIZE);
+    test_splits(&getall_resp, FALSE, POOL_SIZE);
+    test_splits(&getall_resp, TRUE, POOL_SIZE);
+    test_splits(&addobj_req, FALSE, POOL_SIZE);
+    test_splits(&addobj_req, TRUE, POOL_SIZE);
+    test_splits(&notify, FALSE, POOL_SIZE);
+    test_splits(&notify, TRUE, POOL_SIZE);
+
+    /* The pools around the size of the values: the long value, the next
+       ones and the last empty value do not fit one by one */
+    for (pool_size = sizeof(value); pool_size <= sizeof(value) + 24; pool_size++)
+    {
+        test_splits(&get_resp, FALSE, pool_size);
+        test_splits(&get_resp, TRUE, pool_size);
+    }
+
+    test_batch(&get_req, &get_resp);
+    test_batch(&notify, &getall_resp);
+    test_bad_frames(&set_req);
+
+    printf("%s: %s\n", __FILE__, failures ? "FAILED" : "OK");
+
+    return failures ? 1 : 0;
+}